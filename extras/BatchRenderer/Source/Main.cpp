@@ -0,0 +1,132 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+/*  Headless console app that renders waveform and spectrogram PNGs for a batch
+    of audio files using drow::BatchImageRenderer.
+
+    Create a console application in the Projucer, add the dRowAudio module and
+    set DROWAUDIO_USE_FFTREAL=1 in the module's config for spectrograms.
+
+    Usage: BatchRenderer --output <dir> [--waveform <width>x<height>]... [--spectrogram <width>x<height>]...
+                         [--threads <n>] [--memory-mb <n>] [--linear] <files or directories>...
+*/
+
+#include <JuceHeader.h>
+
+//==============================================================================
+static bool parseSize (const String& text, int& width, int& height)
+{
+    width = text.upToFirstOccurrenceOf ("x", false, true).getIntValue();
+    height = text.fromFirstOccurrenceOf ("x", false, true).getIntValue();
+
+    return width > 0 && height > 0;
+}
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    AudioFormatManager formatManager;
+    formatManager.registerBasicFormats();
+
+    drow::BatchImageRenderer renderer (formatManager);
+    const String wildcard (formatManager.getWildcardForAllFormats());
+    Array<File> files;
+    File outputDirectory;
+    bool hasImages = false;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const String arg (argv[i]);
+        const String value (i + 1 < argc ? String (argv[i + 1]) : String());
+        int width, height;
+
+        if (arg == "--output")
+        {
+            outputDirectory = File::getCurrentWorkingDirectory().getChildFile (value);
+            ++i;
+        }
+        else if ((arg == "--waveform" || arg == "--spectrogram") && parseSize (value, width, height))
+        {
+            renderer.addImage (arg == "--waveform" ? drow::BatchImageRenderer::waveform
+                                                   : drow::BatchImageRenderer::spectrogram, width, height);
+            hasImages = true;
+            ++i;
+        }
+        else if (arg == "--threads")
+        {
+            renderer.setNumThreads (value.getIntValue());
+            ++i;
+        }
+        else if (arg == "--memory-mb")
+        {
+            renderer.setMemoryBudget ((size_t) jmax (1, value.getIntValue()) * 1024 * 1024);
+            ++i;
+        }
+        else if (arg == "--linear")
+        {
+            renderer.setLogFrequency (false);
+        }
+        else
+        {
+            const File file (File::getCurrentWorkingDirectory().getChildFile (arg));
+
+            if (file.isDirectory())
+                files.addArray (file.findChildFiles (File::findFiles, true, wildcard));
+            else if (file.existsAsFile())
+                files.add (file);
+            else
+                std::cerr << "Skipping " << arg << std::endl;
+        }
+    }
+
+    if (outputDirectory == File() || files.isEmpty())
+    {
+        std::cerr << "Usage: BatchRenderer --output <dir> [--waveform <width>x<height>]... [--spectrogram <width>x<height>]..." << std::endl
+                  << "                     [--threads <n>] [--memory-mb <n>] [--linear] <files or directories>..." << std::endl;
+        return 1;
+    }
+
+    if (! hasImages)
+        renderer.addImage (drow::BatchImageRenderer::waveform, 1800, 140);
+
+    const drow::BatchImageRenderer::Statistics stats (renderer.renderFiles (files, outputDirectory));
+
+    for (auto& error : stats.errors)
+        std::cerr << error << std::endl;
+
+    std::cout << stats.numFilesRendered << " files, " << stats.numImagesWritten << " images in "
+              << String (stats.secondsElapsed, 2) << "s ("
+              << String (stats.getFilesPerSecond(), 2) << " files/sec)" << std::endl;
+
+    return stats.numFilesFailed > 0 ? 1 : 0;
+}
@@ -0,0 +1,76 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+/*  Headless console app that runs the dRowAudio PerformanceBenchmark suite.
+
+    Create a console application in the Projucer, add the dRowAudio module and
+    set DROWAUDIO_BENCHMARKS=1 in the module's config. Build in release mode.
+
+    Usage: Benchmarks [--category <audio|gui|utility>] [--min-time <seconds>] [--output <file.json>]
+*/
+
+#include <JuceHeader.h>
+
+//==============================================================================
+int main (int argc, char* argv[])
+{
+    // the thumbnail benchmarks need a message thread
+    ScopedJuceInitialiser_GUI juceInitialiser;
+
+    StringArray args;
+
+    for (int i = 1; i < argc; ++i)
+        args.add (argv[i]);
+
+    String category;
+    File outputFile;
+    double minTimePerCase = 0.25;
+
+    for (int i = 0; i < args.size() - 1; ++i)
+    {
+        if (args[i] == "--category")        category = args[i + 1];
+        else if (args[i] == "--min-time")   minTimePerCase = args[i + 1].getDoubleValue();
+        else if (args[i] == "--output")     outputFile = File::getCurrentWorkingDirectory().getChildFile (args[i + 1]);
+    }
+
+    drow::PerformanceBenchmarkRunner runner;
+    runner.setMinimumTimePerCase (minTimePerCase);
+    runner.runAllBenchmarks (category);
+
+    const String json (runner.toJSON());
+
+    if (outputFile == File())
+        std::cout << json << std::endl;
+    else if (! outputFile.replaceWithText (json))
+        return 1;
+
+    return 0;
+}
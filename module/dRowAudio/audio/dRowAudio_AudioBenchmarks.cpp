@@ -0,0 +1,737 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#if DROWAUDIO_BENCHMARKS
+
+namespace BenchmarkHelpers
+{
+    /** Fills a buffer with a repeatable mix of tones and noise. */
+    static void fillWithTestSignal (AudioSampleBuffer& buffer, double sampleRate)
+    {
+        Random random (0x1234);
+        const double toneDelta1 = (2.0 * MathConstants<double>::pi * 110.0) / sampleRate;
+        const double toneDelta2 = (2.0 * MathConstants<double>::pi * 1760.0) / sampleRate;
+
+        for (int c = 0; c < buffer.getNumChannels(); ++c)
+        {
+            float* data = buffer.getWritePointer (c);
+
+            for (int i = 0; i < buffer.getNumSamples(); ++i)
+                data[i] = 0.5f * (float) std::sin (i * toneDelta1)
+                            + 0.25f * (float) std::sin (i * toneDelta2)
+                            + 0.1f * (random.nextFloat() * 2.0f - 1.0f);
+        }
+    }
+
+    /** An AudioSource that just loops a pre-rendered buffer so that reading the
+        input adds as little as possible to the measurement.
+    */
+    class LoopingBufferSource : public PositionableAudioSource
+    {
+    public:
+        LoopingBufferSource (int numChannels, int numSamples, double sampleRate)
+            : buffer (numChannels, numSamples), position (0)
+        {
+            fillWithTestSignal (buffer, sampleRate);
+        }
+
+        void prepareToPlay (int, double) override {}
+        void releaseResources() override {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            int numDone = 0;
+
+            while (numDone < info.numSamples)
+            {
+                const int bufferPos = (int) (position % buffer.getNumSamples());
+                const int numThisTime = jmin (info.numSamples - numDone, buffer.getNumSamples() - bufferPos);
+
+                for (int c = info.buffer->getNumChannels(); --c >= 0;)
+                    info.buffer->copyFrom (c, info.startSample + numDone,
+                                           buffer, c % buffer.getNumChannels(), bufferPos, numThisTime);
+
+                numDone += numThisTime;
+                position += numThisTime;
+            }
+        }
+
+        void setNextReadPosition (int64 newPosition) override   { position = newPosition; }
+        int64 getNextReadPosition() const override              { return position; }
+        int64 getTotalLength() const override                   { return std::numeric_limits<int64>::max(); }
+        bool isLooping() const override                         { return true; }
+
+    private:
+        AudioSampleBuffer buffer;
+        int64 position;
+    };
+
+    static const double sampleRate = 44100.0;
+    static const int blockSize = 512;
+}
+
+#if DROWAUDIO_USE_FFTREAL
+//==============================================================================
+class FFTBenchmark  : public PerformanceBenchmark
+{
+public:
+    FFTBenchmark() : PerformanceBenchmark ("FFT", "audio") {}
+
+    void runBenchmark() override
+    {
+        for (int sizeLog2 = 6; sizeLog2 <= 15; ++sizeLog2)
+        {
+            const int size = 1 << sizeLog2;
+            AudioSampleBuffer input (1, size), work (1, size);
+            BenchmarkHelpers::fillWithTestSignal (input, BenchmarkHelpers::sampleRate);
+
+            {
+                FFT fft (sizeLog2);
+
+                measure ("FFT " + String (size), size, BenchmarkHelpers::sampleRate, [&]
+                {
+                    work.copyFrom (0, 0, input, 0, 0, size);
+                    fft.performFFT (work.getWritePointer (0));
+                });
+            }
+
+            {
+                FFTEngine engine (sizeLog2);
+
+                measure ("FFTEngine magnitudes " + String (size), size, BenchmarkHelpers::sampleRate, [&]
+                {
+                    work.copyFrom (0, 0, input, 0, 0, size);
+                    engine.performFFT (work.getWritePointer (0));
+                    engine.findMagnitudes();
+                });
+            }
+        }
+    }
+};
+
+static FFTBenchmark fftBenchmark;
+
+//==============================================================================
+class LTASBenchmark  : public PerformanceBenchmark
+{
+public:
+    LTASBenchmark() : PerformanceBenchmark ("LTAS", "audio") {}
+
+    void runBenchmark() override
+    {
+        const int numSamples = 1 << 16;
+        AudioSampleBuffer input (1, numSamples), work (1, numSamples);
+        BenchmarkHelpers::fillWithTestSignal (input, BenchmarkHelpers::sampleRate);
+
+        for (int sizeLog2 = 9; sizeLog2 <= 13; sizeLog2 += 2)
+        {
+            LTAS ltas (sizeLog2);
+
+            measure ("LTAS " + String (1 << sizeLog2), numSamples, BenchmarkHelpers::sampleRate, [&]
+            {
+                work.copyFrom (0, 0, input, 0, 0, numSamples);
+                ltas.updateLTAS (work.getWritePointer (0), numSamples);
+            });
+        }
+    }
+};
+
+static LTASBenchmark ltasBenchmark;
+
+//==============================================================================
+class TempogramBenchmark  : public PerformanceBenchmark
+{
+public:
+    TempogramBenchmark() : PerformanceBenchmark ("Tempogram", "audio") {}
+
+    void runBenchmark() override
+    {
+        using namespace BenchmarkHelpers;
+
+        // five minutes of a kick and hi-hat pattern drifting from 118 to 126 BPM
+        const int numSamples = (int) sampleRate * 300;
+        const double startBpm = 118.0, endBpm = 126.0;
+        AudioSampleBuffer track (1, numSamples);
+        float* data = track.getWritePointer (0);
+        Random random (0x1234);
+        double beatPhase = 0.0;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const double bpm = startBpm + (endBpm - startBpm) * i / numSamples;
+            beatPhase += bpm / (60.0 * sampleRate);
+
+            const double secondsPerBeat = 60.0 / bpm;
+            const double sinceBeat = (beatPhase - std::floor (beatPhase)) * secondsPerBeat;
+            const double sinceOffBeat = (2.0 * beatPhase - std::floor (2.0 * beatPhase)) * 0.5 * secondsPerBeat;
+            const double kick = std::exp (-30.0 * sinceBeat) * std::sin (2.0 * MathConstants<double>::pi * 60.0 * sinceBeat);
+            const double hat = 0.2 * std::exp (-80.0 * sinceOffBeat) * (random.nextFloat() * 2.0f - 1.0f);
+
+            data[i] = (float) (0.6 * kick + hat + 0.02 * (random.nextFloat() * 2.0f - 1.0f));
+        }
+
+        double tempogramBpm = 0.0;
+
+        measure ("Tempogram 5 min", numSamples, sampleRate, [&]
+        {
+            Tempogram tempogram (sampleRate);
+            tempogram.processSamples (track.getReadPointer (0), numSamples);
+            tempogram.finish();
+            tempogramBpm = tempogram.getGlobalBpm();
+        });
+
+        logValue ("Tempogram 5 min", "bpm", tempogramBpm);
+        logValue ("Tempogram 5 min", "medianTrueBpm", 0.5 * (startBpm + endBpm));
+
+       #if DROWAUDIO_USE_SOUNDTOUCH
+        double bpmDetectBpm = 0.0;
+
+        measure ("BPMDetect 5 min", numSamples, sampleRate, [&]
+        {
+            soundtouch::BPMDetect detector (1, (int) sampleRate);
+
+            for (int pos = 0; pos < numSamples; pos += blockSize)
+            {
+                detector.inputSamples (track.getReadPointer (0, pos), jmin (blockSize, numSamples - pos));
+            }
+
+            bpmDetectBpm = detector.getBpm();
+        });
+
+        logValue ("BPMDetect 5 min", "bpm", bpmDetectBpm);
+       #endif
+    }
+};
+
+static TempogramBenchmark tempogramBenchmark;
+
+//==============================================================================
+class MFCCBenchmark  : public PerformanceBenchmark
+{
+public:
+    MFCCBenchmark() : PerformanceBenchmark ("MFCCExtractor", "audio") {}
+
+    void runBenchmark() override
+    {
+        using namespace BenchmarkHelpers;
+
+        const MFCCExtractor::Settings settings;
+        const int fftSize = 1 << settings.fftSizeLog2;
+        const int numSamples = (int) sampleRate * 30;
+
+        AudioSampleBuffer track (1, numSamples);
+        fillWithTestSignal (track, sampleRate);
+
+        // per hop, the extractor against just the windowed FFT it is built on
+        {
+            MFCCExtractor extractor (sampleRate, settings);
+
+            measure ("MFCCExtractor per hop", settings.hopSize, sampleRate, [&]
+            {
+                extractor.processSamples (track.getReadPointer (0), settings.hopSize);
+            });
+        }
+
+        {
+            FFT fft (settings.fftSizeLog2);
+            Window window (fftSize, Window::Hann);
+            HeapBlock<float> frame ((size_t) fftSize);
+
+            measure ("Windowed FFT per hop", settings.hopSize, sampleRate, [&]
+            {
+                FloatVectorOperations::copy (frame, track.getReadPointer (0), fftSize);
+                window.applyWindow (frame, fftSize);
+                fft.performFFT (frame);
+            });
+        }
+
+        int numFrames = 0;
+        MemoryOutputStream quantised, unquantised;
+
+        measure ("MFCCExtractor 30 sec", numSamples, sampleRate, [&]
+        {
+            MFCCExtractor extractor (sampleRate, settings);
+            extractor.processSamples (track.getReadPointer (0), numSamples);
+
+            const MFCCFeatures features (extractor.getFeatures());
+            numFrames = features.numFrames;
+
+            quantised.reset();
+            unquantised.reset();
+            features.writeTo (quantised, true, true);
+            features.writeTo (unquantised, true, false);
+        });
+
+        logValue ("MFCCExtractor 30 sec", "numFrames", numFrames);
+        logValue ("MFCCExtractor 30 sec", "quantisedBytes", (double) quantised.getDataSize());
+        logValue ("MFCCExtractor 30 sec", "floatBytes", (double) unquantised.getDataSize());
+    }
+};
+
+static MFCCBenchmark mfccBenchmark;
+#endif // DROWAUDIO_USE_FFTREAL
+
+//==============================================================================
+class FilterBenchmark  : public PerformanceBenchmark
+{
+public:
+    FilterBenchmark() : PerformanceBenchmark ("Filters", "audio") {}
+
+    void runBenchmark() override
+    {
+        using namespace BenchmarkHelpers;
+
+        {
+            AudioSampleBuffer buffer (1, blockSize);
+            fillWithTestSignal (buffer, sampleRate);
+
+            BiquadFilter filter;
+            filter.setCoefficients (BiquadFilter::makeBandPass (sampleRate, 1000.0, 2.0));
+
+            measure ("BiquadFilter float", blockSize, sampleRate, [&]
+            {
+                filter.processSamples (buffer.getWritePointer (0), blockSize);
+            });
+        }
+
+        {
+            HeapBlock<int> samples ((size_t) blockSize);
+            Random random (0x1234);
+
+            for (int i = 0; i < blockSize; ++i)
+                samples[i] = random.nextInt();
+
+            BiquadFilter filter;
+            filter.setCoefficients (BiquadFilter::makeBandPass (sampleRate, 1000.0, 2.0));
+
+            measure ("BiquadFilter int", blockSize, sampleRate, [&]
+            {
+                filter.processSamples (samples.getData(), blockSize);
+            });
+        }
+
+        {
+            FilteringAudioSource source (new LoopingBufferSource (2, 1 << 16, sampleRate), true);
+            source.prepareToPlay (blockSize, sampleRate);
+            source.setGain (FilteringAudioSource::Low, 0.5f);
+            source.setGain (FilteringAudioSource::High, 1.5f);
+
+            AudioSampleBuffer buffer (2, blockSize);
+            const AudioSourceChannelInfo info (&buffer, 0, blockSize);
+
+            measure ("FilteringAudioSource stereo", blockSize, sampleRate, [&]
+            {
+                source.getNextAudioBlock (info);
+            });
+        }
+    }
+};
+
+static FilterBenchmark filterBenchmark;
+
+//==============================================================================
+class OctaveFilterBankBenchmark  : public PerformanceBenchmark
+{
+public:
+    OctaveFilterBankBenchmark() : PerformanceBenchmark ("OctaveFilterBank", "audio") {}
+
+    void runBenchmark() override
+    {
+        using namespace BenchmarkHelpers;
+
+        AudioSampleBuffer buffer (1, blockSize);
+        fillWithTestSignal (buffer, sampleRate);
+
+        // with the decimation the cost should level off as octaves are added
+        for (int numOctaves : { 1, 3, 5, 10 })
+        {
+            OctaveFilterBank filterBank (sampleRate, 3, numOctaves);
+            filterBank.prepare (blockSize);
+
+            measure ("Third-octave x " + String (numOctaves), blockSize, sampleRate, [&]
+            {
+                filterBank.processSamples (buffer.getReadPointer (0), blockSize);
+            });
+        }
+
+        // how well a 1KHz tone is kept to its own band
+        {
+            OctaveFilterBank filterBank (sampleRate, 3, 10);
+            filterBank.prepare (blockSize);
+
+            const int numSamples = (int) sampleRate * 2;
+            AudioSampleBuffer tone (1, numSamples);
+
+            for (int i = 0; i < numSamples; ++i)
+                tone.setSample (0, i, (float) std::sin (2.0 * MathConstants<double>::pi * 1000.0 * i / sampleRate));
+
+            for (int pos = 0; pos < numSamples; pos += blockSize)
+                filterBank.processSamples (tone.getReadPointer (0, pos), jmin (blockSize, numSamples - pos));
+
+            int peakBand = 0;
+
+            for (int b = 1; b < filterBank.getNumBands(); ++b)
+                if (filterBank.getBandLevel (b) > filterBank.getBandLevel (peakBand))
+                    peakBand = b;
+
+            const double reference = filterBank.getBandLevel (peakBand);
+
+            logValue ("1KHz tone", "peakBandHz", filterBank.getBandCentreFrequency (peakBand));
+            logValue ("1KHz tone", "peakBandDb", toDecibels (reference / std::sqrt (0.5)));
+
+            if (peakBand >= 3 && peakBand + 3 < filterBank.getNumBands())
+            {
+                const float adjacent = jmax (filterBank.getBandLevel (peakBand - 1), filterBank.getBandLevel (peakBand + 1));
+                const float octaveAway = jmax (filterBank.getBandLevel (peakBand - 3), filterBank.getBandLevel (peakBand + 3));
+
+                logValue ("1KHz tone", "adjacentBandsDb", toDecibels (adjacent / reference));
+                logValue ("1KHz tone", "oneOctaveAwayDb", toDecibels (octaveAway / reference));
+            }
+        }
+    }
+};
+
+static OctaveFilterBankBenchmark octaveFilterBankBenchmark;
+
+//==============================================================================
+class SampleRateConverterBenchmark  : public PerformanceBenchmark
+{
+public:
+    SampleRateConverterBenchmark() : PerformanceBenchmark ("SampleRateConverter", "audio") {}
+
+    void runBenchmark() override
+    {
+        using namespace BenchmarkHelpers;
+
+        const double ratios[] = { 0.5, 0.9, 1.0, 1.1, 2.0 };
+
+        for (auto ratio : ratios)
+        {
+            const int numInputSamples = blockSize;
+            const int numOutputSamples = roundToInt (blockSize / ratio);
+
+            AudioSampleBuffer input (2, numInputSamples), work (2, numInputSamples), output (2, numOutputSamples);
+            fillWithTestSignal (input, sampleRate);
+
+            SampleRateConverter converter (2);
+
+            measure ("ratio " + String (ratio, 2), numInputSamples, sampleRate, [&]
+            {
+                work.makeCopyOf (input, true);
+                converter.process (work.getArrayOfWritePointers(), 2, numInputSamples,
+                                   output.getArrayOfWritePointers(), 2, numOutputSamples);
+            });
+        }
+    }
+};
+
+static SampleRateConverterBenchmark sampleRateConverterBenchmark;
+
+//==============================================================================
+class OversamplerBenchmark  : public PerformanceBenchmark
+{
+public:
+    OversamplerBenchmark() : PerformanceBenchmark ("Oversampler", "audio") {}
+
+    void runBenchmark() override
+    {
+        using namespace BenchmarkHelpers;
+
+        // the cost of each extra stage is the difference between consecutive factors
+        for (int numStages = 1; numStages <= 3; ++numStages)
+        {
+            Oversampler oversampler (2, numStages);
+            oversampler.prepare (blockSize);
+
+            AudioSampleBuffer buffer (2, blockSize);
+            fillWithTestSignal (buffer, sampleRate);
+
+            const String caseName ("Oversampler " + String (oversampler.getFactor()) + "x stereo");
+
+            measure (caseName, blockSize, sampleRate, [&]
+            {
+                oversampler.process (buffer.getArrayOfWritePointers(), blockSize, [] (float**, int, int) {});
+            });
+
+            logValue (caseName, "latencySamples", oversampler.getLatencyInSamples());
+
+            for (int s = 0; s < numStages; ++s)
+                logValue (caseName, "stage" + String (s + 1) + "Taps", oversampler.getNumTaps (s));
+
+            // sines above the original Nyquist frequency written straight into the
+            // oversampled block, what gets through the downsampler is aliasing
+            const double oversampledRate = sampleRate * oversampler.getFactor();
+            const int numOversampled = blockSize * oversampler.getFactor();
+            const int numBlocks = 32;
+
+            for (double frequency : { 25000.0, 30000.0, 60000.0, 120000.0 })
+            {
+                if (frequency >= 0.5 * oversampledRate)
+                    continue;
+
+                oversampler.reset();
+                buffer.clear();
+                double sumSquares = 0.0;
+
+                for (int block = 0; block < numBlocks; ++block)
+                {
+                    float** oversampled = oversampler.processSamplesUp (buffer.getArrayOfReadPointers(), blockSize);
+
+                    for (int c = 0; c < 2; ++c)
+                        for (int i = 0; i < numOversampled; ++i)
+                            oversampled[c][i] = (float) std::sin (2.0 * MathConstants<double>::pi * frequency
+                                                                    * (block * numOversampled + i) / oversampledRate);
+
+                    oversampler.processSamplesDown (buffer.getArrayOfWritePointers(), blockSize);
+
+                    // skip the filters' start up transient
+                    if (block >= numBlocks / 2)
+                        for (int i = 0; i < blockSize; ++i)
+                            sumSquares += buffer.getSample (0, i) * buffer.getSample (0, i);
+                }
+
+                const double rms = std::sqrt (sumSquares / (blockSize * numBlocks / 2));
+                logValue (caseName, "aliasRejectionDb@" + String (roundToInt (frequency)), toDecibels (rms / std::sqrt (0.5)));
+            }
+        }
+    }
+};
+
+static OversamplerBenchmark oversamplerBenchmark;
+
+#if DROWAUDIO_USE_SOUNDTOUCH
+//==============================================================================
+class SoundTouchBenchmark  : public PerformanceBenchmark
+{
+public:
+    SoundTouchBenchmark() : PerformanceBenchmark ("SoundTouchProcessor", "audio") {}
+
+    void runBenchmark() override
+    {
+        using namespace BenchmarkHelpers;
+
+        const SoundTouchProcessor::PlaybackSettings settings[] =
+        {
+            { 1.0f, 1.0f, 1.0f },
+            { 1.0f, 0.8f, 1.0f },
+            { 1.0f, 1.25f, 1.0f },
+            { 1.0f, 1.0f, 1.06f },
+            { 1.1f, 1.0f, 1.0f }
+        };
+
+        AudioSampleBuffer input (2, blockSize), output (2, blockSize);
+        fillWithTestSignal (input, sampleRate);
+
+        // compare the mirrored ring FIFOs with ordinary linear ones
+        for (int mirrored = 0; mirrored < 2; ++mirrored)
+        {
+            soundtouch::FIFOSampleBuffer::setMirroredMemoryEnabled (mirrored);
+            const String fifoName (mirrored != 0 ? " mirrored" : " linear");
+
+            for (const auto& setting : settings)
+            {
+                SoundTouchProcessor processor;
+                processor.initialise (2, sampleRate);
+                processor.setPlaybackSettings (setting);
+
+                String caseName;
+                caseName << "rate " << String (setting.rate, 2)
+                         << " tempo " << String (setting.tempo, 2)
+                         << " pitch " << String (setting.pitch, 2)
+                         << fifoName;
+
+                measure (caseName, blockSize, sampleRate, [&]
+                {
+                    processor.writeSamples (input.getArrayOfWritePointers(), 2, blockSize);
+
+                    while (processor.getNumReady() >= blockSize)
+                        processor.readSamples (output.getArrayOfWritePointers(), 2, blockSize);
+                });
+            }
+
+            // the FIFO on its own with a large backlog, which is where rewinding hurt most
+            {
+                soundtouch::FIFOSampleBuffer fifo (2);
+                HeapBlock<float> interleaved ((size_t) blockSize * 2, true);
+
+                for (int i = 0; i < 16; ++i)
+                    fifo.putSamples (interleaved, (unsigned int) blockSize);
+
+                logValue ("FIFOSampleBuffer" + fifoName, "isMirrored", fifo.isMirrored());
+
+                measure ("FIFOSampleBuffer" + fifoName, 64, sampleRate, [&]
+                {
+                    fifo.putSamples (interleaved, 64);
+                    fifo.receiveSamples (interleaved, 64);
+                });
+            }
+        }
+
+        soundtouch::FIFOSampleBuffer::setMirroredMemoryEnabled (SOUNDTOUCH_USE_MIRRORED_FIFO);
+    }
+};
+
+static SoundTouchBenchmark soundTouchBenchmark;
+
+//==============================================================================
+/** Exposes TDStretch's overlap searches so they can be compared directly. */
+class TDStretchSeekProbe  : public soundtouch::TDStretch
+{
+public:
+    TDStretchSeekProbe (int sampleRate, int seekWindowMs)
+    {
+        setChannels (2);
+        setParameters (sampleRate, -1, seekWindowMs, -1);
+    }
+
+    int getOverlapLength() const noexcept   { return overlapLength; }
+    int getSeekLength() const noexcept      { return seekLength; }
+
+    void setReference (const float* interleaved)
+    {
+        memcpy (pMidBuffer, interleaved, sizeof (float) * 2 * (size_t) overlapLength);
+    }
+
+    int seekFull (const float* input)           { return seekBestOverlapPositionStereo (input); }
+    int seekQuick (const float* input)          { return seekBestOverlapPositionStereoQuick (input); }
+    int seekHierarchical (const float* input)   { return seekBestOverlapPositionHierarchical (input); }
+
+    double getScore (const float* input, int offset)
+    {
+        precalcCorrReferenceStereo();
+        return calcOverlapScore (input, offset);
+    }
+};
+
+//==============================================================================
+class TDStretchSeekBenchmark  : public PerformanceBenchmark
+{
+public:
+    TDStretchSeekBenchmark() : PerformanceBenchmark ("TDStretchSeek", "audio") {}
+
+    void runBenchmark() override
+    {
+        using namespace BenchmarkHelpers;
+
+        const int numSamples = (int) sampleRate * 10;
+        AudioSampleBuffer signal (2, numSamples);
+        fillWithTestSignal (signal, sampleRate);
+
+        HeapBlock<float> interleaved ((size_t) numSamples * 2);
+        AudioDataConverters::interleaveSamples (signal.getArrayOfReadPointers(), interleaved, numSamples, 2);
+
+        // the automatic seek window ranges from 15 to 25ms, 28ms was the old default
+        const int seekWindowsMs[] = { 15, 20, 25, 28 };
+
+        for (auto seekWindowMs : seekWindowsMs)
+        {
+            TDStretchSeekProbe probe ((int) sampleRate, seekWindowMs);
+            const String suffix (" " + String (seekWindowMs) + "ms");
+            const float* reference = interleaved;
+            const float* input = interleaved + 2 * 2000;
+
+            probe.setReference (reference);
+            measure ("full" + suffix, 1, 0.0, [&] { probe.seekFull (input); });
+            measure ("quick" + suffix, 1, 0.0, [&] { probe.seekQuick (input); });
+            measure ("hierarchical" + suffix, 1, 0.0, [&] { probe.seekHierarchical (input); });
+
+            // compare the chosen offsets with the full search over the whole signal
+            const int stride = 3001;
+            const int maxPosition = numSamples - 2000 - probe.getSeekLength() - 2 * probe.getOverlapLength();
+            int numTrials = 0, numExactHierarchical = 0, numExactQuick = 0;
+            double fullScore = 0.0, hierarchicalScore = 0.0, quickScore = 0.0;
+
+            for (int pos = 0; pos < maxPosition; pos += stride)
+            {
+                probe.setReference (interleaved + 2 * pos);
+                const float* window = interleaved + 2 * (pos + 2000);
+
+                const int fullOffset = probe.seekFull (window);
+                const int hierarchicalOffset = probe.seekHierarchical (window);
+                const int quickOffset = probe.seekQuick (window);
+
+                fullScore += probe.getScore (window, fullOffset);
+                hierarchicalScore += probe.getScore (window, hierarchicalOffset);
+                quickScore += probe.getScore (window, quickOffset);
+                numExactHierarchical += (hierarchicalOffset == fullOffset) ? 1 : 0;
+                numExactQuick += (quickOffset == fullOffset) ? 1 : 0;
+                ++numTrials;
+            }
+
+            if (numTrials > 0 && fullScore > 0.0)
+            {
+                logValue ("hierarchical" + suffix, "exactMatchPercent", 100.0 * numExactHierarchical / numTrials);
+                logValue ("hierarchical" + suffix, "scoreRatio", hierarchicalScore / fullScore);
+                logValue ("quick" + suffix, "exactMatchPercent", 100.0 * numExactQuick / numTrials);
+                logValue ("quick" + suffix, "scoreRatio", quickScore / fullScore);
+            }
+        }
+    }
+};
+
+static TDStretchSeekBenchmark tdStretchSeekBenchmark;
+#endif // DROWAUDIO_USE_SOUNDTOUCH
+
+//==============================================================================
+class PitchDetectorBenchmark  : public PerformanceBenchmark
+{
+public:
+    PitchDetectorBenchmark() : PerformanceBenchmark ("PitchDetector", "audio") {}
+
+    void runBenchmark() override
+    {
+        using namespace BenchmarkHelpers;
+
+        AudioSampleBuffer input (1, blockSize);
+        fillWithTestSignal (input, sampleRate);
+
+        const PitchDetector::DetectionMethod methods[] = { PitchDetector::autoCorrelationFunction,
+                                                           PitchDetector::squareDifferenceFunction };
+
+        for (auto method : methods)
+        {
+            PitchDetector detector;
+            detector.setSampleRate (sampleRate);
+            detector.setMinMaxFrequency (50.0f, 1600.0f);
+            detector.setDetectionMethod (method);
+
+            measure (method == PitchDetector::autoCorrelationFunction ? "ACF" : "SDF",
+                     blockSize, sampleRate, [&]
+            {
+                detector.processSamples (input.getReadPointer (0), blockSize);
+            });
+        }
+    }
+};
+
+static PitchDetectorBenchmark pitchDetectorBenchmark;
+
+#endif // DROWAUDIO_BENCHMARKS
@@ -29,7 +29,43 @@
   ==============================================================================
 */
 
+namespace AudioFilePlayerHelpers
+{
+    /** An AudioFormatReaderSource that traces and times its reads. These are made by the
+        BufferingAudioSource's read-ahead on the buffering thread, never the audio thread.
+    */
+    class TracedAudioFormatReaderSource  : public AudioFormatReaderSource
+    {
+    public:
+       #if DROWAUDIO_USE_PROCESS_TIMING
+        TracedAudioFormatReaderSource (AudioFormatReader* reader, ProcessTimeHistogram& histogramToUse)
+            : AudioFormatReaderSource (reader, true),
+              processTimeHistogram (histogramToUse)
+        {
+        }
+       #else
+        explicit TracedAudioFormatReaderSource (AudioFormatReader* reader)
+            : AudioFormatReaderSource (reader, true)
+        {
+        }
+       #endif
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            DROWAUDIO_TRACE_THREAD();
+            DROWAUDIO_TRACE_SCOPE ("AudioFilePlayer read-ahead")
+            DROWAUDIO_TIME_PROCESS (processTimeHistogram)
+            AudioFormatReaderSource::getNextAudioBlock (info);
+        }
+
+    private:
+       #if DROWAUDIO_USE_PROCESS_TIMING
+        ProcessTimeHistogram& processTimeHistogram;
+       #endif
+    };
+}
 
+//==============================================================================
 AudioFilePlayer::AudioFilePlayer()
     : bufferingTimeSliceThread (new TimeSliceThread ("Shared Buffering Thread"), true),
       formatManager (new AudioFormatManager(), true)
@@ -126,6 +162,8 @@ void AudioFilePlayer::releaseResources()
 
 void AudioFilePlayer::getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill)
 {
+    DROWAUDIO_TIME_PROCESS (processTimeHistogram)
+
     if (masterSource != nullptr)
         masterSource->getNextAudioBlock (bufferToFill);
 }
@@ -174,6 +212,16 @@ void AudioFilePlayer::removeListener (AudioFilePlayer::Listener* const listener)
 }
 
 //==============================================================================
+void AudioFilePlayer::createReaderSource (AudioFormatReader* reader)
+{
+    // we SHOULD let the AudioFormatReaderSource delete the reader for us..
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    audioFormatReaderSource = std::make_unique<AudioFilePlayerHelpers::TracedAudioFormatReaderSource> (reader, readerProcessTimeHistogram);
+   #else
+    audioFormatReaderSource = std::make_unique<AudioFilePlayerHelpers::TracedAudioFormatReaderSource> (reader);
+   #endif
+}
+
 bool AudioFilePlayer::setSourceWithReader (AudioFormatReader* reader)
 {
     bool shouldBeLooping = isLooping();
@@ -181,8 +229,7 @@ bool AudioFilePlayer::setSourceWithReader (AudioFormatReader* reader)
 
     if (reader != nullptr)
     {
-        // we SHOULD let the AudioFormatReaderSource delete the reader for us..
-        audioFormatReaderSource = std::make_unique<AudioFormatReaderSource> (reader, true);
+        createReaderSource (reader);
         audioTransportSource.setSource (audioFormatReaderSource.get(), 32768,
                                         bufferingTimeSliceThread, reader->sampleRate);
 
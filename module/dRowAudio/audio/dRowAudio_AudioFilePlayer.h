@@ -33,6 +33,7 @@
 #define DROWAUDIO_AUDIOFILEPLAYER_H
 
 #include "../streams/dRowAudio_StreamAndFileHandler.h"
+#include "dRowAudio_ProcessTimeHistogram.h"
 
 /** This class can be used to load and play an audio file from disk.
 
@@ -161,6 +162,16 @@ public:
     /** Removes a previously-registered listener. */
     void removeListener (Listener* listener);
 
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    /** Returns the times spent in getNextAudioBlock, including the time taken by the whole source chain. */
+    const ProcessTimeHistogram& getProcessTimeHistogram() const noexcept { return processTimeHistogram; }
+
+    /** Returns the times spent reading from the file.
+        These reads are made by the buffering thread so aren't included in getProcessTimeHistogram().
+    */
+    const ProcessTimeHistogram& getReaderProcessTimeHistogram() const noexcept { return readerProcessTimeHistogram; }
+   #endif
+
     //==============================================================================
     /** @internal */
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
@@ -195,8 +206,17 @@ protected:
     AudioTransportSource audioTransportSource;
 
     ListenerList <Listener> listeners;
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    ProcessTimeHistogram processTimeHistogram, readerProcessTimeHistogram;
+   #endif
 
     //==============================================================================
+    /** Replaces the audioFormatReaderSource with one that reads from the given reader,
+        which it will delete when it's finished with it.
+        The new source's reads are timed into getReaderProcessTimeHistogram().
+    */
+    void createReaderSource (AudioFormatReader* reader);
+
     /** Sets up the audio chain when a new source is chosen.
 
         By default this will create a new AudioFormatReader source and attach it to the
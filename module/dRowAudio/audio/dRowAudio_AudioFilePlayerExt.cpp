@@ -141,9 +141,8 @@ bool AudioFilePlayerExt::setSourceWithReader (AudioFormatReader* reader)
 
     if (reader != nullptr)
     {
-        // we SHOULD let the AudioFormatReaderSource delete the reader for us..
-        audioFormatReaderSource = new AudioFormatReaderSource (reader, true);
-        bufferingAudioSource = new BufferingAudioSource (audioFormatReaderSource,
+        createReaderSource (reader);
+        bufferingAudioSource = new BufferingAudioSource (audioFormatReaderSource.get(),
                                                          *bufferingTimeSliceThread,
                                                          false,
                                                          32768);
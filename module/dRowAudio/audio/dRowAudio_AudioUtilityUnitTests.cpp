@@ -91,6 +91,506 @@ public:
 static AudioSampleBufferUnitTests audioSampleBufferUnitTests;
 
 //==============================================================================
+class BufferUnitTests  : public UnitTest
+{
+public:
+    BufferUnitTests() : UnitTest ("BufferUnitTests") {}
+
+    void runTest()
+    {
+        beginTest ("Alignment");
+
+        for (size_t size : { (size_t) 1, (size_t) 17, (size_t) 1024 })
+        {
+            Buffer buffer (size);
+            expect (isAligned (buffer.getData()));
+
+            buffer.setSize (size * 3);
+            expect (isAligned (buffer.getData()));
+
+            buffer.setSizeQuick (size + 5);
+            expect (isAligned (buffer.getData()));
+        }
+
+        beginTest ("Move");
+
+        {
+            Buffer source (256);
+            source.getReference (10) = 0.5f;
+            const float* const sourceData = source.getData();
+
+            Buffer moved (std::move (source));
+            expect (moved.getData() == sourceData);
+            expectEquals ((int) moved.getSize(), 256);
+            expectEquals (moved[10], 0.5f);
+            expectEquals ((int) source.getSize(), 0);
+
+            Buffer assigned;
+            assigned = std::move (moved);
+            expect (assigned.getData() == sourceData);
+            expectEquals ((int) moved.getSize(), 0);
+        }
+
+        beginTest ("Snapshots");
+
+        {
+            Buffer buffer (64);
+            expect (buffer.snapshot() == nullptr);
+
+            buffer.getReference (0) = 1.0f;
+            buffer.updateListeners();
+
+            auto firstSnapshot = buffer.snapshot();
+            expect (firstSnapshot != nullptr);
+            expect (isAligned (firstSnapshot->getData()));
+            expectEquals ((int) firstSnapshot->getSize(), 64);
+
+            // snapshots held by readers mustn't change when the buffer is written to
+            buffer.getReference (0) = 2.0f;
+            buffer.updateListeners();
+
+            expectEquals ((*firstSnapshot)[0], 1.0f);
+            expectEquals ((*buffer.snapshot())[0], 2.0f);
+
+            // once released they should be reused rather than reallocated
+            const float* const firstData = firstSnapshot->getData();
+            firstSnapshot = nullptr;
+
+            buffer.getReference (0) = 3.0f;
+            buffer.updateListeners();
+
+            auto reusedSnapshot = buffer.snapshot();
+            expect (reusedSnapshot->getData() == firstData);
+            expectEquals ((*reusedSnapshot)[0], 3.0f);
+        }
+    }
+
+private:
+    static bool isAligned (const float* data)
+    {
+        return (reinterpret_cast<pointer_sized_uint> (data) % Buffer::alignment) == 0;
+    }
+};
+
+static BufferUnitTests bufferUnitTests;
+
+//==============================================================================
+#if DROWAUDIO_REALTIME_SAFETY_CHECKS
+
+class RealtimeSafetyUnitTests  : public UnitTest
+{
+public:
+    RealtimeSafetyUnitTests() : UnitTest ("RealtimeSafetyUnitTests") {}
+
+    void runTest()
+    {
+        beginTest ("RealtimeSafetyChecker");
+        {
+            RealtimeSafetyChecker::resetViolations();
+
+            {
+                int* volatile outsideScope = new int (0);
+                delete outsideScope;
+                DROWAUDIO_CHECK_REALTIME_LOCK ("RealtimeSafetyUnitTests outside scope");
+            }
+
+            expectEquals (RealtimeSafetyChecker::getNumViolations(), 0);
+
+            bool wasRealtimeThread = false;
+
+            {
+                DROWAUDIO_REALTIME_SCOPE ("RealtimeSafetyUnitTests")
+                wasRealtimeThread = RealtimeSafetyChecker::isRealtimeThread();
+
+                {
+                    const RealtimeSafetyChecker::ScopedIgnoreViolations ignoreViolations;
+                    int* volatile ignored = new int (0);
+                    delete ignored;
+                }
+
+                int* volatile insideScope = new int (0);
+                delete insideScope;
+                DROWAUDIO_CHECK_REALTIME_LOCK ("RealtimeSafetyUnitTests inside scope");
+            }
+
+            expect (wasRealtimeThread);
+            expect (! RealtimeSafetyChecker::isRealtimeThread());
+            expectEquals (RealtimeSafetyChecker::getNumViolations (RealtimeSafetyChecker::allocation), 1);
+            expectEquals (RealtimeSafetyChecker::getNumViolations (RealtimeSafetyChecker::deallocation), 1);
+            expectEquals (RealtimeSafetyChecker::getNumViolations (RealtimeSafetyChecker::lockAcquisition), 1);
+
+            RealtimeSafetyChecker::resetViolations();
+        }
+
+        beginTest ("FilteringAudioSource");
+        {
+            FilteringAudioSource source (new TestSource(), true);
+            source.setGain (FilteringAudioSource::Low, 0.5f);
+            source.setGain (FilteringAudioSource::Mid, 1.5f);
+            expectNoViolations (source, "FilteringAudioSource");
+        }
+
+        beginTest ("LoopingAudioSource");
+        {
+            LoopingAudioSource source (new TestSource(), true);
+            source.prepareToPlay (blockSize, sampleRate);
+            source.setLoopTimes (0.1, 0.2);
+            source.setLoopBetweenTimes (true);
+            expectNoViolations (source, "LoopingAudioSource");
+        }
+
+        beginTest ("ReversibleAudioSource");
+        {
+            ReversibleAudioSource source (new TestSource(), true);
+            source.setNextReadPosition (TestSource::numSamples / 2);
+            source.setPlayDirection (false);
+            expectNoViolations (source, "ReversibleAudioSource");
+        }
+
+       #if DROWAUDIO_USE_SOUNDTOUCH
+        beginTest ("SoundTouchAudioSource");
+        {
+            SoundTouchAudioSource source (new TestSource(), true);
+            source.setPlaybackSettings (SoundTouchProcessor::PlaybackSettings (1.0f, 1.25f, 0.9f));
+            playInRealtimeScope (source, "SoundTouchAudioSource");
+
+            // SoundTouchProcessor still serialises settings changes with a lock
+            expectNoAllocations();
+        }
+       #endif
+
+        beginTest ("AudioFilePlayer");
+        {
+            MemoryBlock wavData;
+            writeTestWav (wavData);
+
+            AudioFilePlayer player;
+            expect (player.setMemoryBlock (wavData));
+            player.setLooping (true);
+            player.start();
+
+            // give the buffering thread time to read ahead first
+            playInRealtimeScope (player, "AudioFilePlayer", 200);
+
+           #if JUCE_LINUX
+            // AudioTransportSource takes its callback lock every block, which is
+            // only visible through the pthread_mutex_lock interposer
+            expect (RealtimeSafetyChecker::getNumViolations (RealtimeSafetyChecker::lockAcquisition) > 0);
+           #endif
+
+            expectNoAllocations();
+            player.stop();
+        }
+    }
+
+private:
+    //==============================================================================
+    enum { blockSize = 512 };
+    static constexpr double sampleRate = 44100.0;
+
+    /** A looping sine tone that is rendered up front so reading it doesn't allocate. */
+    class TestSource  : public PositionableAudioSource
+    {
+    public:
+        enum { numSamples = 44100 };
+
+        TestSource() : buffer (2, numSamples), position (0)
+        {
+            for (int c = 0; c < buffer.getNumChannels(); ++c)
+                for (int i = 0; i < numSamples; ++i)
+                    buffer.setSample (c, i, (float) std::sin (i * 0.05));
+        }
+
+        void prepareToPlay (int, double) override {}
+        void releaseResources() override {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            for (int i = 0; i < info.numSamples; ++i)
+            {
+                const int bufferPos = (int) ((position + i) % numSamples);
+
+                for (int c = 0; c < info.buffer->getNumChannels(); ++c)
+                    info.buffer->setSample (c, info.startSample + i, buffer.getSample (c % 2, bufferPos));
+            }
+
+            position += info.numSamples;
+        }
+
+        void setNextReadPosition (int64 newPosition) override   { position = jmax ((int64) 0, newPosition); }
+        int64 getNextReadPosition() const override              { return position; }
+        int64 getTotalLength() const override                   { return numSamples; }
+        bool isLooping() const override                         { return true; }
+
+    private:
+        AudioSampleBuffer buffer;
+        int64 position;
+    };
+
+    /** Writes the TestSource's tone to a WAV file in memory. */
+    static void writeTestWav (MemoryBlock& destData)
+    {
+        AudioSampleBuffer buffer (2, TestSource::numSamples);
+        TestSource source;
+        source.getNextAudioBlock (AudioSourceChannelInfo (&buffer, 0, buffer.getNumSamples()));
+
+        WavAudioFormat wavFormat;
+        std::unique_ptr<AudioFormatWriter> writer (wavFormat.createWriterFor (new MemoryOutputStream (destData, false),
+                                                                              sampleRate, 2, 16, StringPairArray(), 0));
+        writer->writeFromAudioSampleBuffer (buffer, 0, buffer.getNumSamples());
+    }
+
+    /** Plays a source for a while inside a real-time scope, leaving the violations for the caller to check.
+        A few blocks are processed first so that any lazy initialisation isn't counted.
+    */
+    void playInRealtimeScope (AudioSource& source, const char* scopeName, int warmUpMilliseconds = 0)
+    {
+        AudioSampleBuffer buffer (2, blockSize);
+        const AudioSourceChannelInfo info (&buffer, 0, blockSize);
+
+        source.prepareToPlay (blockSize, sampleRate);
+
+        if (warmUpMilliseconds > 0)
+            Thread::sleep (warmUpMilliseconds);
+
+        for (int i = 0; i < 16; ++i)
+            source.getNextAudioBlock (info);
+
+        RealtimeSafetyChecker::resetViolations();
+
+        {
+            DROWAUDIO_REALTIME_SCOPE (scopeName)
+
+            for (int i = 0; i < 256; ++i)
+                source.getNextAudioBlock (info);
+        }
+
+        source.releaseResources();
+    }
+
+    /** Plays a source inside a real-time scope and checks nothing allocated or locked. */
+    void expectNoViolations (AudioSource& source, const char* scopeName)
+    {
+        playInRealtimeScope (source, scopeName);
+
+        expectEquals (RealtimeSafetyChecker::getNumViolations(), 0);
+        RealtimeSafetyChecker::resetViolations();
+    }
+
+    /** Checks the last scope didn't allocate, whatever locks it took. */
+    void expectNoAllocations()
+    {
+        expectEquals (RealtimeSafetyChecker::getNumViolations (RealtimeSafetyChecker::allocation), 0);
+        expectEquals (RealtimeSafetyChecker::getNumViolations (RealtimeSafetyChecker::deallocation), 0);
+        RealtimeSafetyChecker::resetViolations();
+    }
+};
+
+static RealtimeSafetyUnitTests realtimeSafetyUnitTests;
+
+#endif // DROWAUDIO_REALTIME_SAFETY_CHECKS
+
+//==============================================================================
+class FilterCoefficientUnitTests  : public UnitTest
+{
+public:
+    FilterCoefficientUnitTests() : UnitTest ("FilterCoefficientUnitTests") {}
+
+    void runTest()
+    {
+        beginTest ("DoubleBufferedValue");
+        {
+            // every element of a set is written with the same value so a set that
+            // was swapped in half written would show up as a mismatch
+            struct TestSet { int values[16]; };
+
+            DoubleBufferedValue<TestSet> value;
+            const int numWrites = 200000;
+
+            ControlThread writer ([&] (int index)
+            {
+                TestSet set;
+
+                for (auto& v : set.values)
+                    v = index + 1;
+
+                value.set (set);
+            }, numWrites, 0);
+
+            writer.startThread();
+
+            int numSwaps = 0, numTornSets = 0, numOutOfOrder = 0, lastValue = 0;
+
+            for (bool finished = false; ! finished;)
+            {
+                // once the writer has stopped one more update picks up its last set
+                finished = ! writer.isThreadRunning();
+
+                if (value.update())
+                    ++numSwaps;
+
+                const TestSet& set = value.get();
+
+                for (auto v : set.values)
+                    if (v != set.values[0])
+                        ++numTornSets;
+
+                if (set.values[0] < lastValue)
+                    ++numOutOfOrder;
+
+                lastValue = set.values[0];
+            }
+
+            expect (numSwaps > 0);
+            expectEquals (numTornSets, 0);
+            expectEquals (numOutOfOrder, 0);
+            expectEquals (value.get().values[0], numWrites);
+            expectEquals (value.getLatest().values[0], numWrites);
+        }
+
+        beginTest ("BiquadFilter and OnePoleFilter under coefficient changes");
+        {
+            BiquadFilter biquad;
+            OnePoleFilter onePole;
+            biquad.setCoefficients (BiquadFilter::makeLowPass (sampleRate, 1000.0, 0.7));
+            onePole.makeLowPass (sampleRate, 1000.0);
+
+            // a control sweeping the cutoff back and forth at a UI-like rate
+            ControlThread writer ([&] (int index)
+            {
+                const double frequency = 100.0 + 9900.0 * std::abs (std::sin (index * 0.05));
+                biquad.setCoefficients (BiquadFilter::makeLowPass (sampleRate, frequency, 0.7));
+                onePole.makeLowPass (sampleRate, frequency);
+            }, 2000, 1);
+
+            writer.startThread();
+
+            AudioSampleBuffer buffer (2, blockSize);
+            bool allFinite = true;
+            float peak = 0.0f;
+
+            while (writer.isThreadRunning())
+            {
+                fillWithTone (buffer);
+                biquad.processSamples (buffer.getWritePointer (0), blockSize);
+                onePole.processSamples (buffer.getWritePointer (1), blockSize);
+
+                for (int c = 0; c < 2; ++c)
+                {
+                    const Range<float> range (buffer.findMinMax (c, 0, blockSize));
+                    allFinite = allFinite && std::isfinite (range.getStart()) && std::isfinite (range.getEnd());
+                    peak = jmax (peak, std::abs (range.getStart()), std::abs (range.getEnd()));
+                }
+            }
+
+            expect (allFinite);
+            expect (peak < 2.0f);
+        }
+
+        beginTest ("FilteringAudioSource under gain changes");
+        {
+            FilteringAudioSource source (new ToneSource(), true);
+            source.prepareToPlay (blockSize, sampleRate);
+
+            ControlThread writer ([&] (int index)
+            {
+                const float gain = 2.0f * std::abs ((float) std::sin (index * 0.1));
+                source.setGain ((FilteringAudioSource::FilterType) (index % FilteringAudioSource::numFilters), gain);
+            }, 2000, 1);
+
+            writer.startThread();
+
+            AudioSampleBuffer buffer (2, blockSize);
+            const AudioSourceChannelInfo info (&buffer, 0, blockSize);
+            int numMismatchedBlocks = 0;
+            bool allFinite = true;
+
+            while (writer.isThreadRunning())
+            {
+                source.getNextAudioBlock (info);
+
+                // both channels carry the same tone so they only differ if the
+                // coefficients changed part way through a block
+                for (int i = 0; i < blockSize; ++i)
+                {
+                    if (buffer.getSample (0, i) != buffer.getSample (1, i))
+                    {
+                        ++numMismatchedBlocks;
+                        break;
+                    }
+                }
+
+                allFinite = allFinite && std::isfinite (buffer.getMagnitude (0, blockSize));
+            }
+
+            expectEquals (numMismatchedBlocks, 0);
+            expect (allFinite);
+
+            source.releaseResources();
+        }
+    }
+
+private:
+    //==============================================================================
+    enum { blockSize = 512 };
+    static constexpr double sampleRate = 44100.0;
+
+    /** Calls a function a number of times, pausing between calls like a UI control. */
+    class ControlThread  : public Thread
+    {
+    public:
+        ControlThread (std::function<void (int)> callback_, int numCalls_, int msBetweenCalls_)
+            : Thread ("FilterCoefficientUnitTests control"),
+              callback (callback_), numCalls (numCalls_), msBetweenCalls (msBetweenCalls_)
+        {
+        }
+
+        ~ControlThread() override
+        {
+            stopThread (5000);
+        }
+
+        void run() override
+        {
+            for (int i = 0; i < numCalls && ! threadShouldExit(); ++i)
+            {
+                callback (i);
+
+                if (msBetweenCalls > 0)
+                    sleep (msBetweenCalls);
+            }
+        }
+
+    private:
+        std::function<void (int)> callback;
+        const int numCalls, msBetweenCalls;
+    };
+
+    /** Plays the same tone and noise on every channel. */
+    class ToneSource  : public AudioSource
+    {
+    public:
+        void prepareToPlay (int, double) override {}
+        void releaseResources() override {}
+
+        void getNextAudioBlock (const AudioSourceChannelInfo& info) override
+        {
+            fillWithTone (*info.buffer);
+        }
+    };
+
+    static void fillWithTone (AudioSampleBuffer& buffer)
+    {
+        for (int i = 0; i < buffer.getNumSamples(); ++i)
+        {
+            const float sample = 0.5f * (float) std::sin (i * 0.05) + 0.25f * (float) std::sin (i * 1.3);
+
+            for (int c = 0; c < buffer.getNumChannels(); ++c)
+                buffer.setSample (c, i, sample);
+        }
+    }
+};
 
+static FilterCoefficientUnitTests filterCoefficientUnitTests;
 
 #endif // DROWAUDIO_UNIT_TESTS
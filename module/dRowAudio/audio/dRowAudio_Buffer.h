@@ -42,31 +42,79 @@
     You can attach listners that inherit from Buffer::Listener to a Buffer
     to be notified when they change their contents using Buffer::addListener.
     This can be useful in updating UI elements such as wave displays.
+
+    The data is always aligned to Buffer::alignment bytes so SIMD code can use
+    aligned loads and stores on it.
+
+    Listeners are called on whichever thread calls updateListeners(). If they need
+    to read the data on another thread they should use snapshot() which returns
+    a read-only copy that can be safely held on to.
  */
 class Buffer
 {
 public:
+    /** The alignment in bytes of the data returned by getData(). */
+    enum { alignment = 64 };
+
     /** Creates an empty Buffer. */
     Buffer() :
-        bufferSize (0)
+        buffer (nullptr),
+        bufferSize (0),
+        latestSnapshotIndex (-1),
+        snapshotsRequested (false)
     {
     }
 
     /** Creates a buffer with a given size. */
     Buffer (size_t size) :
-        bufferSize (size)
+        bufferSize (size),
+        latestSnapshotIndex (-1),
+        snapshotsRequested (false)
     {
-        buffer.allocate (bufferSize, true);
+        buffer = allocateAligned (storage, bufferSize, true);
     }
 
-    /** Creates a copy of another buffer. */
+    /** Creates a copy of another buffer.
+        Listeners and snapshots are not copied.
+     */
     Buffer (const Buffer& otherBuffer) :
-        bufferSize (otherBuffer.bufferSize)
+        bufferSize (otherBuffer.bufferSize),
+        latestSnapshotIndex (-1),
+        snapshotsRequested (false)
     {
-        buffer.allocate (bufferSize, false);
+        buffer = allocateAligned (storage, bufferSize, false);
         memcpy (buffer, otherBuffer.buffer, bufferSize * sizeof (float));
     }
 
+    /** Moves another buffer's data into a new one.
+        Listeners and snapshots are not moved.
+     */
+    Buffer (Buffer&& otherBuffer) noexcept :
+        storage (std::move (otherBuffer.storage)),
+        buffer (otherBuffer.buffer),
+        bufferSize (otherBuffer.bufferSize),
+        latestSnapshotIndex (-1),
+        snapshotsRequested (false)
+    {
+        otherBuffer.buffer = nullptr;
+        otherBuffer.bufferSize = 0;
+    }
+
+    /** Moves another buffer's data into this one.
+        The listeners and snapshots of this buffer are left alone.
+     */
+    Buffer& operator= (Buffer&& otherBuffer) noexcept
+    {
+        storage = std::move (otherBuffer.storage);
+        buffer = otherBuffer.buffer;
+        bufferSize = otherBuffer.bufferSize;
+
+        otherBuffer.buffer = nullptr;
+        otherBuffer.bufferSize = 0;
+
+        return *this;
+    }
+
     //==============================================================================
     /** Changes the size of the buffer.
 
@@ -77,11 +125,18 @@ public:
     */
     void setSize (size_t newSize)
     {
-        buffer.realloc (newSize);
+        HeapBlock<char> newStorage;
+        float* const newBuffer = allocateAligned (newStorage, newSize, false);
+        const size_t numToKeep = jmin (bufferSize, newSize);
 
-        if (newSize > bufferSize)
-            zeromem (buffer + bufferSize, (newSize - bufferSize) * sizeof (float));
+        if (numToKeep > 0)
+            memcpy (newBuffer, buffer, numToKeep * sizeof (float));
 
+        if (newSize > numToKeep)
+            zeromem (newBuffer + numToKeep, (newSize - numToKeep) * sizeof (float));
+
+        storage.swapWith (newStorage);
+        buffer = newBuffer;
         bufferSize = newSize;
     }
 
@@ -92,7 +147,9 @@ public:
     */
     inline void setSizeQuick (size_t newSize)
     {
-        buffer.malloc (newSize);
+        if (newSize != bufferSize || buffer == nullptr)
+            buffer = allocateAligned (storage, newSize, false);
+
         bufferSize = newSize;
     }
 
@@ -113,9 +170,15 @@ public:
     inline void reset()                     { zeromem (buffer, bufferSize * sizeof (float)); }
 
     /** Returns a pointer to the beggining of the data.
+        This is aligned to Buffer::alignment bytes.
         Don't hang on to this pointer as it may change if the buffer is internally re-allocated.
      */
-    inline float* getData()                 { return buffer.getData(); }
+    inline float* getData()                 { return buffer; }
+
+    /** Returns a read-only pointer to the beggining of the data.
+        This is aligned to Buffer::alignment bytes.
+     */
+    inline const float* getData() const     { return buffer; }
 
     /** Returns the current size of the buffer. */
     inline size_t getSize() const           { return bufferSize; }
@@ -168,12 +231,152 @@ public:
     /** Updates the buffer's listeners.
 
         Call this to explicitly tell any registerd listeners that the buffer has changed.
+        If snapshot() has ever been called this will also publish a new snapshot first
+        so listeners can pick it up.
     */
     void updateListeners()
     {
+        if (snapshotsRequested.load())
+            publishSnapshot();
+
         listeners.call (&Listener::bufferChanged, this);
     }
 
+    //==============================================================================
+    /** A read-only copy of a Buffer's contents at the time it was published.
+
+        Each Buffer owns a small fixed set of these which it reuses, a reader holds
+        on to one through a SnapshotPtr without blocking the Buffer's writer.
+
+        @see Buffer::snapshot
+    */
+    class Snapshot
+    {
+    public:
+        Snapshot() noexcept : numReaders (0) {}
+
+        /** Returns the data, aligned to Buffer::alignment bytes. */
+        const float* getData() const noexcept           { return data; }
+
+        /** Returns the number of values in the snapshot. */
+        size_t getSize() const noexcept                 { return size; }
+
+        /** Returns a value from the snapshot without any bounds checking. */
+        float operator[] (int index) const noexcept     { return data[index]; }
+
+    private:
+        friend class Buffer;
+
+        HeapBlock<char> storage;
+        float* data = nullptr;
+        size_t size = 0;
+        mutable std::atomic<int> numReaders;
+
+        JUCE_DECLARE_NON_COPYABLE (Snapshot)
+    };
+
+    /** Keeps a Snapshot from being reused whilst it is held.
+
+        These can be copied and passed between threads freely but mustn't outlive
+        the Buffer they came from.
+    */
+    class SnapshotPtr
+    {
+    public:
+        SnapshotPtr() noexcept                                  {}
+        SnapshotPtr (decltype (nullptr)) noexcept               {}
+        SnapshotPtr (const SnapshotPtr& other) noexcept : snapshot (other.snapshot)    { addReader(); }
+        SnapshotPtr (SnapshotPtr&& other) noexcept : snapshot (other.snapshot)         { other.snapshot = nullptr; }
+        ~SnapshotPtr()                                          { removeReader(); }
+
+        SnapshotPtr& operator= (SnapshotPtr other) noexcept     { std::swap (snapshot, other.snapshot); return *this; }
+
+        const Snapshot* get() const noexcept                    { return snapshot; }
+        const Snapshot* operator->() const noexcept             { return snapshot; }
+        const Snapshot& operator*() const noexcept              { return *snapshot; }
+
+        bool operator== (decltype (nullptr)) const noexcept     { return snapshot == nullptr; }
+        bool operator!= (decltype (nullptr)) const noexcept     { return snapshot != nullptr; }
+
+    private:
+        friend class Buffer;
+
+        const Snapshot* snapshot = nullptr;
+
+        /** Takes over a reader count that has already been added. */
+        explicit SnapshotPtr (const Snapshot* s) noexcept : snapshot (s) {}
+
+        void addReader() noexcept       { if (snapshot != nullptr) snapshot->numReaders.fetch_add (1); }
+        void removeReader() noexcept    { if (snapshot != nullptr) snapshot->numReaders.fetch_sub (1); }
+    };
+
+    /** Copies the current contents into a Snapshot and publishes it for snapshot().
+
+        This should only be called from the thread that writes to the buffer. It
+        fills in whichever of the Buffer's snapshots isn't the latest and isn't held
+        by a reader, so only allocates when the buffer's size has changed. If every
+        other snapshot is still held the latest one is kept and nothing is published.
+    */
+    void publishSnapshot()
+    {
+        const int latestIndex = latestSnapshotIndex.load();
+        int nextIndex = -1;
+
+        for (int i = 0; i < numSnapshots; ++i)
+        {
+            if (i != latestIndex && snapshots[i].numReaders.load() == 0)
+            {
+                nextIndex = i;
+                break;
+            }
+        }
+
+        if (nextIndex < 0)
+            return;
+
+        Snapshot& nextSnapshot = snapshots[nextIndex];
+
+        if (nextSnapshot.size != bufferSize || nextSnapshot.data == nullptr)
+        {
+            nextSnapshot.data = allocateAligned (nextSnapshot.storage, bufferSize, false);
+            nextSnapshot.size = bufferSize;
+        }
+
+        if (bufferSize > 0)
+            memcpy (nextSnapshot.data, buffer, bufferSize * sizeof (float));
+
+        latestSnapshotIndex.store (nextIndex);
+    }
+
+    /** Returns the most recently published copy of the buffer's contents.
+
+        This can be called from any thread, never copies the data and never locks or
+        allocates. The first call turns on publishing from updateListeners() so this
+        will return nullptr until either that or publishSnapshot() has been called.
+    */
+    SnapshotPtr snapshot() const
+    {
+        snapshotsRequested = true;
+
+        for (;;)
+        {
+            const int index = latestSnapshotIndex.load();
+
+            if (index < 0)
+                return SnapshotPtr();
+
+            // the writer never fills in the latest snapshot, so once we're counted as a
+            // reader and it is still the latest it can't be reused until we release it
+            const Snapshot& latest = snapshots[index];
+            latest.numReaders.fetch_add (1);
+
+            if (latestSnapshotIndex.load() == index)
+                return SnapshotPtr (&latest);
+
+            latest.numReaders.fetch_sub (1);
+        }
+    }
+
     //==============================================================================
     /** Receives callbacks when a Buffer object changes.
 
@@ -196,11 +399,23 @@ public:
 
 private:
     //==============================================================================
-    HeapBlock<float> buffer;
+    HeapBlock<char> storage;
+    float* buffer;
     size_t bufferSize;
 
     ListenerList<Listener> listeners;
 
+    enum { numSnapshots = 4 };
+    Snapshot snapshots[numSnapshots];
+    std::atomic<int> latestSnapshotIndex;
+    mutable std::atomic<bool> snapshotsRequested;
+
+    static float* allocateAligned (HeapBlock<char>& block, size_t numElements, bool clearMemory)
+    {
+        block.allocate (numElements * sizeof (float) + alignment - 1, clearMemory);
+        return reinterpret_cast<float*> (snapPointerToAlignment (block.getData(), (size_t) alignment));
+    }
+
     JUCE_LEAK_DETECTOR (Buffer)
 };
 
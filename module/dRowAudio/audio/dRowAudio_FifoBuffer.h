@@ -32,6 +32,8 @@
 #ifndef DROWAUDIO_FIFOBUFFER_H
 #define DROWAUDIO_FIFOBUFFER_H
 
+#include "../utility/dRowAudio_RealtimeSafetyChecker.h"
+
 /** This is a simple implementation of a lock free Fifo buffer that uses
     a template parameter for the sample type. This should be a primitive type
     that is capable of being copied using only memcpy.
@@ -59,6 +61,7 @@ public:
     /** Returns the number of samples in the buffer. */
     inline int getNumAvailable() const
     {
+        checkRealtimeLock();
         const ScopedLockType sl (lock);
         return abstractFifo.getNumReady();
     }
@@ -66,6 +69,7 @@ public:
     /** Returns the number of items free in the buffer. */
     inline int getNumFree() const
     {
+        checkRealtimeLock();
         const ScopedLockType sl (lock);
         return abstractFifo.getFreeSpace();
     }
@@ -77,6 +81,7 @@ public:
     */
     inline void setSize (int newSize)
     {
+        checkRealtimeLock();
         const ScopedLockType sl (lock);
         abstractFifo.setTotalSize (newSize);
         buffer.malloc (abstractFifo.getTotalSize());
@@ -90,6 +95,7 @@ public:
     */
     inline void setSizeKeepingExisting (int newSize)
     {
+        checkRealtimeLock();
         const ScopedLockType sl (lock);
 
         const int numUsed = abstractFifo.getNumReady();
@@ -102,12 +108,14 @@ public:
     /** Returns the size of the buffer. */
     inline int getSize() const
     {
+        checkRealtimeLock();
         const ScopedLockType sl (lock);
         return abstractFifo.getTotalSize();
     }
 
     inline void reset()
     {
+        checkRealtimeLock();
         const ScopedLockType sl (lock);
         abstractFifo.reset();
     }
@@ -115,6 +123,7 @@ public:
     /** Writes a number of samples into the buffer. */
     void writeSamples (const ElementType* samples, int numSamples)
     {
+        checkRealtimeLock();
         const ScopedLockType sl (lock);
 
         int start1, size1, start2, size2;
@@ -132,6 +141,7 @@ public:
     /** Reads a number of samples from the buffer into the array provided. */
     void readSamples (ElementType* bufferToFill, int numSamples)
     {
+        checkRealtimeLock();
         const ScopedLockType sl (lock);
 
         int start1, size1, start2, size2;
@@ -149,6 +159,7 @@ public:
     /** Removes a number of samples from the buffer. */
     void removeSamples (int numSamples)
     {
+        checkRealtimeLock();
         const ScopedLockType sl (lock);
         abstractFifo.finishedRead (numSamples);
     }
@@ -177,6 +188,12 @@ private:
     HeapBlock<ElementType> buffer;
     TypeOfCriticalSectionToUse lock;
 
+    static inline void checkRealtimeLock() noexcept
+    {
+        if (! std::is_same<TypeOfCriticalSectionToUse, DummyCriticalSection>::value)
+            DROWAUDIO_CHECK_REALTIME_LOCK ("FifoBuffer");
+    }
+
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FifoBuffer)
 };
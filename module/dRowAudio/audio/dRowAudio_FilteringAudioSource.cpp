@@ -65,36 +65,11 @@ FilteringAudioSource::~FilteringAudioSource()
 //==============================================================================
 void FilteringAudioSource::setGain (FilterType setting, float newGain)
 {
-    switch (setting)
-    {
-        case Low:
-        {
-            gains[Low] = newGain;
-            const IIRCoefficients lowCoeff (IIRCoefficients::makeLowShelf       (sampleRate, defaultSettings[Low][CF], defaultSettings[Low][Q], gains[Low]));
-            filter[0][Low].setCoefficients (lowCoeff);
-            filter[1][Low].setCoefficients (lowCoeff);
-            break;
-        }
-        case Mid:
-        {
-            gains[Mid] = newGain;
-            const IIRCoefficients midCoeff (IIRCoefficients::makePeakFilter     (sampleRate, defaultSettings[Mid][CF], defaultSettings[Mid][Q], gains[Mid]));
-            filter[0][Mid].setCoefficients (midCoeff);
-            filter[1][Mid].setCoefficients (midCoeff);
-            break;
-        }
-        case High:
-        {
-            gains[High] = newGain;
-            const IIRCoefficients highCoeff (IIRCoefficients::makeHighShelf     (sampleRate, defaultSettings[High][CF], defaultSettings[High][Q], gains[High]));
-            filter[0][High].setCoefficients (highCoeff);
-            filter[1][High].setCoefficients (highCoeff);
-            break;
-        }
-        case numFilters:
-        default:
-            break;
-    }
+    if (! isPositiveAndBelow ((int) setting, (int) numFilters))
+        return;
+
+    gains[setting] = newGain;
+    updateCoefficients();
 }
 
 void FilteringAudioSource::setFilterSource (bool shouldFilter)
@@ -121,8 +96,23 @@ void FilteringAudioSource::releaseResources()
 
 void FilteringAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
+    DROWAUDIO_TIME_PROCESS (processTimeHistogram)
+
     input->getNextAudioBlock (info);
 
+    // the filters are only ever set from here so they all pick up new gains together
+    if (eqCoefficients.update())
+    {
+        for (int f = 0; f < numFilters; ++f)
+        {
+            IIRCoefficients coefficients;
+            memcpy (coefficients.coefficients, eqCoefficients.get().coefficients[f], sizeof (coefficients.coefficients));
+
+            filter[0][f].setCoefficients (coefficients);
+            filter[1][f].setCoefficients (coefficients);
+        }
+    }
+
     if (filterSource && info.buffer->getNumChannels() > 0)
     {
         const int bufferNumSamples = info.numSamples;
@@ -145,14 +135,28 @@ void FilteringAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info
 
 void FilteringAudioSource::resetFilters()
 {
-    const IIRCoefficients lowCoeff (IIRCoefficients::makeLowShelf (sampleRate, defaultSettings[Low][CF], defaultSettings[Low][Q], gains[Low]));
-    const IIRCoefficients midCoeff (IIRCoefficients::makePeakFilter (sampleRate, defaultSettings[Mid][CF], defaultSettings[Mid][Q], gains[Mid]));
-    const IIRCoefficients highCoeff (IIRCoefficients::makeHighShelf (sampleRate, defaultSettings[High][CF], defaultSettings[High][Q], gains[High]));
-
-    filter[0][Low].setCoefficients (lowCoeff);
-    filter[1][Low].setCoefficients (lowCoeff);
-    filter[0][Mid].setCoefficients (midCoeff);
-    filter[1][Mid].setCoefficients (midCoeff);
-    filter[0][High].setCoefficients (highCoeff);
-    filter[1][High].setCoefficients (highCoeff);
+    updateCoefficients();
+
+    for (int f = 0; f < numFilters; ++f)
+    {
+        filter[0][f].reset();
+        filter[1][f].reset();
+    }
+}
+
+void FilteringAudioSource::updateCoefficients()
+{
+    const IIRCoefficients coefficients[numFilters] =
+    {
+        IIRCoefficients::makeLowShelf (sampleRate, defaultSettings[Low][CF], defaultSettings[Low][Q], gains[Low]),
+        IIRCoefficients::makePeakFilter (sampleRate, defaultSettings[Mid][CF], defaultSettings[Mid][Q], gains[Mid]),
+        IIRCoefficients::makeHighShelf (sampleRate, defaultSettings[High][CF], defaultSettings[High][Q], gains[High])
+    };
+
+    EqCoefficients newCoefficients;
+
+    for (int f = 0; f < numFilters; ++f)
+        memcpy (newCoefficients.coefficients[f], coefficients[f].coefficients, sizeof (newCoefficients.coefficients[f]));
+
+    eqCoefficients.set (newCoefficients);
 }
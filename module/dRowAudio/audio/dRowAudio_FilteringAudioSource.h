@@ -32,7 +32,16 @@
 #ifndef DROWAUDIO_FILTERINGAUDIOSOURCE_H
 #define DROWAUDIO_FILTERINGAUDIOSOURCE_H
 
-/** An AudioSource that contains three settable filters to EQ the audio stream. */
+#include "dRowAudio_ProcessTimeHistogram.h"
+#include "filters/dRowAudio_BiquadFilter.h"
+
+/** An AudioSource that contains three settable filters to EQ the audio stream.
+
+    The gains can be changed from any thread while the source is playing. All
+    three bands are published together and swapped in at the start of the next
+    block, so both channels always change at the same sample and the audio thread
+    never waits on a lock.
+ */
 class FilteringAudioSource : public AudioSource
 {
 public:
@@ -70,6 +79,11 @@ public:
     /** Returns whether the source is being filtered or not. */
     bool getFilterSource() const { return filterSource; }
 
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    /** Returns the times spent in getNextAudioBlock, including the time taken by the input source. */
+    const ProcessTimeHistogram& getProcessTimeHistogram() const noexcept { return processTimeHistogram; }
+   #endif
+
     //==============================================================================
     /** @internal */
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
@@ -80,15 +94,25 @@ public:
 
 private:
     //==============================================================================
+    struct EqCoefficients
+    {
+        float coefficients[numFilters][5];
+    };
+
     OptionalScopedPointer<AudioSource> input;
     float gains[numFilters];
-    IIRFilter filter[2][numFilters];
+    DoubleBufferedValue<EqCoefficients> eqCoefficients;
+    BiquadFilter filter[2][numFilters];
 
     double sampleRate;
     bool filterSource;
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    ProcessTimeHistogram processTimeHistogram;
+   #endif
 
     //==============================================================================
     void resetFilters();
+    void updateCoefficients();
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (FilteringAudioSource)
@@ -35,9 +35,10 @@
 LoopingAudioSource::LoopingAudioSource (PositionableAudioSource* const inputSource,
                                         const bool deleteInputWhenDeleted)
     : input (inputSource, deleteInputWhenDeleted),
+      loopPoints (LoopPoints()),
       isLoopingBetweenTimes (false),
-      loopStartSample (0),
-      loopEndSample (0),
+      currentSampleRate (44100.0),
+      audioThreadId (nullptr),
       tempBuffer (2, 512)
 {
     jassert (inputSource != nullptr);
@@ -52,15 +53,7 @@ void LoopingAudioSource::setLoopTimes (double startTime, double endTime)
 {
     jassert (endTime > startTime); // end time has to be after start!
 
-    {
-        const ScopedLock sl (loopPosLock);
-
-        loopStartTime = startTime;
-        loopEndTime = endTime;
-
-        loopStartSample = (int64) (startTime * currentSampleRate);
-        loopEndSample = (int64) (endTime * currentSampleRate);
-    }
+    publishLoopPoints (startTime, endTime);
 
     // need to update read position based on new limits
     setNextReadPosition (getNextReadPosition());
@@ -68,8 +61,9 @@ void LoopingAudioSource::setLoopTimes (double startTime, double endTime)
 
 void LoopingAudioSource::getLoopTimes (double& startTime, double& endTime)
 {
-    startTime = loopStartTime;
-    endTime =loopEndTime;
+    const LoopPoints points (loopPoints.getLatest());
+    startTime = points.startTime;
+    endTime = points.endTime;
 }
 
 void LoopingAudioSource::setLoopBetweenTimes (bool shouldLoop)
@@ -84,6 +78,10 @@ void LoopingAudioSource::prepareToPlay (int samplesPerBlockExpected,
     currentSampleRate = sampleRate;
     input->prepareToPlay (samplesPerBlockExpected, sampleRate);
 
+    // the loop samples depend on the sample rate
+    const LoopPoints points (loopPoints.getLatest());
+    publishLoopPoints (points.startTime, points.endTime);
+
     if (tempBuffer.getNumSamples() < samplesPerBlockExpected)
     {
         tempBuffer.setSize (2, samplesPerBlockExpected);
@@ -98,12 +96,20 @@ void LoopingAudioSource::releaseResources()
 
 void LoopingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
+    DROWAUDIO_TIME_PROCESS (processTimeHistogram)
+
+    audioThreadId.store (Thread::getCurrentThreadId(), std::memory_order_relaxed);
+
     if (info.numSamples > 0)
     {
-        if (isLoopingBetweenTimes)
-        {
-            const ScopedLock sl (loopPosLock);
+        // any new loop times are picked up here, between blocks
+        loopPoints.update();
+        const LoopPoints& points = loopPoints.get();
+        const int64 loopStartSample = points.startSample;
+        const int64 loopEndSample = points.endSample;
 
+        if (isLoopingBetweenTimes.load() && loopEndSample > loopStartSample)
+        {
             const int64 newStart = getNextReadPosition();
             int64 newEnd = loopStartSample + ((newStart + info.numSamples) % loopEndSample);
 
@@ -144,9 +150,26 @@ void LoopingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 //==============================================================================
 void LoopingAudioSource::setNextReadPosition (int64 newPosition)
 {
-    const ScopedLock sl (loopPosLock);
+    // a source above this one, e.g. a ReversibleAudioSource, may reposition it on the
+    // audio thread which must use its own copy rather than wait for a control thread
+    if (Thread::getCurrentThreadId() == audioThreadId.load (std::memory_order_relaxed))
+    {
+        loopPoints.update();
+        setNextReadPositionWithinLoop (newPosition, loopPoints.get());
+    }
+    else
+    {
+        setNextReadPositionWithinLoop (newPosition, loopPoints.getLatest());
+    }
+}
+
+void LoopingAudioSource::setNextReadPositionWithinLoop (int64 newPosition, const LoopPoints& points)
+{
+    const int64 loopStartSample = points.startSample;
+    const int64 loopEndSample = points.endSample;
 
-    if (isLoopingBetweenTimes
+    if (isLoopingBetweenTimes.load()
+        && loopEndSample > loopStartSample
         && getNextReadPosition() > loopStartSample
         && getNextReadPosition() < loopEndSample)
     {
@@ -180,3 +203,17 @@ bool LoopingAudioSource::isLooping() const
 {
     return input->isLooping();
 }
+
+//==============================================================================
+void LoopingAudioSource::publishLoopPoints (double startTime, double endTime)
+{
+    const double sampleRate = currentSampleRate.load();
+
+    LoopPoints points;
+    points.startTime = startTime;
+    points.endTime = endTime;
+    points.startSample = (int64) (startTime * sampleRate);
+    points.endSample = (int64) (endTime * sampleRate);
+
+    loopPoints.set (points);
+}
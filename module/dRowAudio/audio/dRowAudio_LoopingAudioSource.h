@@ -33,10 +33,16 @@
 #define DROWAUDIO_LOOPINGAUDIOSOURCE_H
 
 #include "../utility/dRowAudio_Utility.h"
+#include "dRowAudio_ProcessTimeHistogram.h"
+#include "../utility/dRowAudio_DoubleBufferedValue.h"
 
 /** A type of PositionalAudioSource that will read from a PositionableAudioSource
     and can loop between to set times.
 
+    The loop times are handed to the audio thread without locking so they can be
+    changed whilst playing. The audio thread, including a source above this one
+    repositioning it, never waits for them.
+
     @see PositionableAudioSource, AudioTransportSource, BufferingAudioSource
 */
 class LoopingAudioSource : public PositionableAudioSource
@@ -66,12 +72,17 @@ public:
     void setLoopBetweenTimes (bool shouldLoop);
 
     /** Returns true if the loop is activated. */
-    bool isBetweenLoopTimes() const { return isLoopingBetweenTimes; }
+    bool isBetweenLoopTimes() const { return isLoopingBetweenTimes.load(); }
 
     //==============================================================================
     /** Sets the next read position ignoring the loop bounds. */
     void setNextReadPositionIgnoringLoop (int64 newPosition);
 
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    /** Returns the times spent in getNextAudioBlock, including the time taken by the input source. */
+    const ProcessTimeHistogram& getProcessTimeHistogram() const noexcept { return processTimeHistogram; }
+   #endif
+
     //==============================================================================
     /** @internal */
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
@@ -90,16 +101,27 @@ public:
 
 private:
     //==============================================================================
-    OptionalScopedPointer<PositionableAudioSource> input;
-    CriticalSection loopPosLock;
+    struct LoopPoints
+    {
+        double startTime, endTime;
+        int64 startSample, endSample;
+    };
 
-    volatile bool isLoopingBetweenTimes;
-    double loopStartTime, loopEndTime;
-    int64 loopStartSample, loopEndSample;
-    double currentSampleRate;
+    OptionalScopedPointer<PositionableAudioSource> input;
+    DoubleBufferedValue<LoopPoints> loopPoints;
+    std::atomic<bool> isLoopingBetweenTimes;
+    std::atomic<double> currentSampleRate;
+    std::atomic<Thread::ThreadID> audioThreadId;
 
     AudioSourceChannelInfo tempInfo;
     AudioSampleBuffer tempBuffer;
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    ProcessTimeHistogram processTimeHistogram;
+   #endif
+
+    //==============================================================================
+    void publishLoopPoints (double startTime, double endTime);
+    void setNextReadPositionWithinLoop (int64 newPosition, const LoopPoints& points);
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (LoopingAudioSource)
@@ -0,0 +1,299 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+namespace OversamplerHelpers
+{
+    /** The zeroth order modified Bessel function of the first kind, used by the
+        Kaiser window.
+     */
+    static double besselI0 (double x) noexcept
+    {
+        double sum = 1.0, term = 1.0;
+
+        for (int k = 1; k < 50 && term > 1.0e-12 * sum; ++k)
+        {
+            const double halfXOverK = 0.5 * x / k;
+            term *= halfXOverK * halfXOverK;
+            sum += term;
+        }
+
+        return sum;
+    }
+
+    /** Returns the Kaiser window beta for a given stopband attenuation. */
+    static double getKaiserBeta (double stopbandDb) noexcept
+    {
+        if (stopbandDb > 50.0)
+            return 0.1102 * (stopbandDb - 8.7);
+
+        if (stopbandDb > 21.0)
+            return 0.5842 * std::pow (stopbandDb - 21.0, 0.4) + 0.07886 * (stopbandDb - 21.0);
+
+        return 0.0;
+    }
+}
+
+//==============================================================================
+/** One doubling of the sample rate.
+
+    A half-band filter of 4M - 1 taps has its centre tap at c = 2M - 1 equal to
+    0.5 and every other tap an even distance from the centre equal to zero. So
+    when upsampling, the odd output samples are just the input delayed by M - 1
+    and the even ones a 2M tap filter of the input. When downsampling, the output
+    is the same 2M tap filter of the even input samples plus half of the odd ones
+    delayed by M. Both directions only ever run at the lower rate.
+ */
+class Oversampler::Stage
+{
+public:
+    Stage (int numChannels_, double transitionWidth, double stopbandDb)
+        : numChannels (numChannels_)
+    {
+        using namespace OversamplerHelpers;
+
+        // Kaiser's estimate of the length, rounded up to the next 4M - 1
+        const int estimatedLength = (int) std::ceil ((stopbandDb - 7.95) / (14.36 * transitionWidth)) + 1;
+        halfLength = jmax (2, (estimatedLength + 4) / 4);
+
+        const int numTaps = 2 * halfLength;
+        const int centre = 2 * halfLength - 1;
+        const double beta = getKaiserBeta (stopbandDb);
+        const double i0Beta = besselI0 (beta);
+
+        HeapBlock<double> phase ((size_t) numTaps);
+        double sum = 0.0;
+
+        for (int k = 0; k < numTaps; ++k)
+        {
+            const int distance = 2 * k - centre;   // always odd
+            const double ratio = distance / (double) centre;
+            const double window = besselI0 (beta * std::sqrt (jmax (0.0, 1.0 - ratio * ratio))) / i0Beta;
+            const double sinc = std::sin (MathConstants<double>::pi * distance * 0.5) / (MathConstants<double>::pi * distance);
+
+            phase[k] = sinc * window;
+            sum += phase[k];
+        }
+
+        // with the centre tap of 0.5 the filter has unity gain at DC
+        downTaps.malloc ((size_t) numTaps);
+        upTaps.malloc ((size_t) numTaps);
+
+        for (int k = 0; k < numTaps; ++k)
+        {
+            downTaps[k] = (float) (0.5 * phase[k] / sum);
+            upTaps[k] = 2.0f * downTaps[k];
+        }
+    }
+
+    int getNumTaps() const noexcept         { return 4 * halfLength - 1; }
+
+    /** The delay in samples at the higher rate of going up and then down again. */
+    int getLatency() const noexcept         { return 2 * (2 * halfLength - 1); }
+
+    void prepare (int maxNumInputSamples)
+    {
+        const int history = getHistorySize();
+
+        upHistory.setSize (numChannels, history + maxNumInputSamples);
+        evenHistory.setSize (numChannels, history + maxNumInputSamples);
+        oddHistory.setSize (numChannels, halfLength + maxNumInputSamples);
+        scratch.malloc ((size_t) maxNumInputSamples);
+
+        reset();
+    }
+
+    void reset() noexcept
+    {
+        upHistory.clear();
+        evenHistory.clear();
+        oddHistory.clear();
+    }
+
+    void processUp (int channel, const float* input, float* output, int numSamples) noexcept
+    {
+        const int history = getHistorySize();
+        const int numTaps = 2 * halfLength;
+        float* const x = upHistory.getWritePointer (channel) + history;
+
+        FloatVectorOperations::copy (x, input, numSamples);
+        FloatVectorOperations::copyWithMultiply (scratch, x, upTaps[0], numSamples);
+
+        for (int k = 1; k < numTaps; ++k)
+            FloatVectorOperations::addWithMultiply (scratch, x - k, upTaps[k], numSamples);
+
+        const float* const delayed = x - (halfLength - 1);
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            output[2 * i]     = scratch[i];
+            output[2 * i + 1] = delayed[i];
+        }
+
+        memmove (x - history, x - history + numSamples, sizeof (float) * (size_t) history);
+    }
+
+    void processDown (int channel, const float* input, float* output, int numSamples) noexcept
+    {
+        const int history = getHistorySize();
+        const int numTaps = 2 * halfLength;
+        float* const even = evenHistory.getWritePointer (channel) + history;
+        float* const odd = oddHistory.getWritePointer (channel) + halfLength;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            even[i] = input[2 * i];
+            odd[i]  = input[2 * i + 1];
+        }
+
+        FloatVectorOperations::copyWithMultiply (output, odd - halfLength, 0.5f, numSamples);
+
+        for (int k = 0; k < numTaps; ++k)
+            FloatVectorOperations::addWithMultiply (output, even - k, downTaps[k], numSamples);
+
+        memmove (even - history, even - history + numSamples, sizeof (float) * (size_t) history);
+        memmove (odd - halfLength, odd - halfLength + numSamples, sizeof (float) * (size_t) halfLength);
+    }
+
+private:
+    const int numChannels;
+    int halfLength;
+    HeapBlock<float> upTaps, downTaps, scratch;
+    AudioSampleBuffer upHistory, evenHistory, oddHistory;
+
+    int getHistorySize() const noexcept     { return 2 * halfLength - 1; }
+
+    JUCE_DECLARE_NON_COPYABLE (Stage)
+};
+
+//==============================================================================
+Oversampler::Oversampler (int numChannels_, int numStages, double stopbandDb, double passbandFraction)
+    : numChannels (jmax (1, numChannels_))
+{
+    jassert (numStages >= 1 && numStages <= 3);
+    jassert (passbandFraction > 0.0 && passbandFraction < 1.0);
+
+    numStages = jlimit (1, 3, numStages);
+    passbandFraction = jlimit (0.1, 0.99, passbandFraction);
+
+    // the passband edge as a fraction of the original rate, each stage has to keep
+    // this and reject its image, which is a narrower gap the lower the stage's rate
+    const double passbandEdge = 0.5 * passbandFraction;
+
+    for (int s = 0; s < numStages; ++s)
+    {
+        const double transitionWidth = 0.5 - passbandEdge / (1 << s);
+        stages.add (new Stage (numChannels, transitionWidth, stopbandDb));
+        stageBuffers.add (new AudioSampleBuffer (numChannels, 0));
+    }
+}
+
+Oversampler::~Oversampler()
+{
+}
+
+//==============================================================================
+void Oversampler::prepare (int maximumBlockSize)
+{
+    for (int s = 0; s < stages.size(); ++s)
+    {
+        stages.getUnchecked (s)->prepare (maximumBlockSize << s);
+        stageBuffers.getUnchecked (s)->setSize (numChannels, maximumBlockSize << (s + 1));
+    }
+}
+
+void Oversampler::reset() noexcept
+{
+    for (auto* stage : stages)
+        stage->reset();
+}
+
+//==============================================================================
+int Oversampler::getNumTaps (int stageIndex) const noexcept
+{
+    if (Stage* stage = stages[stageIndex])
+        return stage->getNumTaps();
+
+    return 0;
+}
+
+double Oversampler::getLatencyInSamples() const noexcept
+{
+    // each stage's latency is at twice the rate of its input
+    double latency = 0.0;
+
+    for (int s = 0; s < stages.size(); ++s)
+        latency += stages.getUnchecked (s)->getLatency() / (double) (2 << s);
+
+    return latency;
+}
+
+//==============================================================================
+float** Oversampler::processSamplesUp (const float* const* inputChannelData, int numSamples) noexcept
+{
+    DROWAUDIO_TRACE_SCOPE ("Oversampler::processSamplesUp")
+
+    jassert (numSamples * getFactor() <= stageBuffers.getLast()->getNumSamples());
+
+    for (int s = 0; s < stages.size(); ++s)
+    {
+        Stage& stage = *stages.getUnchecked (s);
+        AudioSampleBuffer& output = *stageBuffers.getUnchecked (s);
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            const float* input = s == 0 ? inputChannelData[c]
+                                        : stageBuffers.getUnchecked (s - 1)->getReadPointer (c);
+
+            stage.processUp (c, input, output.getWritePointer (c), numSamples << s);
+        }
+    }
+
+    return stageBuffers.getLast()->getArrayOfWritePointers();
+}
+
+void Oversampler::processSamplesDown (float* const* outputChannelData, int numSamples) noexcept
+{
+    DROWAUDIO_TRACE_SCOPE ("Oversampler::processSamplesDown")
+
+    for (int s = stages.size(); --s >= 0;)
+    {
+        Stage& stage = *stages.getUnchecked (s);
+        const AudioSampleBuffer& input = *stageBuffers.getUnchecked (s);
+
+        for (int c = 0; c < numChannels; ++c)
+        {
+            float* output = s == 0 ? outputChannelData[c]
+                                   : stageBuffers.getUnchecked (s - 1)->getWritePointer (c);
+
+            stage.processDown (c, input.getReadPointer (c), output, numSamples << s);
+        }
+    }
+}
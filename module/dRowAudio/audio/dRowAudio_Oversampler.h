@@ -0,0 +1,153 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_OVERSAMPLER_H
+#define DROWAUDIO_OVERSAMPLER_H
+
+//==============================================================================
+/** Oversamples a block of audio by 2, 4 or 8 times so it can be processed at a
+    higher rate and brought back down again.
+
+    This is useful for non-linear processing such as waveshaping with a BezierCurve
+    which would otherwise alias, or for finding the true peaks of a signal.
+
+    Each doubling is a separate stage using a linear phase half-band FIR filter.
+    Half of a half-band filter's taps are zero and the other phase is a single
+    tap, so each stage is run in polyphase form at the lower of its two rates,
+    with each remaining tap applied across the whole block with the
+    FloatVectorOperations SIMD routines. The first stage, which has to separate the
+    audio band from its image, uses the longest filter; the following stages only
+    need to reject images an octave or more away so are much shorter.
+
+    The filters add a fixed latency, see getLatencyInSamples().
+
+    @code
+        Oversampler oversampler (2, 2);    // stereo, 4x
+        oversampler.prepare (512);
+
+        // in the audio callback
+        oversampler.process (channelData, numSamples, [] (float** data, int numChannels, int num)
+        {
+            for (int c = 0; c < numChannels; ++c)
+                for (int i = 0; i < num; ++i)
+                    data[c][i] = std::tanh (3.0f * data[c][i]);
+        });
+    @endcode
+
+    @see SampleRateConverter
+ */
+class Oversampler
+{
+public:
+    //==============================================================================
+    /** Creates an Oversampler.
+
+        @param numChannels      the number of channels that will be processed
+        @param numStages        the number of doublings, 1 to 3 for 2x, 4x or 8x
+        @param stopbandDb       the attenuation of images and aliases in decibels
+        @param passbandFraction how much of the original band, up to its Nyquist
+                                frequency, should be left untouched. The first stage's
+                                filter gets longer as this approaches 1.
+     */
+    Oversampler (int numChannels, int numStages,
+                 double stopbandDb = 100.0, double passbandFraction = 0.9);
+
+    /** Destructor. */
+    ~Oversampler();
+
+    //==============================================================================
+    /** Allocates the buffers needed for blocks of up to a given size.
+        This should be called before processing, but not on the audio thread.
+     */
+    void prepare (int maximumBlockSize);
+
+    /** Clears the filter states. */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Returns the oversampling factor, 2, 4 or 8. */
+    int getFactor() const noexcept                      { return 1 << stages.size(); }
+
+    /** Returns the number of channels. */
+    int getNumChannels() const noexcept                 { return numChannels; }
+
+    /** Returns the number of stages. */
+    int getNumStages() const noexcept                   { return stages.size(); }
+
+    /** Returns the number of taps in the filter used by a stage. */
+    int getNumTaps (int stageIndex) const noexcept;
+
+    /** Returns the delay added by going up and back down, at the original rate.
+        This can be a fraction of a sample.
+     */
+    double getLatencyInSamples() const noexcept;
+
+    //==============================================================================
+    /** Upsamples a block of samples.
+
+        Returns the oversampled channels, each getFactor() times numSamples long.
+        These can be processed in place and then passed back down with
+        processSamplesDown(). numSamples must not exceed the size given to prepare().
+     */
+    float** processSamplesUp (const float* const* inputChannelData, int numSamples) noexcept;
+
+    /** Downsamples the block last returned by processSamplesUp().
+        numSamples is the number of samples at the original rate.
+     */
+    void processSamplesDown (float* const* outputChannelData, int numSamples) noexcept;
+
+    /** Upsamples a block, calls a function to process it and then downsamples it
+        back in place.
+
+        The function is called with the oversampled channels, the number of channels
+        and the number of oversampled samples, i.e. (float**, int, int).
+     */
+    template <typename ProcessFunction>
+    void process (float* const* channelData, int numSamples, ProcessFunction&& processFunction)
+    {
+        float** const oversampled = processSamplesUp (channelData, numSamples);
+        processFunction (oversampled, numChannels, numSamples * getFactor());
+        processSamplesDown (channelData, numSamples);
+    }
+
+private:
+    //==============================================================================
+    class Stage;
+
+    const int numChannels;
+    OwnedArray<Stage> stages;
+    OwnedArray<AudioSampleBuffer> stageBuffers;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Oversampler)
+};
+
+#endif   // DROWAUDIO_OVERSAMPLER_H
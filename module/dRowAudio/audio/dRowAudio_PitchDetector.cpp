@@ -36,7 +36,6 @@ PitchDetector::PitchDetector()
       minFrequency          (50), maxFrequency (1600),
       buffer1               (512), buffer2 (512),
       numSamplesNeededForDetection (int ((sampleRate / minFrequency) * 2)),
-      currentBlockBuffer    ((size_t) numSamplesNeededForDetection),
       inputFifoBuffer       (numSamplesNeededForDetection * 2),
       mostRecentPitch       (0.0)
 {
@@ -46,61 +45,74 @@ PitchDetector::PitchDetector()
 //==============================================================================
 void PitchDetector::processSamples (const float* samples, int numSamples) noexcept
 {
-    if (inputFifoBuffer.getNumFree() < numSamples)
-        inputFifoBuffer.setSizeKeepingExisting (inputFifoBuffer.getSize() * 2);
+    scratchArena.reset();
+    float* const blockSamples = scratchArena.allocate<float> ((size_t) numSamplesNeededForDetection);
 
-    inputFifoBuffer.writeSamples (samples, numSamples);
-
-    while (inputFifoBuffer.getNumAvailable() >= numSamplesNeededForDetection)
+    // the fifo holds two detection blocks so rather than growing it large
+    // inputs are written a section at a time, detecting as it fills
+    while (numSamples > 0)
     {
-        inputFifoBuffer.readSamples (currentBlockBuffer.getData(), (int) currentBlockBuffer.getSize());
-        mostRecentPitch = detectPitchForBlock (currentBlockBuffer.getData(), (int) currentBlockBuffer.getSize());
+        const int numToWrite = jmin (numSamples, inputFifoBuffer.getNumFree());
+        inputFifoBuffer.writeSamples (samples, numToWrite);
+
+        samples += numToWrite;
+        numSamples -= numToWrite;
+
+        while (inputFifoBuffer.getNumAvailable() >= numSamplesNeededForDetection)
+        {
+            inputFifoBuffer.readSamples (blockSamples, numSamplesNeededForDetection);
+            mostRecentPitch = detectPitchForBlock (blockSamples, numSamplesNeededForDetection);
+        }
     }
 }
 
 //==============================================================================
 double PitchDetector::detectPitch (float* samples, int numSamples) noexcept
 {
-    Array<double> pitches;
-    pitches.ensureStorageAllocated (int (numSamples / numSamplesNeededForDetection));
+    const size_t maxNumPitches = (size_t) jmax (1, numSamples / numSamplesNeededForDetection);
+
+    scratchArena.ensureSize (2 * ScratchArena::getRequiredSize<double> (maxNumPitches));
+    scratchArena.reset();
+
+    double* const pitches = scratchArena.allocate<double> (maxNumPitches);
+    int numPitches = 0;
 
     while (numSamples >= numSamplesNeededForDetection)
     {
         double pitch = detectPitchForBlock (samples, numSamplesNeededForDetection);//0.0;
 
         if (pitch > 0.0)
-            pitches.add (pitch);
+            pitches[numPitches++] = pitch;
 
         numSamples -= numSamplesNeededForDetection;
         samples += numSamplesNeededForDetection;
     }
 
-    if (pitches.size() == 1)
+    if (numPitches == 1)
         return pitches[0];
 
-    if (pitches.size() > 1)
+    if (numPitches > 1)
     {
-        DefaultElementComparator<double> sorter;
-        pitches.sort (sorter);
+        std::sort (pitches, pitches + numPitches);
 
-        const double stdDev = findStandardDeviation (pitches.getRawDataPointer(), pitches.size());
-        const double medianSample = findMedian (pitches.getRawDataPointer(), pitches.size());
+        const double stdDev = findStandardDeviation (pitches, numPitches);
+        const double medianSample = findMedian (pitches, numPitches);
         const double lowerLimit = medianSample - stdDev;
         const double upperLimit = medianSample + stdDev;
 
-        Array<double> correctedPitches;
-        correctedPitches.ensureStorageAllocated (pitches.size());
+        double* const correctedPitches = scratchArena.allocate<double> ((size_t) numPitches);
+        int numCorrectedPitches = 0;
 
-        for (int i = 0; i < pitches.size(); ++i)
+        for (int i = 0; i < numPitches; ++i)
         {
-            const double pitch = pitches.getUnchecked (i);
+            const double pitch = pitches[i];
 
             if (pitch >= lowerLimit && pitch <= upperLimit)
-                correctedPitches.add (pitch);
+                correctedPitches[numCorrectedPitches++] = pitch;
         }
 
         //Final pitch:
-        return findMean (correctedPitches.getRawDataPointer(), correctedPitches.size());
+        return findMean (correctedPitches, numCorrectedPitches);
     }
 
     return 0.0;
@@ -148,7 +160,7 @@ void PitchDetector::updateFiltersAndBlockSizes()
     numSamplesNeededForDetection = int (sampleRate / minFrequency) * 2;
 
     inputFifoBuffer.setSizeKeepingExisting (numSamplesNeededForDetection * 2);
-    currentBlockBuffer.setSize (size_t (numSamplesNeededForDetection));
+    scratchArena.setSize (ScratchArena::getRequiredSize<float> ((size_t) numSamplesNeededForDetection));
 
     buffer1.setSizeQuick (size_t (numSamplesNeededForDetection));
     buffer2.setSizeQuick (size_t (numSamplesNeededForDetection));
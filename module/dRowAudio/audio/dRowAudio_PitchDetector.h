@@ -34,6 +34,7 @@
 
 #include "dRowAudio_Buffer.h"
 #include "dRowAudio_FifoBuffer.h"
+#include "dRowAudio_ScratchArena.h"
 
 /** Auto correlation based pitch detector class.
 
@@ -96,6 +97,9 @@ public:
         in conjunction with some other splicing techniques such as onset detection
         for finding the frequency of whole notes.
 
+        The working space for the averaging is taken from an internal arena which
+        is only reallocated if a longer block is passed in than before.
+
         Note that the sample array passed in is not marked const and will alter the
         samples. Be sure to pass in a copy if this is undesireable.
     */
@@ -154,8 +158,8 @@ private:
 
     IIRFilter highFilter, lowFilter;
     int numSamplesNeededForDetection;
-    Buffer currentBlockBuffer;
     FifoBuffer<float> inputFifoBuffer;
+    ScratchArena scratchArena;
     double mostRecentPitch;
 
     //==============================================================================
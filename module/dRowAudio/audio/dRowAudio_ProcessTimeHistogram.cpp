@@ -0,0 +1,150 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#if DROWAUDIO_USE_PROCESS_TIMING
+
+ProcessTimeHistogram::ProcessTimeHistogram() noexcept
+    : resetPending (false)
+{
+    clear();
+}
+
+//==============================================================================
+void ProcessTimeHistogram::record (int64 nanoseconds) noexcept
+{
+    if (resetPending.exchange (false, std::memory_order_acquire))
+        clear();
+
+    counts[getBinIndex (nanoseconds)].fetch_add (1, std::memory_order_relaxed);
+    totalNanoseconds.fetch_add (nanoseconds, std::memory_order_relaxed);
+
+    // only one thread ever writes so a load and store is safe here
+    if (nanoseconds > maxNanoseconds.load (std::memory_order_relaxed))
+        maxNanoseconds.store (nanoseconds, std::memory_order_relaxed);
+
+    numCalls.fetch_add (1, std::memory_order_release);
+}
+
+void ProcessTimeHistogram::recordTicksSince (int64 startTicks) noexcept
+{
+    const int64 elapsedTicks = Time::getHighResolutionTicks() - startTicks;
+    record ((int64) (Time::highResolutionTicksToSeconds (elapsedTicks) * 1.0e9));
+}
+
+ProcessTimeHistogram::Statistics ProcessTimeHistogram::getStatistics() const noexcept
+{
+    Statistics stats;
+    stats.numCalls = numCalls.load (std::memory_order_acquire);
+    stats.mean = stats.p50 = stats.p99 = stats.max = 0.0;
+
+    if (stats.numCalls == 0)
+        return stats;
+
+    uint32 binCounts[numBins];
+    uint32 total = 0;
+
+    for (int i = 0; i < numBins; ++i)
+    {
+        binCounts[i] = counts[i].load (std::memory_order_relaxed);
+        total += binCounts[i];
+    }
+
+    const uint32 p50Count = (uint32) std::ceil (total * 0.5);
+    const uint32 p99Count = (uint32) std::ceil (total * 0.99);
+    uint32 runningCount = 0;
+
+    for (int i = 0; i < numBins; ++i)
+    {
+        const uint32 previousCount = runningCount;
+        runningCount += binCounts[i];
+
+        if (previousCount < p50Count && runningCount >= p50Count)
+            stats.p50 = getBinUpperEdge (i) * 0.001;
+
+        if (previousCount < p99Count && runningCount >= p99Count)
+        {
+            stats.p99 = getBinUpperEdge (i) * 0.001;
+            break;
+        }
+    }
+
+    stats.max = maxNanoseconds.load (std::memory_order_relaxed) * 0.001;
+    stats.mean = (totalNanoseconds.load (std::memory_order_relaxed) * 0.001) / stats.numCalls;
+
+    // the bins are coarse so don't report percentiles bigger than the actual max
+    stats.p50 = jmin (stats.p50, stats.max);
+    stats.p99 = jmin (stats.p99, stats.max);
+
+    return stats;
+}
+
+//==============================================================================
+int ProcessTimeHistogram::getBinIndex (int64 nanoseconds) noexcept
+{
+    if (nanoseconds < ((int64) 1 << minOctave))
+        return 0;
+
+    int octave = 0;
+
+    for (uint64 n = (uint64) nanoseconds; n > 1; n >>= 1)
+        ++octave;
+
+    if (octave >= maxOctave)
+        return numBins - 1;
+
+    // use the two bits below the highest set bit to split the octave in four
+    const int subBin = (int) ((nanoseconds >> (octave - 2)) & 3);
+
+    return 1 + (octave - minOctave) * binsPerOctave + subBin;
+}
+
+double ProcessTimeHistogram::getBinUpperEdge (int binIndex) noexcept
+{
+    if (binIndex == 0)
+        return (double) ((int64) 1 << minOctave);
+
+    const int octave = minOctave + (binIndex - 1) / binsPerOctave;
+    const int subBin = (binIndex - 1) % binsPerOctave;
+
+    return (double) ((int64) 1 << octave) * (1.0 + (subBin + 1) / (double) binsPerOctave);
+}
+
+void ProcessTimeHistogram::clear() noexcept
+{
+    for (auto& count : counts)
+        count.store (0, std::memory_order_relaxed);
+
+    totalNanoseconds.store (0, std::memory_order_relaxed);
+    maxNanoseconds.store (0, std::memory_order_relaxed);
+    numCalls.store (0, std::memory_order_release);
+}
+
+#endif // DROWAUDIO_USE_PROCESS_TIMING
@@ -0,0 +1,141 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_PROCESSTIMEHISTOGRAM_H
+#define DROWAUDIO_PROCESSTIMEHISTOGRAM_H
+
+#if DROWAUDIO_USE_PROCESS_TIMING || DOXYGEN
+
+//==============================================================================
+/** A lock-free histogram of processing times.
+
+    This is used to record how long an AudioSource spends in its getNextAudioBlock
+    method. The audio thread records durations with record() or a ScopedTimer and
+    any other thread can read the percentiles with getStatistics().
+
+    Times are collected into logarithmically spaced bins, four per octave, so the
+    percentiles returned are accurate to roughly 20%. This is plenty to tell which
+    node in a chain is responsible for a glitch.
+
+    Recording is wait-free and only one thread should record into a histogram at
+    a time, which is the case for an AudioSource's processing methods.
+
+    @see DROWAUDIO_TIME_PROCESS
+ */
+class ProcessTimeHistogram
+{
+public:
+    //==============================================================================
+    /** Holds a summary of the recorded times. All times are in microseconds. */
+    struct Statistics
+    {
+        uint32 numCalls;
+        double mean, p50, p99, max;
+    };
+
+    //==============================================================================
+    /** Creates an empty histogram. */
+    ProcessTimeHistogram() noexcept;
+
+    //==============================================================================
+    /** Records a duration. This is wait-free so can be called from the audio thread. */
+    void record (int64 nanoseconds) noexcept;
+
+    /** Records the time elapsed since a value returned from Time::getHighResolutionTicks(). */
+    void recordTicksSince (int64 startTicks) noexcept;
+
+    /** Asks the recording thread to clear the histogram.
+
+        The histogram will actually be cleared the next time a duration is recorded
+        so that there is only ever one thread writing to it.
+    */
+    void reset() noexcept                       { resetPending.store (true); }
+
+    /** Returns a summary of the recorded times.
+
+        This can be called from any thread. As the audio thread may be recording
+        whilst this is being read the values are a close approximation.
+    */
+    Statistics getStatistics() const noexcept;
+
+    //==============================================================================
+    /** Times a scope and records the duration into a ProcessTimeHistogram. */
+    class ScopedTimer
+    {
+    public:
+        explicit ScopedTimer (ProcessTimeHistogram& histogramToUse) noexcept
+            : histogram (histogramToUse), startTicks (Time::getHighResolutionTicks())
+        {
+        }
+
+        ~ScopedTimer() noexcept
+        {
+            histogram.recordTicksSince (startTicks);
+        }
+
+    private:
+        ProcessTimeHistogram& histogram;
+        const int64 startTicks;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedTimer)
+    };
+
+private:
+    //==============================================================================
+    enum
+    {
+        minOctave = 6,      // 64ns
+        maxOctave = 28,     // 268ms
+        binsPerOctave = 4,
+        numBins = (maxOctave - minOctave) * binsPerOctave + 1
+    };
+
+    std::atomic<uint32> counts[numBins];
+    std::atomic<uint32> numCalls;
+    std::atomic<int64> totalNanoseconds, maxNanoseconds;
+    std::atomic<bool> resetPending;
+
+    static int getBinIndex (int64 nanoseconds) noexcept;
+    static double getBinUpperEdge (int binIndex) noexcept;
+    void clear() noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ProcessTimeHistogram)
+};
+
+//==============================================================================
+/** Times the rest of the enclosing scope into a ProcessTimeHistogram. */
+#define DROWAUDIO_TIME_PROCESS(histogram)    const ProcessTimeHistogram::ScopedTimer JUCE_JOIN_MACRO (processTimer_, __LINE__) (histogram);
+
+#else
+ #define DROWAUDIO_TIME_PROCESS(histogram)
+#endif
+
+#endif // DROWAUDIO_PROCESSTIMEHISTOGRAM_H
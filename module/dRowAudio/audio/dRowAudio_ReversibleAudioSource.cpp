@@ -51,6 +51,8 @@ void ReversibleAudioSource::releaseResources()
 
 void ReversibleAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
+    DROWAUDIO_TIME_PROCESS (processTimeHistogram)
+
     if (isForwards)
     {
         input->getNextAudioBlock (info);
@@ -33,6 +33,7 @@
 #define DROWAUDIO_REVERSIBLEAUDIOSOURCE_H
 
 #include "../utility/dRowAudio_Utility.h"
+#include "dRowAudio_ProcessTimeHistogram.h"
 
 /** A type of AudioSource that can reverse the stream of samples that
     flows through it.
@@ -59,6 +60,11 @@ public:
     /** @returns True if the source is playing forwards. */
     bool isPlayingForwards() const { return isForwards; }
 
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    /** Returns the times spent in getNextAudioBlock, including the time taken by the input source. */
+    const ProcessTimeHistogram& getProcessTimeHistogram() const noexcept { return processTimeHistogram; }
+   #endif
+
     //==============================================================================
     /** @internal */
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
@@ -72,6 +78,9 @@ private:
     OptionalScopedPointer<PositionableAudioSource> input;
     int64 previousReadPosition;
     bool volatile isForwards;
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    ProcessTimeHistogram processTimeHistogram;
+   #endif
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ReversibleAudioSource)
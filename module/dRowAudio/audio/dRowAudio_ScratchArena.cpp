@@ -0,0 +1,119 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+ScratchArena::ScratchArena() noexcept
+    : data (nullptr),
+      size (0),
+      numBytesUsed (0),
+      peakNumBytesUsed (0)
+{
+}
+
+ScratchArena::ScratchArena (size_t numBytes)
+    : data (nullptr),
+      size (0),
+      numBytesUsed (0),
+      peakNumBytesUsed (0)
+{
+    setSize (numBytes);
+}
+
+ScratchArena::~ScratchArena()
+{
+}
+
+//==============================================================================
+void ScratchArena::setSize (size_t numBytes)
+{
+    numBytes = roundUpToAlignment (numBytes);
+
+    if (numBytes != size || data == nullptr)
+    {
+        storage.allocate (numBytes + alignment - 1, false);
+        data = snapPointerToAlignment (storage.getData(), (size_t) alignment);
+        size = numBytes;
+    }
+
+    numBytesUsed = 0;
+}
+
+void ScratchArena::ensureSize (size_t numBytes)
+{
+    if (numBytes > size || data == nullptr)
+        setSize (numBytes);
+}
+
+//==============================================================================
+AudioSampleBuffer ScratchArena::allocateAudioBuffer (int numChannels, int numSamples) noexcept
+{
+    float** const channels = allocate<float*> ((size_t) numChannels);
+
+    if (channels != nullptr)
+    {
+        for (int i = 0; i < numChannels; ++i)
+        {
+            channels[i] = allocate<float> ((size_t) numSamples);
+
+            if (channels[i] == nullptr)
+                return {};
+        }
+
+        return AudioSampleBuffer (channels, numChannels, numSamples);
+    }
+
+    return {};
+}
+
+size_t ScratchArena::getRequiredSizeForAudioBuffer (int numChannels, int numSamples) noexcept
+{
+    return getRequiredSize<float*> ((size_t) numChannels)
+            + (size_t) numChannels * getRequiredSize<float> ((size_t) numSamples);
+}
+
+//==============================================================================
+void* ScratchArena::allocateBytes (size_t numBytes) noexcept
+{
+    const size_t alignedNumBytes = roundUpToAlignment (numBytes);
+
+    if (alignedNumBytes > size - numBytesUsed)
+    {
+        // the arena isn't big enough, make sure setSize() accounts for everything
+        // that is allocated between calls to reset()
+        jassertfalse;
+        return nullptr;
+    }
+
+    void* const allocation = data + numBytesUsed;
+    numBytesUsed += alignedNumBytes;
+    peakNumBytesUsed = jmax (peakNumBytesUsed, numBytesUsed);
+
+    return allocation;
+}
@@ -0,0 +1,186 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_SCRATCHARENA_H
+#define DROWAUDIO_SCRATCHARENA_H
+
+//==============================================================================
+/** A bump allocator for temporary buffers used during processing.
+
+    Size one of these when preparing to process, then reset() it at the start of
+    each callback and take whatever temporary buffers are needed from it with
+    allocate() or allocateAudioBuffer(). Allocating just moves a pointer, so it is
+    safe on the audio thread. Nothing is freed until the next reset(), which keeps
+    all of a callback's scratch memory contiguous and cache-hot.
+
+    Every allocation is aligned to ScratchArena::alignment bytes, so SIMD code can
+    use aligned loads on it. Use a ScopedRewind to release memory taken inside a
+    loop or a function that is called many times per callback.
+
+    An arena should only be used by one thread at a time, so usually each object
+    that needs scratch space owns one.
+
+    @see ScratchArena::ScopedRewind
+ */
+class ScratchArena
+{
+public:
+    //==============================================================================
+    /** The alignment in bytes of every allocation. */
+    enum { alignment = 64 };
+
+    /** Creates an empty arena. Call setSize() before allocating anything from it. */
+    ScratchArena() noexcept;
+
+    /** Creates an arena that can hold a given number of bytes. */
+    explicit ScratchArena (size_t numBytes);
+
+    /** Destructor. */
+    ~ScratchArena();
+
+    //==============================================================================
+    /** Changes the number of bytes the arena can hold.
+        This frees any existing allocations and may allocate so shouldn't be called
+        on the audio thread. Call it from prepareToPlay or similar.
+    */
+    void setSize (size_t numBytes);
+
+    /** Makes sure the arena can hold at least a given number of bytes.
+        This only reallocates if the arena is too small, but if it does any existing
+        allocations will be freed.
+    */
+    void ensureSize (size_t numBytes);
+
+    /** Returns the number of bytes the arena can hold. */
+    size_t getSize() const noexcept                     {   return size;        }
+
+    /** Returns the number of bytes allocated since the last reset(). */
+    size_t getNumBytesUsed() const noexcept             {   return numBytesUsed;    }
+
+    /** Returns the largest number of bytes that have been in use at once.
+        This can be used to find out how big the arena needs to be.
+    */
+    size_t getPeakNumBytesUsed() const noexcept         {   return peakNumBytesUsed;    }
+
+    /** Frees all allocations so the memory can be reused.
+        Call this at the start of each processing callback.
+    */
+    void reset() noexcept                               {   numBytesUsed = 0;   }
+
+    //==============================================================================
+    /** Returns the number of bytes needed to allocate a number of elements.
+        Add these up to find the size to give to setSize().
+    */
+    template <typename Type>
+    static size_t getRequiredSize (size_t numElements) noexcept
+    {
+        return roundUpToAlignment (numElements * sizeof (Type));
+    }
+
+    /** Allocates space for a number of elements.
+
+        Types that need constructing are default constructed, but destructors are
+        never called so only types that don't need destroying can be used.
+        If there isn't enough space this returns nullptr, which is a sign that
+        the arena wasn't made big enough.
+    */
+    template <typename Type>
+    Type* allocate (size_t numElements) noexcept
+    {
+        static_assert (std::is_trivially_destructible<Type>::value,
+                       "ScratchArena never calls destructors");
+
+        Type* const elements = static_cast<Type*> (allocateBytes (numElements * sizeof (Type)));
+
+        if (! std::is_trivially_default_constructible<Type>::value && elements != nullptr)
+            for (size_t i = 0; i < numElements; ++i)
+                new (elements + i) Type();
+
+        return elements;
+    }
+
+    /** Allocates an AudioSampleBuffer whose channels refer to the arena's memory.
+        The contents are not cleared. The returned buffer must not be resized and
+        must not be used after the arena has been reset.
+    */
+    AudioSampleBuffer allocateAudioBuffer (int numChannels, int numSamples) noexcept;
+
+    /** Returns the number of bytes needed to allocate an AudioSampleBuffer with
+        allocateAudioBuffer().
+    */
+    static size_t getRequiredSizeForAudioBuffer (int numChannels, int numSamples) noexcept;
+
+    //==============================================================================
+    /** Frees everything allocated from an arena during the lifetime of this object.
+
+        Use this around code that takes scratch space many times per callback, such as
+        the body of a loop, so the arena doesn't run out.
+    */
+    class ScopedRewind
+    {
+    public:
+        /** Remembers the current position of the arena. */
+        explicit ScopedRewind (ScratchArena& arenaToRewind) noexcept
+            : arena (arenaToRewind), numBytesUsedAtStart (arenaToRewind.numBytesUsed)
+        {
+        }
+
+        /** Frees anything allocated since the constructor. */
+        ~ScopedRewind() noexcept
+        {
+            arena.numBytesUsed = numBytesUsedAtStart;
+        }
+
+    private:
+        ScratchArena& arena;
+        const size_t numBytesUsedAtStart;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedRewind)
+    };
+
+private:
+    //==============================================================================
+    HeapBlock<char> storage;
+    char* data;
+    size_t size, numBytesUsed, peakNumBytesUsed;
+
+    void* allocateBytes (size_t numBytes) noexcept;
+
+    static size_t roundUpToAlignment (size_t numBytes) noexcept
+    {
+        return (numBytes + alignment - 1) & ~((size_t) alignment - 1);
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScratchArena)
+};
+
+#endif   // DROWAUDIO_SCRATCHARENA_H
@@ -0,0 +1,416 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+namespace ScrubbingHelpers
+{
+    /** 4-point, 3rd-order Hermite interpolation between samples[0] and samples[1].
+        This reads from samples[-1] to samples[2].
+    */
+    inline float hermite (const float* samples, float fraction) noexcept
+    {
+        const float c0 = samples[0];
+        const float c1 = 0.5f * (samples[1] - samples[-1]);
+        const float c2 = samples[-1] - 2.5f * samples[0] + 2.0f * samples[1] - 0.5f * samples[2];
+        const float c3 = 0.5f * (samples[2] - samples[-1]) + 1.5f * (samples[0] - samples[1]);
+
+        return ((c3 * fraction + c2) * fraction + c1) * fraction + c0;
+    }
+}
+
+//==============================================================================
+ScrubbingAudioSource::ScrubbingAudioSource (PositionableAudioSource* const inputSource,
+                                            const bool deleteInputWhenDeleted,
+                                            TimeSliceThread& backgroundThread_,
+                                            const int windowSizeInSamples)
+    : input                 (inputSource, deleteInputWhenDeleted),
+      backgroundThread      (backgroundThread_),
+      prefetchReader        (nullptr, false),
+      readerGeneration      (0),
+      windowSize            (jmax (1024, windowSizeInSamples)),
+      windowInUse           (0),
+      pendingWindow         (-1),
+      windowCentreRequest   (0),
+      lastFilledStart       (0),
+      lastFilledGeneration  (-1),
+      targetSequence        (0),
+      postedTargetPosition  (0),
+      postedTargetVelocity  (0.0),
+      scrubState            (scrubIdle),
+      returnPosition        (0),
+      scrubPositionOut      (0.0),
+      catchUpTime           (0.1),
+      maximumRate           (8.0),
+      playbackMode          (playingInput),
+      lastTargetSequence    (0),
+      activeWindow          (0),
+      fadeLength            (512),
+      fadeSamplesRemaining  (0),
+      scrubPosition         (0.0),
+      scrubRate             (0.0),
+      targetPosition        (0.0),
+      targetVelocity        (0.0),
+      currentSampleRate     (44100.0),
+      rateSmoothing         (0.001)
+{
+    jassert (input != nullptr);
+
+    fadeBuffer.setSize (2, fadeLength);
+
+    for (auto& window : windows)
+    {
+        window.buffer.setSize (2, windowSize);
+        window.buffer.clear();
+        window.startSample = 0;
+        window.generation = -1;
+    }
+
+    backgroundThread.addTimeSliceClient (this);
+}
+
+ScrubbingAudioSource::~ScrubbingAudioSource()
+{
+    backgroundThread.removeTimeSliceClient (this);
+}
+
+//==============================================================================
+void ScrubbingAudioSource::setPrefetchReader (AudioFormatReader* newReader, bool deleteReaderWhenRemoved)
+{
+    {
+        const ScopedLock sl (readerLock);
+        prefetchReader.set (newReader, deleteReaderWhenRemoved);
+        ++readerGeneration;
+    }
+
+    backgroundThread.moveToFrontOfQueue (this);
+}
+
+void ScrubbingAudioSource::beginScrubbing()
+{
+    scrubState = scrubStarting;
+    backgroundThread.moveToFrontOfQueue (this);
+}
+
+void ScrubbingAudioSource::setScrubTarget (int64 newTargetPosition, double newTargetVelocity)
+{
+    // overwrite the last target, the audio thread only ever wants the latest one
+    const uint32 sequence = targetSequence.load (std::memory_order_relaxed);
+    targetSequence.store (sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence (std::memory_order_release);
+
+    postedTargetPosition.store (newTargetPosition, std::memory_order_relaxed);
+    postedTargetVelocity.store (newTargetVelocity, std::memory_order_relaxed);
+
+    targetSequence.store (sequence + 2, std::memory_order_release);
+}
+
+void ScrubbingAudioSource::endScrubbing (bool inputIsPlaying)
+{
+    int state = scrubStarting;
+
+    // if the audio thread never started scrubbing the input is still where it was
+    if (scrubState.compare_exchange_strong (state, scrubIdle) || state != scrubActive)
+        return;
+
+    // with nothing playing there is nothing to return to, so the input is left where
+    // the scrub stopped
+    if (! inputIsPlaying)
+    {
+        input->setNextReadPosition ((int64) scrubPositionOut.load());
+        scrubState = scrubEnding;
+        return;
+    }
+
+    // the audio thread isn't reading the input whilst scrubbing so it can be moved
+    // here, far enough ahead for it to buffer before the scrub catches up with it
+    const int64 position = (int64) scrubPositionOut.load() + windowSize / 8;
+    input->setNextReadPosition (position);
+
+    returnPosition = position;
+    scrubState = scrubReturning;
+}
+
+void ScrubbingAudioSource::setCatchUpTime (double newCatchUpTimeSeconds) noexcept
+{
+    catchUpTime = jmax (0.001, newCatchUpTimeSeconds);
+}
+
+void ScrubbingAudioSource::setMaximumRate (double newMaximumRate) noexcept
+{
+    maximumRate = jmax (0.0, newMaximumRate);
+}
+
+//==============================================================================
+void ScrubbingAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate)
+{
+    input->prepareToPlay (samplesPerBlockExpected, sampleRate);
+
+    currentSampleRate = sampleRate;
+
+    // the rate follows its target with a time constant of 20ms
+    rateSmoothing = 1.0 - std::exp (-1.0 / (0.02 * sampleRate));
+
+    fadeLength = jmax (1, samplesPerBlockExpected);
+    fadeBuffer.setSize (2, fadeLength);
+}
+
+void ScrubbingAudioSource::releaseResources()
+{
+    input->releaseResources();
+}
+
+void ScrubbingAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
+{
+    DROWAUDIO_TIME_PROCESS (processTimeHistogram)
+
+    const int newWindow = pendingWindow.load();
+
+    // the background thread fills whichever window isn't in use once the pending one
+    // has been taken, so it must see the new window in use before that
+    if (newWindow >= 0)
+    {
+        activeWindow = newWindow;
+        windowInUse = newWindow;
+        pendingWindow = -1;
+    }
+
+    int state = scrubState.load();
+
+    if (state == scrubStarting && scrubState.compare_exchange_strong (state, scrubActive))
+        state = scrubActive;
+
+    if (state == scrubActive)
+    {
+        // carry on from wherever a previous scrub got to if it is still returning
+        if (playbackMode == playingInput)
+        {
+            scrubPosition = targetPosition = (double) input->getNextReadPosition();
+            scrubRate = targetVelocity = 0.0;
+        }
+
+        playbackMode = scrubbing;
+        updateTarget (info.numSamples);
+        renderScrub (*info.buffer, info.startSample, info.numSamples);
+
+        windowCentreRequest = (int64) scrubPosition;
+        return;
+    }
+
+    updateTarget (info.numSamples);
+
+    if (playbackMode == playingInput)
+    {
+        input->getNextAudioBlock (info);
+        windowCentreRequest = input->getNextReadPosition();
+        return;
+    }
+
+    int numDone = 0;
+    targetPosition = scrubPosition;
+
+    if (state == scrubEnding)
+    {
+        // the input isn't playing so bring the scrub to a stop and fade it out
+        targetVelocity = 0.0;
+
+        if (playbackMode != fading)
+        {
+            playbackMode = fading;
+            fadeSamplesRemaining = fadeLength;
+        }
+    }
+    else
+    {
+        // play on from the window at normal speed until reaching the repositioned input
+        targetVelocity = 1.0;
+
+        if (playbackMode == scrubbing)
+            playbackMode = returning;
+
+        if (playbackMode == returning)
+        {
+            numDone = renderScrub (*info.buffer, info.startSample, info.numSamples, (double) returnPosition.load());
+
+            if (numDone < info.numSamples)
+            {
+                playbackMode = fading;
+                fadeSamplesRemaining = fadeLength;
+            }
+        }
+    }
+
+    if (playbackMode == fading)
+        renderFade (AudioSourceChannelInfo (info.buffer, info.startSample + numDone, info.numSamples - numDone));
+
+    windowCentreRequest = (int64) scrubPosition;
+}
+
+int ScrubbingAudioSource::useTimeSlice()
+{
+    DROWAUDIO_TRACE_THREAD();
+
+    // wait until the audio thread has picked up the last window before filling another
+    if (pendingWindow.load() >= 0)
+        return 5;
+
+    const int64 centre = windowCentreRequest.load();
+    const int64 margin = windowSize / 4;
+
+    if (lastFilledGeneration == readerGeneration.load()
+         && centre >= lastFilledStart + margin
+         && centre < lastFilledStart + windowSize - margin)
+        return 20;
+
+    const int windowIndex = 1 - windowInUse.load();
+
+    if (fillWindow (windowIndex, centre))
+    {
+        pendingWindow = windowIndex;
+        return 1;
+    }
+
+    return 50;
+}
+
+//==============================================================================
+void ScrubbingAudioSource::updateTarget (int numSamples) noexcept
+{
+    const uint32 sequence = targetSequence.load (std::memory_order_acquire);
+
+    if (sequence != lastTargetSequence && (sequence & 1) == 0)
+    {
+        const int64 position = postedTargetPosition.load (std::memory_order_relaxed);
+        const double velocity = postedTargetVelocity.load (std::memory_order_relaxed);
+        std::atomic_thread_fence (std::memory_order_acquire);
+
+        // if a new target was written whilst reading it'll be picked up next block
+        if (targetSequence.load (std::memory_order_relaxed) == sequence)
+        {
+            targetPosition = (double) position;
+            targetVelocity = velocity;
+            lastTargetSequence = sequence;
+            return;
+        }
+    }
+
+    targetPosition += targetVelocity * numSamples;
+}
+
+int ScrubbingAudioSource::renderScrub (AudioSampleBuffer& buffer, int startSample, int numSamples,
+                                       double stopPosition) noexcept
+{
+    using namespace ScrubbingHelpers;
+
+    const Window& window = windows[activeWindow];
+    const bool windowIsValid = window.generation == readerGeneration.load();
+    const float* const source[2] = { window.buffer.getReadPointer (0), window.buffer.getReadPointer (1) };
+
+    const int numChannels = buffer.getNumChannels();
+    float* const* dest = buffer.getArrayOfWritePointers();
+
+    // aim to reach the target within the catch-up time whilst following its velocity
+    const double maxRate = maximumRate.load();
+    const double desiredRate = jlimit (-maxRate, maxRate,
+                                       targetVelocity + (targetPosition - scrubPosition) / (catchUpTime.load() * currentSampleRate));
+
+    int i = 0;
+
+    for (; i < numSamples && scrubPosition < stopPosition; ++i)
+    {
+        scrubRate += (desiredRate - scrubRate) * rateSmoothing;
+
+        const double windowPosition = scrubPosition - window.startSample;
+        const int index = (int) std::floor (windowPosition);
+        const bool isInWindow = windowIsValid && index >= 1 && index < windowSize - 2;
+        const float fraction = (float) (windowPosition - index);
+
+        for (int c = 0; c < numChannels; ++c)
+            dest[c][startSample + i] = isInWindow ? hermite (source[jmin (c, 1)] + index, fraction) : 0.0f;
+
+        scrubPosition += scrubRate;
+    }
+
+    scrubPositionOut = scrubPosition;
+
+    return i;
+}
+
+void ScrubbingAudioSource::renderFade (const AudioSourceChannelInfo& info)
+{
+    input->getNextAudioBlock (info);
+
+    // the scrub carries on into the fade buffer and is faded out under the input
+    const int numToFade = jmin (info.numSamples, fadeSamplesRemaining, fadeBuffer.getNumSamples());
+    renderScrub (fadeBuffer, 0, numToFade);
+
+    const float startGain = 1.0f - fadeSamplesRemaining / (float) fadeLength;
+    fadeSamplesRemaining -= numToFade;
+    const float endGain = 1.0f - fadeSamplesRemaining / (float) fadeLength;
+
+    for (int c = 0; c < info.buffer->getNumChannels(); ++c)
+    {
+        info.buffer->applyGainRamp (c, info.startSample, numToFade, startGain, endGain);
+        info.buffer->addFromWithRamp (c, info.startSample,
+                                      fadeBuffer.getReadPointer (jmin (c, 1)), numToFade,
+                                      1.0f - startGain, 1.0f - endGain);
+    }
+
+    if (fadeSamplesRemaining <= 0)
+    {
+        playbackMode = playingInput;
+
+        int state = scrubState.load();
+
+        if (state == scrubReturning || state == scrubEnding)
+            scrubState.compare_exchange_strong (state, scrubIdle);
+    }
+}
+
+bool ScrubbingAudioSource::fillWindow (int windowIndex, int64 centre)
+{
+    DROWAUDIO_TRACE_SCOPE ("ScrubbingAudioSource::fillWindow")
+
+    const ScopedLock sl (readerLock);
+
+    if (prefetchReader == nullptr)
+        return false;
+
+    Window& window = windows[windowIndex];
+    window.startSample = centre - windowSize / 2;
+    window.generation = readerGeneration.load();
+
+    // reads outside the source are filled with silence
+    prefetchReader->read (&window.buffer, 0, windowSize, window.startSample, true, true);
+
+    lastFilledStart = window.startSample;
+    lastFilledGeneration = window.generation;
+
+    return true;
+}
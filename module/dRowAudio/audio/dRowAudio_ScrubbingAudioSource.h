@@ -0,0 +1,217 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_SCRUBBINGAUDIOSOURCE_H
+#define DROWAUDIO_SCRUBBINGAUDIOSOURCE_H
+
+#include "dRowAudio_ProcessTimeHistogram.h"
+
+//==============================================================================
+/** An AudioSource that can scrub through its input with a smoothed varispeed.
+
+    Normally this just passes on the input source's audio. Whilst scrubbing, the
+    UI posts a stream of target positions and velocities with setScrubTarget() and
+    the audio is played from the current position towards the target, with the
+    playback rate smoothly following the target velocity. This sounds like a
+    record or tape being moved by hand rather than a series of jumps.
+
+    Whilst scrubbing, the audio is read from a window around the playhead. A
+    background thread keeps the window filled from an AudioFormatReader, so the
+    input source is never repositioned. The windows are swapped without locking,
+    so the audio thread never has to wait. When scrubbing ends whilst the input is
+    playing, the input is moved on a little way ahead of the scrubbed position from
+    the calling thread, giving it time to buffer, and the window plays on at normal
+    speed until it reaches the input, which is then cross-faded back in over one
+    block. If the input isn't playing it is moved to exactly the scrubbed position
+    and the scrub is faded out where it stopped.
+
+    Positions are in samples of the input source. A velocity of 1.0 plays one
+    source sample per output sample, so the reader should run at the same sample
+    rate as the input.
+
+    @see DraggableWaveDisplay
+*/
+class ScrubbingAudioSource : public AudioSource,
+                             public TimeSliceClient
+{
+public:
+    //==============================================================================
+    /** Creates a ScrubbingAudioSource for a given input source.
+
+        @param inputSource              the source to play when not scrubbing
+        @param deleteInputWhenDeleted   if true, the input source will be deleted
+                                        when this object is deleted
+        @param backgroundThread         the thread to use to fill the scrub window.
+                                        This must outlive the ScrubbingAudioSource
+        @param windowSizeInSamples      the number of samples to keep around the playhead
+    */
+    ScrubbingAudioSource (PositionableAudioSource* inputSource,
+                          bool deleteInputWhenDeleted,
+                          TimeSliceThread& backgroundThread,
+                          int windowSizeInSamples = 262144);
+
+    /** Destructor. */
+    ~ScrubbingAudioSource() override;
+
+    //==============================================================================
+    /** Sets the reader that the scrub window is filled from.
+        This should read the same audio as the input source and be separate from
+        any reader the input uses, as it is read from the background thread.
+        Call this whenever the input source's audio changes.
+    */
+    void setPrefetchReader (AudioFormatReader* newReader, bool deleteReaderWhenRemoved);
+
+    /** Starts scrubbing from the input's current position.
+        The playback rate starts at 0 and follows the targets posted by setScrubTarget().
+    */
+    void beginScrubbing();
+
+    /** Posts a new position and velocity to scrub towards.
+        This can be called from any single thread, usually the message thread, and
+        never blocks. Only the latest target is kept, replacing any the audio thread
+        hasn't picked up yet. The target is extrapolated by its velocity until the
+        next one arrives, so the velocity should be in source samples per output sample.
+    */
+    void setScrubTarget (int64 targetPosition, double targetVelocity);
+
+    /** Stops scrubbing and returns to normal playback from the scrubbed position.
+
+        Pass false if the input isn't playing, e.g. because its transport was stopped
+        for the drag, and it will be left at exactly the scrubbed position rather than
+        being played on to.
+
+        This repositions the input source so should be called from the same thread
+        as you would normally do that on, usually the message thread.
+    */
+    void endScrubbing (bool inputIsPlaying = true);
+
+    /** Returns true if scrubbing has been started with beginScrubbing(). */
+    bool isScrubbing() const noexcept                       {   return scrubState.load() <= scrubActive; }
+
+    /** Returns the position that was last played whilst scrubbing. */
+    double getScrubPosition() const noexcept                {   return scrubPositionOut.load(); }
+
+    /** Sets the time it takes to catch up with the target position, in seconds.
+        Shorter times follow the UI more tightly but change pitch more abruptly.
+    */
+    void setCatchUpTime (double newCatchUpTimeSeconds) noexcept;
+
+    /** Sets the fastest the source can be scrubbed, as a multiple of normal speed. */
+    void setMaximumRate (double newMaximumRate) noexcept;
+
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    /** Returns the times spent in getNextAudioBlock, including the time taken by the input source. */
+    const ProcessTimeHistogram& getProcessTimeHistogram() const noexcept { return processTimeHistogram; }
+   #endif
+
+    //==============================================================================
+    /** @internal */
+    void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
+    /** @internal */
+    void releaseResources() override;
+    /** @internal */
+    void getNextAudioBlock (const AudioSourceChannelInfo& bufferToFill) override;
+    /** @internal */
+    int useTimeSlice() override;
+
+private:
+    //==============================================================================
+    enum ScrubState
+    {
+        scrubStarting,
+        scrubActive,
+        scrubReturning,
+        scrubEnding,
+        scrubIdle
+    };
+
+    enum PlaybackMode
+    {
+        playingInput,
+        scrubbing,
+        returning,
+        fading
+    };
+
+    struct Window
+    {
+        AudioSampleBuffer buffer;
+        int64 startSample;
+        int generation;
+    };
+
+    OptionalScopedPointer<PositionableAudioSource> input;
+    TimeSliceThread& backgroundThread;
+
+    CriticalSection readerLock;
+    OptionalScopedPointer<AudioFormatReader> prefetchReader;
+    std::atomic<int> readerGeneration;
+
+    const int windowSize;
+    Window windows[2];
+    std::atomic<int> windowInUse, pendingWindow;
+    std::atomic<int64> windowCentreRequest;
+    int64 lastFilledStart;
+    int lastFilledGeneration;
+
+    // the latest target, guarded by a sequence count that is odd whilst it is written
+    std::atomic<uint32> targetSequence;
+    std::atomic<int64> postedTargetPosition;
+    std::atomic<double> postedTargetVelocity;
+
+    std::atomic<int> scrubState;
+    std::atomic<int64> returnPosition;
+    std::atomic<double> scrubPositionOut, catchUpTime, maximumRate;
+
+    // only used on the audio thread
+    PlaybackMode playbackMode;
+    uint32 lastTargetSequence;
+    int activeWindow, fadeLength, fadeSamplesRemaining;
+    double scrubPosition, scrubRate, targetPosition, targetVelocity;
+    double currentSampleRate, rateSmoothing;
+    AudioSampleBuffer fadeBuffer;
+
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    ProcessTimeHistogram processTimeHistogram;
+   #endif
+
+    //==============================================================================
+    void updateTarget (int numSamples) noexcept;
+    int renderScrub (AudioSampleBuffer& buffer, int startSample, int numSamples,
+                     double stopPosition = std::numeric_limits<double>::max()) noexcept;
+    void renderFade (const AudioSourceChannelInfo& info);
+    bool fillWindow (int windowIndex, int64 centre);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (ScrubbingAudioSource)
+};
+
+#endif   // DROWAUDIO_SCRUBBINGAUDIOSOURCE_H
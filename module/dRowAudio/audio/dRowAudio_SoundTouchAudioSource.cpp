@@ -38,7 +38,6 @@ SoundTouchAudioSource::SoundTouchAudioSource (PositionableAudioSource* source_,
     : source (source_, deleteSourceWhenDeleted),
       numberOfSamplesToBuffer (jmax (1024, numberOfSamplesToBuffer_)),
       numberOfChannels (numberOfChannels_),
-      buffer (numberOfChannels_, 0),
       nextReadPos (0),
       isPrepared (false)
 {
@@ -58,17 +57,19 @@ void SoundTouchAudioSource::setPlaybackSettings (const SoundTouchProcessor::Play
 }
 
 //==============================================================================
-void SoundTouchAudioSource::prepareToPlay (int /*samplesPerBlockExpected*/, double sampleRate_)
+void SoundTouchAudioSource::prepareToPlay (int samplesPerBlockExpected, double sampleRate_)
 {
-    soundTouchProcessor.initialise (numberOfChannels, sampleRate);
+    soundTouchProcessor.initialise (numberOfChannels, sampleRate,
+                                    jmax (samplesPerBlockExpected, numberOfSamplesToBuffer));
+
+    // the chunks read from the source are taken from the arena each callback
+    scratchArena.setSize (ScratchArena::getRequiredSizeForAudioBuffer (numberOfChannels, numberOfSamplesToBuffer));
 
     if (sampleRate_ != sampleRate
-        || numberOfSamplesToBuffer != buffer.getNumSamples()
         || ! isPrepared)
     {
         isPrepared = true;
         sampleRate = sampleRate_;
-        buffer.setSize (numberOfChannels, numberOfSamplesToBuffer);
 
         source->prepareToPlay (numberOfSamplesToBuffer, sampleRate_);
     }
@@ -85,10 +86,14 @@ void SoundTouchAudioSource::releaseResources()
 
 void SoundTouchAudioSource::getNextAudioBlock (const AudioSourceChannelInfo& info)
 {
+    DROWAUDIO_TIME_PROCESS (processTimeHistogram)
+
+    scratchArena.reset();
+
     while (soundTouchProcessor.getNumReady() < info.numSamples)
         readNextBufferChunk();
 
-    soundTouchProcessor.readSamples (info.buffer->getArrayOfWritePointers(), buffer.getNumChannels(),
+    soundTouchProcessor.readSamples (info.buffer->getArrayOfWritePointers(), numberOfChannels,
                                      info.numSamples, info.startSample);
 
     effectiveNextPlayPos += (int64) (info.numSamples * soundTouchProcessor.getEffectivePlaybackRatio());
@@ -118,12 +123,19 @@ void SoundTouchAudioSource::readNextBufferChunk()
     if (source->getNextReadPosition() != nextReadPos)
         source->setNextReadPosition (nextReadPos);
 
+    const ScratchArena::ScopedRewind rewind (scratchArena);
+    AudioSampleBuffer buffer (scratchArena.allocateAudioBuffer (numberOfChannels, numberOfSamplesToBuffer));
+
     AudioSourceChannelInfo info;
     info.buffer = &buffer;
     info.startSample = 0;
     info.numSamples = buffer.getNumSamples();
 
-    source->getNextAudioBlock (info);
+    {
+        DROWAUDIO_TIME_PROCESS (inputProcessTimeHistogram)
+        source->getNextAudioBlock (info);
+    }
+
     nextReadPos += info.numSamples;
 
     soundTouchProcessor.writeSamples (buffer.getArrayOfWritePointers(), buffer.getNumChannels(), info.numSamples);
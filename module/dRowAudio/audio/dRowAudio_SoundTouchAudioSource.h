@@ -34,7 +34,9 @@
 
 #if DROWAUDIO_USE_SOUNDTOUCH || DOXYGEN
 
+#include "dRowAudio_ScratchArena.h"
 #include "dRowAudio_SoundTouchProcessor.h"
+#include "dRowAudio_ProcessTimeHistogram.h"
 
 /** An audio source that can independently change the rate,
     tempo and pitch of an audio source.
@@ -72,6 +74,16 @@ public:
     /** Returns the SoundTouchProcessor being used. */
     SoundTouchProcessor& getSoundTouchProcessor() { return soundTouchProcessor; }
 
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    /** Returns the times spent in getNextAudioBlock, including the time taken by reading from the source. */
+    const ProcessTimeHistogram& getProcessTimeHistogram() const noexcept { return processTimeHistogram; }
+
+    /** Returns the times spent reading from the source.
+        When used in an AudioFilePlayerExt this is the time taken by the BufferingAudioSource.
+    */
+    const ProcessTimeHistogram& getInputProcessTimeHistogram() const noexcept { return inputProcessTimeHistogram; }
+   #endif
+
     //==============================================================================
     /** @internal */
     void prepareToPlay (int samplesPerBlockExpected, double sampleRate) override;
@@ -94,13 +106,16 @@ private:
     //==============================================================================
     OptionalScopedPointer<PositionableAudioSource> source;
     int numberOfSamplesToBuffer, numberOfChannels;
-    AudioSampleBuffer buffer;
+    ScratchArena scratchArena;
     CriticalSection bufferStartPosLock;
     int64 volatile nextReadPos, effectiveNextPlayPos;
     double volatile sampleRate;
     bool isPrepared;
 
     SoundTouchProcessor soundTouchProcessor;
+   #if DROWAUDIO_USE_PROCESS_TIMING
+    ProcessTimeHistogram processTimeHistogram, inputProcessTimeHistogram;
+   #endif
 
     void readNextBufferChunk();
 
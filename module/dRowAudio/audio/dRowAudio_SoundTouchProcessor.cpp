@@ -34,17 +34,17 @@
 using namespace soundtouch;
 
 SoundTouchProcessor::SoundTouchProcessor()
-    : interleavedInputBufferSize (512),
-      interleavedOutputBufferSize (512)
+    : interleavedBufferSize (0)
 {
     setPlaybackSettings (settings);
 
-    interleavedInputBuffer.malloc ((size_t) interleavedInputBufferSize * 2);
-    interleavedOutputBuffer.malloc ((size_t) interleavedOutputBufferSize * 2);
+    allocateInterleavedBuffers (2, 512);
 }
 
-void SoundTouchProcessor::initialise (int numChannels, double sampleRate)
+void SoundTouchProcessor::initialise (int numChannels, double sampleRate, int maxNumSamplesPerBlock)
 {
+    allocateInterleavedBuffers (numChannels, maxNumSamplesPerBlock);
+
     const ScopedLock sl (lock);
     soundTouch.setChannels ((uint32) numChannels);
     soundTouch.setSampleRate ((uint32) sampleRate);
@@ -53,65 +53,75 @@ void SoundTouchProcessor::initialise (int numChannels, double sampleRate)
 
 void SoundTouchProcessor::writeSamples (float** sourceChannelData, int numChannels, int numSamples, int startSampleOffset)
 {
-    const int requiredBufferSize = numSamples * numChannels;
+    const int maxNumSamplesPerChunk = interleavedBufferSize / jmax (1, numChannels);
+    jassert (maxNumSamplesPerChunk > 0); // more channels than the processor was initialised with
+    int numSamplesDone = 0;
 
-    if (interleavedInputBufferSize < requiredBufferSize)
+    while (numSamplesDone < numSamples && maxNumSamplesPerChunk > 0)
     {
-        interleavedInputBuffer.malloc ((size_t) requiredBufferSize);
-        interleavedInputBufferSize = requiredBufferSize;
-    }
+        const int numThisTime = jmin (numSamples - numSamplesDone, maxNumSamplesPerChunk);
+        const int offset = startSampleOffset + numSamplesDone;
 
-    for (int i = 0; i < numChannels; ++i)
-        sourceChannelData[i] += startSampleOffset;
+        for (int i = 0; i < numChannels; ++i)
+            sourceChannelData[i] += offset;
 
-    AudioDataConverters::interleaveSamples ((const float**) sourceChannelData, interleavedInputBuffer,
-                                            numSamples, numChannels);
+        AudioDataConverters::interleaveSamples ((const float**) sourceChannelData, interleavedInputBuffer,
+                                                numThisTime, numChannels);
 
-    for (int i = 0; i < numChannels; ++i)
-        sourceChannelData[i] -= startSampleOffset;
+        for (int i = 0; i < numChannels; ++i)
+            sourceChannelData[i] -= offset;
 
-    const ScopedLock sl (lock);
-    soundTouch.putSamples ((SAMPLETYPE*) interleavedInputBuffer, (uint32) numSamples);
+        {
+            const ScopedLock sl (lock);
+            soundTouch.putSamples ((SAMPLETYPE*) interleavedInputBuffer, (uint32) numThisTime);
+        }
+
+        numSamplesDone += numThisTime;
+    }
 }
 
 void SoundTouchProcessor::readSamples (float** destinationChannelData, int numChannels, int numSamples, int startSampleOffset)
 {
-    const int requiredBufferSize = numSamples * numChannels;
-
-    if (interleavedOutputBufferSize < requiredBufferSize)
-    {
-        interleavedOutputBuffer.malloc ((size_t) requiredBufferSize);
-        interleavedOutputBufferSize = requiredBufferSize;
-    }
-
+    const int maxNumSamplesPerChunk = interleavedBufferSize / jmax (1, numChannels);
+    jassert (maxNumSamplesPerChunk > 0); // more channels than the processor was initialised with
     int numSamplesDone = 0;
-    int numThisTime = 0;
 
+    while (numSamplesDone < numSamples && maxNumSamplesPerChunk > 0)
     {
-        const ScopedLock sl (lock);
+        const int numThisChunk = jmin (numSamples - numSamplesDone, maxNumSamplesPerChunk);
+        int numReceived = 0;
 
-        for (;;)
         {
-            const int maxNumSamples = numSamples - numSamplesDone;
-            numThisTime = (int) soundTouch.receiveSamples ((SAMPLETYPE*) &interleavedOutputBuffer[numChannels * numSamplesDone], (uint32) maxNumSamples);
+            const ScopedLock sl (lock);
 
-            numSamplesDone += numThisTime;
+            for (;;)
+            {
+                const int numThisTime = (int) soundTouch.receiveSamples ((SAMPLETYPE*) &interleavedOutputBuffer[numChannels * numReceived],
+                                                                         (uint32) (numThisChunk - numReceived));
+                numReceived += numThisTime;
 
-            if (numSamplesDone == numSamples || numThisTime == 0)
-                break;
+                if (numReceived == numThisChunk || numThisTime == 0)
+                    break;
+            }
         }
-    }
 
-    if (numSamplesDone < numSamples)
-        zeromem (&interleavedOutputBuffer[numChannels * numSamplesDone], (size_t) numChannels * sizeof (numSamples - numSamplesDone));
+        if (numReceived < numThisChunk)
+            zeromem (&interleavedOutputBuffer[numChannels * numReceived],
+                     (size_t) (numChannels * (numThisChunk - numReceived)) * sizeof (float));
+
+        const int offset = startSampleOffset + numSamplesDone;
+
+        for (int i = 0; i < numChannels; ++i)
+            destinationChannelData[i] += offset;
+
+        AudioDataConverters::deinterleaveSamples (interleavedOutputBuffer, destinationChannelData,
+                                                  numThisChunk, numChannels);
 
-    for (int i = 0; i < numChannels; ++i)
-        destinationChannelData[i] += startSampleOffset;
+        for (int i = 0; i < numChannels; ++i)
+            destinationChannelData[i] -= offset;
 
-    AudioDataConverters::deinterleaveSamples (interleavedOutputBuffer, destinationChannelData,
-                                              numSamples, numChannels);
-    for (int i = 0; i < numChannels; ++i)
-        destinationChannelData[i] -= startSampleOffset;
+        numSamplesDone += numThisChunk;
+    }
 }
 
 void SoundTouchProcessor::setPlaybackSettings (const PlaybackSettings& newSettings)
@@ -134,4 +144,19 @@ int SoundTouchProcessor::getSoundTouchSetting (int settingId)
     return soundTouch.getSetting (settingId);
 }
 
+//==============================================================================
+void SoundTouchProcessor::allocateInterleavedBuffers (int numChannels, int maxNumSamplesPerBlock)
+{
+    const int requiredBufferSize = jmax (1, maxNumSamplesPerBlock * numChannels);
+
+    if (interleavedBufferSize < requiredBufferSize)
+    {
+        // these live as long as the processor rather than a block so they're
+        // plain buffers, larger blocks are read and written in chunks
+        interleavedInputBuffer.malloc ((size_t) requiredBufferSize);
+        interleavedOutputBuffer.malloc ((size_t) requiredBufferSize);
+        interleavedBufferSize = requiredBufferSize;
+    }
+}
+
 #endif //DROWAUDIO_USE_SOUNDTOUCH
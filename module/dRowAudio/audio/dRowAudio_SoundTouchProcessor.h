@@ -80,9 +80,11 @@ public:
 
         This must be set before any processing occurs as the results are undefiend if not.
         It is the callers responsibility to make sure the numChannels parameter matches
-        those supplied to the read/write methods.
+        those supplied to the read/write methods. The internal buffers are allocated
+        here to hold maxNumSamplesPerBlock. Larger blocks are read and written in
+        chunks of this size so the read and write methods never allocate any memory.
     */
-    void initialise (int numChannels, double sampleRate);
+    void initialise (int numChannels, double sampleRate, int maxNumSamplesPerBlock = 512);
 
     /** Writes samples into the pipline ready to be processed.
 
@@ -146,7 +148,9 @@ private:
 
     CriticalSection lock;
     HeapBlock<float> interleavedInputBuffer, interleavedOutputBuffer;
-    int interleavedInputBufferSize, interleavedOutputBufferSize;
+    int interleavedBufferSize;
+
+    void allocateInterleavedBuffers (int numChannels, int maxNumSamplesPerBlock);
     PlaybackSettings settings;
 
     //==============================================================================
@@ -0,0 +1,770 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#if DROWAUDIO_USE_FFTREAL
+
+namespace MFCCHelpers
+{
+    /** Keeps the log of silent bands finite. */
+    static const float logFloor = 1.0e-10f;
+
+    /** Flags stored in the binary format. */
+    enum
+    {
+        hasFramesFlag       = 1,
+        quantisedFramesFlag = 2
+    };
+
+    /** The most coefficients a stream is trusted to hold, well beyond any real analysis. */
+    static const int maxNumCoefficients = 1024;
+
+    /** Returns true if a stream of known length is too short for a number of bytes. */
+    static bool isTooShort (InputStream& input, int64 numBytes)
+    {
+        const int64 numBytesRemaining = input.getNumBytesRemaining();
+        return numBytesRemaining >= 0 && numBytesRemaining < numBytes;
+    }
+
+    //==============================================================================
+    class AnalysisJob  : public ThreadPoolJob
+    {
+    public:
+        AnalysisJob (AudioFormatReader& reader_, const MFCCExtractor::Settings& settings_)
+            : ThreadPoolJob ("MFCCExtractor"),
+              reader (reader_), settings (settings_)
+        {
+        }
+
+        JobStatus runJob() override
+        {
+            MFCCExtractor extractor (reader.sampleRate, settings);
+            extractor.processReader (reader);
+            features = extractor.getFeatures();
+
+            return jobHasFinished;
+        }
+
+        MFCCFeatures features;
+
+    private:
+        AudioFormatReader& reader;
+        const MFCCExtractor::Settings settings;
+
+        JUCE_DECLARE_NON_COPYABLE (AnalysisJob)
+    };
+}
+
+//==============================================================================
+MelFilterBank::MelFilterBank (int fftSize, double sampleRate, int numBands,
+                              double minFrequency, double maxFrequency)
+    : numBins (fftSize / 2 + 1)
+{
+    jassert (numBands > 0 && minFrequency >= 0.0 && maxFrequency > minFrequency);
+
+    const double binWidth = sampleRate / fftSize;
+    const double minMel = melScale (minFrequency);
+    const double maxMel = melScale (jmin (maxFrequency, 0.5 * sampleRate));
+    const double melStep = (maxMel - minMel) / (numBands + 1);
+
+    for (int b = 0; b < numBands; ++b)
+    {
+        const double lower  = melScaleToFrequency (minMel + melStep * b);
+        const double centre = melScaleToFrequency (minMel + melStep * (b + 1));
+        const double upper  = melScaleToFrequency (minMel + melStep * (b + 2));
+
+        const int lowestBin = jmax (0, (int) std::ceil (lower / binWidth));
+        const int highestBin = jmin (numBins - 1, (int) std::floor (upper / binWidth));
+
+        Band band = { 0, 0, weights.size(), centre };
+
+        for (int bin = lowestBin; bin <= highestBin; ++bin)
+        {
+            const double frequency = bin * binWidth;
+            const double weight = frequency <= centre ? (frequency - lower) / (centre - lower)
+                                                      : (upper - frequency) / (upper - centre);
+
+            if (weight <= 0.0)
+            {
+                if (band.numBins == 0)
+                    continue;
+
+                break;
+            }
+
+            if (band.numBins == 0)
+                band.firstBin = bin;
+
+            weights.add ((float) weight);
+            ++band.numBins;
+        }
+
+        // low bands can be narrower than a bin, these just take the nearest one
+        if (band.numBins == 0)
+        {
+            band.firstBin = jlimit (0, numBins - 1, roundToInt (centre / binWidth));
+            band.numBins = 1;
+            weights.add (1.0f);
+        }
+
+        bands.add (band);
+    }
+}
+
+MelFilterBank::~MelFilterBank()
+{
+}
+
+double MelFilterBank::getCentreFrequency (int bandIndex) const noexcept
+{
+    return bands[bandIndex].centreFrequency;
+}
+
+void MelFilterBank::process (const float* spectrum, float* bandEnergies) const noexcept
+{
+    const float* const allWeights = weights.getRawDataPointer();
+
+    for (int b = 0; b < bands.size(); ++b)
+    {
+        const Band& band = bands.getReference (b);
+        const float* bins = spectrum + band.firstBin;
+        const float* bandWeights = allWeights + band.weightOffset;
+        float sum = 0.0f;
+
+        for (int i = 0; i < band.numBins; ++i)
+            sum += bins[i] * bandWeights[i];
+
+        bandEnergies[b] = sum;
+    }
+}
+
+//==============================================================================
+MFCCFeatures::MFCCFeatures()
+    : sampleRate (0.0),
+      fftSize (0), hopSize (0), numBands (0), numCoefficients (0),
+      numFrames (0)
+{
+}
+
+const float* MFCCFeatures::getFrame (int frameIndex) const noexcept
+{
+    jassert (hasFrames() && isPositiveAndBelow (frameIndex, numFrames));
+    return frames.getRawDataPointer() + frameIndex * numCoefficients;
+}
+
+void MFCCFeatures::writeTo (OutputStream& output, bool includeFrames, bool quantiseFrames) const
+{
+    includeFrames = includeFrames && hasFrames() && numFrames > 0;
+
+    output.write ("dmfc", 4);
+    output.writeDouble (sampleRate);
+    output.writeInt (fftSize);
+    output.writeInt (hopSize);
+    output.writeInt (numBands);
+    output.writeInt (numCoefficients);
+    output.writeInt (numFrames);
+    output.writeByte ((char) ((includeFrames ? MFCCHelpers::hasFramesFlag : 0)
+                              | (includeFrames && quantiseFrames ? MFCCHelpers::quantisedFramesFlag : 0)));
+
+    for (const Array<float>* stat : { &mean, &standardDeviation, &minimum, &maximum })
+        for (int c = 0; c < numCoefficients; ++c)
+            output.writeFloat (stat->getUnchecked (c));
+
+    if (! includeFrames)
+        return;
+
+    const float* data = frames.getRawDataPointer();
+    const int numValues = numFrames * numCoefficients;
+
+    if (! quantiseFrames)
+    {
+        for (int i = 0; i < numValues; ++i)
+            output.writeFloat (data[i]);
+
+        return;
+    }
+
+    // each coefficient is scaled to its own range over the track
+    HeapBlock<float> scales ((size_t) numCoefficients);
+
+    for (int c = 0; c < numCoefficients; ++c)
+    {
+        const float range = maximum.getUnchecked (c) - minimum.getUnchecked (c);
+        scales[c] = range > 0.0f ? 65535.0f / range : 0.0f;
+    }
+
+    for (int i = 0; i < numValues; ++i)
+    {
+        const int c = i % numCoefficients;
+        const int level = roundToInt ((data[i] - minimum.getUnchecked (c)) * scales[c]);
+        output.writeShort ((short) (jlimit (0, 65535, level) - 32768));
+    }
+}
+
+bool MFCCFeatures::readFrom (InputStream& input)
+{
+    *this = MFCCFeatures();
+
+    if (input.readByte() != 'd' || input.readByte() != 'm' || input.readByte() != 'f' || input.readByte() != 'c')
+        return false;
+
+    sampleRate = input.readDouble();
+    fftSize = input.readInt();
+    hopSize = input.readInt();
+    numBands = input.readInt();
+    numCoefficients = input.readInt();
+    numFrames = input.readInt();
+    const int flags = input.readByte();
+
+    // the counts size the arrays so check they, and the data they imply, are sane before allocating
+    if (numCoefficients <= 0 || numCoefficients > MFCCHelpers::maxNumCoefficients
+        || numFrames < 0 || numFrames > std::numeric_limits<int>::max() / numCoefficients
+        || input.isExhausted() || MFCCHelpers::isTooShort (input, (int64) numCoefficients * 4 * (int64) sizeof (float)))
+    {
+        *this = MFCCFeatures();
+        return false;
+    }
+
+    for (Array<float>* stat : { &mean, &standardDeviation, &minimum, &maximum })
+        for (int c = 0; c < numCoefficients; ++c)
+            stat->add (input.readFloat());
+
+    if ((flags & MFCCHelpers::hasFramesFlag) == 0)
+        return true;
+
+    const bool quantised = (flags & MFCCHelpers::quantisedFramesFlag) != 0;
+    const int numValues = numFrames * numCoefficients;
+
+    if (MFCCHelpers::isTooShort (input, (int64) numValues * (quantised ? 2 : 4)))
+    {
+        *this = MFCCFeatures();
+        return false;
+    }
+
+    // if the length isn't known the frames can't be allocated up front from a count
+    // that may be corrupt, so they grow as they're read until the stream runs out
+    const bool isLengthKnown = input.getNumBytesRemaining() >= 0;
+    frames.ensureStorageAllocated (isLengthKnown ? numValues : 0);
+
+    for (int i = 0; i < numValues; ++i)
+    {
+        if (! isLengthKnown && input.isExhausted())
+        {
+            *this = MFCCFeatures();
+            return false;
+        }
+
+        if (! quantised)
+        {
+            frames.add (input.readFloat());
+        }
+        else
+        {
+            const int c = i % numCoefficients;
+            const float range = maximum.getUnchecked (c) - minimum.getUnchecked (c);
+            frames.add (minimum.getUnchecked (c) + (input.readShort() + 32768) * (range / 65535.0f));
+        }
+    }
+
+    return true;
+}
+
+//==============================================================================
+MFCCExtractor::Settings::Settings() noexcept
+    : fftSizeLog2 (11), hopSize (512), numBands (40), numCoefficients (13),
+      minFrequency (20.0), maxFrequency (8000.0),
+      keepFrames (true)
+{
+}
+
+//==============================================================================
+MFCCExtractor::MFCCExtractor (double sampleRate_, const Settings& settings_)
+    : sampleRate    (sampleRate_),
+      settings      (settings_),
+      fftSize       (1 << settings.fftSizeLog2),
+      fft           (settings.fftSizeLog2),
+      window        (fftSize, Window::Hann),
+      filterBank    (fftSize, sampleRate, settings.numBands, settings.minFrequency, settings.maxFrequency),
+      inputBuffer   ((size_t) fftSize),
+      frameBuffer   ((size_t) fftSize),
+      powerBuffer   ((size_t) fftSize / 2 + 1),
+      bandBuffer    ((size_t) settings.numBands),
+      coefficients  ((size_t) settings.numCoefficients, true),
+      dctMatrix     ((size_t) (settings.numCoefficients * settings.numBands)),
+      runningMean       ((size_t) settings.numCoefficients),
+      runningVariance   ((size_t) settings.numCoefficients),
+      runningMinimum    ((size_t) settings.numCoefficients),
+      runningMaximum    ((size_t) settings.numCoefficients),
+      numBuffered   (0),
+      numFrames     (0)
+{
+    jassert (settings.hopSize > 0 && settings.hopSize <= fftSize);
+    jassert (settings.numCoefficients > 0 && settings.numCoefficients <= settings.numBands);
+
+    // orthonormal DCT-II so the coefficients have the same scale as the log energies
+    const int numBands = settings.numBands;
+
+    for (int k = 0; k < settings.numCoefficients; ++k)
+    {
+        const double scale = std::sqrt ((k == 0 ? 1.0 : 2.0) / numBands);
+
+        for (int n = 0; n < numBands; ++n)
+            dctMatrix[k * numBands + n] = (float) (scale * std::cos (MathConstants<double>::pi * k * (n + 0.5) / numBands));
+    }
+
+    reset();
+}
+
+MFCCExtractor::~MFCCExtractor()
+{
+}
+
+//==============================================================================
+void MFCCExtractor::reset()
+{
+    numBuffered = 0;
+    numFrames = 0;
+    frames.clearQuick();
+
+    for (int c = 0; c < settings.numCoefficients; ++c)
+    {
+        coefficients[c] = 0.0f;
+        runningMean[c] = 0.0;
+        runningVariance[c] = 0.0;
+        runningMinimum[c] = std::numeric_limits<float>::max();
+        runningMaximum[c] = -std::numeric_limits<float>::max();
+    }
+}
+
+int MFCCExtractor::processSamples (const float* samples, int numSamples)
+{
+    DROWAUDIO_TRACE_SCOPE ("MFCCExtractor::processSamples")
+
+    const int hopSize = jmin (settings.hopSize, fftSize);
+    const int startFrames = numFrames;
+
+    while (numSamples > 0)
+    {
+        const int numThisTime = jmin (numSamples, fftSize - numBuffered);
+        FloatVectorOperations::copy (inputBuffer + numBuffered, samples, numThisTime);
+
+        samples += numThisTime;
+        numSamples -= numThisTime;
+        numBuffered += numThisTime;
+
+        if (numBuffered == fftSize)
+        {
+            processFrame();
+
+            memmove (inputBuffer, inputBuffer + hopSize, sizeof (float) * size_t (fftSize - hopSize));
+            numBuffered -= hopSize;
+        }
+    }
+
+    return numFrames - startFrames;
+}
+
+void MFCCExtractor::processReader (AudioFormatReader& reader)
+{
+    const int numChannels = jmax (1, (int) reader.numChannels);
+    const int blockSize = 65536;
+    AudioSampleBuffer buffer (numChannels, blockSize);
+
+    for (int64 position = 0; position < reader.lengthInSamples; position += blockSize)
+    {
+        const int numThisTime = (int) jmin ((int64) blockSize, reader.lengthInSamples - position);
+        reader.read (&buffer, 0, numThisTime, position, true, true);
+
+        for (int c = 1; c < numChannels; ++c)
+            buffer.addFrom (0, 0, buffer, c, 0, numThisTime);
+
+        if (numChannels > 1)
+            buffer.applyGain (0, 0, numThisTime, 1.0f / numChannels);
+
+        processSamples (buffer.getReadPointer (0), numThisTime);
+    }
+}
+
+MFCCFeatures MFCCExtractor::getFeatures() const
+{
+    MFCCFeatures features;
+    features.sampleRate = sampleRate;
+    features.fftSize = fftSize;
+    features.hopSize = settings.hopSize;
+    features.numBands = settings.numBands;
+    features.numCoefficients = settings.numCoefficients;
+    features.numFrames = numFrames;
+
+    if (settings.keepFrames)
+        features.frames = frames;
+
+    for (int c = 0; c < settings.numCoefficients; ++c)
+    {
+        const bool hasData = numFrames > 0;
+
+        features.mean.add ((float) runningMean[c]);
+        features.standardDeviation.add (numFrames > 1 ? (float) std::sqrt (runningVariance[c] / (numFrames - 1)) : 0.0f);
+        features.minimum.add (hasData ? runningMinimum[c] : 0.0f);
+        features.maximum.add (hasData ? runningMaximum[c] : 0.0f);
+    }
+
+    return features;
+}
+
+//==============================================================================
+Array<MFCCFeatures> MFCCExtractor::processReaders (const Array<AudioFormatReader*>& readers,
+                                                   const Settings& settings, int numThreads)
+{
+    OwnedArray<MFCCHelpers::AnalysisJob> jobs;
+
+    {
+        ThreadPool pool (jmax (1, numThreads));
+
+        for (auto* reader : readers)
+        {
+            jassert (reader != nullptr);
+            pool.addJob (jobs.add (new MFCCHelpers::AnalysisJob (*reader, settings)), false);
+        }
+
+        for (auto* job : jobs)
+            pool.waitForJobToFinish (job, -1);
+    }
+
+    Array<MFCCFeatures> results;
+
+    for (auto* job : jobs)
+        results.add (job->features);
+
+    return results;
+}
+
+//==============================================================================
+void MFCCExtractor::processFrame()
+{
+    const int fftSizeHalved = fftSize / 2;
+    const int numBands = settings.numBands;
+
+    FloatVectorOperations::copy (frameBuffer, inputBuffer, fftSize);
+    window.applyWindow (frameBuffer, fftSize);
+    fft.performFFT (frameBuffer);
+
+    const SplitComplex& split = fft.getFFTBuffer();
+
+    powerBuffer[0] = split.realp[0] * split.realp[0];
+    powerBuffer[fftSizeHalved] = split.imagp[0] * split.imagp[0]; // the Nyquist bin is packed in here
+
+    for (int i = 1; i < fftSizeHalved; ++i)
+        powerBuffer[i] = split.realp[i] * split.realp[i] + split.imagp[i] * split.imagp[i];
+
+    filterBank.process (powerBuffer, bandBuffer);
+
+    for (int b = 0; b < numBands; ++b)
+        bandBuffer[b] = std::log (bandBuffer[b] + MFCCHelpers::logFloor);
+
+    for (int k = 0; k < settings.numCoefficients; ++k)
+    {
+        const float* basis = dctMatrix + k * numBands;
+        float sum = 0.0f;
+
+        for (int n = 0; n < numBands; ++n)
+            sum += basis[n] * bandBuffer[n];
+
+        coefficients[k] = sum;
+    }
+
+    ++numFrames;
+    updateStatistics();
+
+    if (settings.keepFrames)
+        frames.addArray (coefficients.getData(), settings.numCoefficients);
+}
+
+void MFCCExtractor::updateStatistics()
+{
+    // Welford's running mean and variance, runningVariance holds the sum of squared differences
+    for (int c = 0; c < settings.numCoefficients; ++c)
+    {
+        const double value = coefficients[c];
+        const double delta = value - runningMean[c];
+
+        runningMean[c] += delta / numFrames;
+        runningVariance[c] += delta * (value - runningMean[c]);
+        runningMinimum[c] = jmin (runningMinimum[c], coefficients[c]);
+        runningMaximum[c] = jmax (runningMaximum[c], coefficients[c]);
+    }
+}
+
+//==============================================================================
+#if DROWAUDIO_UNIT_TESTS
+
+class MFCCTests  : public UnitTest
+{
+public:
+    MFCCTests() : UnitTest ("MFCC") {}
+
+    void runTest()
+    {
+        beginTest ("DCT");
+        {
+            MFCCExtractor::Settings settings;
+            settings.numBands = 24;
+            settings.numCoefficients = 24;
+            MFCCExtractor extractor (44100.0, settings);
+
+            const int numBands = settings.numBands;
+            const float* const dct = extractor.dctMatrix;
+            double maxError = 0.0;
+
+            // the basis vectors are orthonormal
+            for (int j = 0; j < numBands; ++j)
+            {
+                for (int k = 0; k < numBands; ++k)
+                {
+                    double dotProduct = 0.0;
+
+                    for (int n = 0; n < numBands; ++n)
+                        dotProduct += dct[j * numBands + n] * (double) dct[k * numBands + n];
+
+                    maxError = jmax (maxError, std::abs (dotProduct - (j == k ? 1.0 : 0.0)));
+                }
+            }
+
+            expect (maxError < 1.0e-5, "DCT basis isn't orthonormal: " + String (maxError));
+
+            // so a flat set of log energies only has a DC coefficient
+            for (int k = 0; k < numBands; ++k)
+            {
+                double coefficient = 0.0;
+
+                for (int n = 0; n < numBands; ++n)
+                    coefficient += dct[k * numBands + n] * 2.0;
+
+                expectWithinAbsoluteError (coefficient, k == 0 ? 2.0 * std::sqrt ((double) numBands) : 0.0, 1.0e-4);
+            }
+        }
+
+        beginTest ("MelFilterBank");
+        {
+            const int fftSize = 1024;
+            const double sampleRate = 16000.0;
+            const double binWidth = sampleRate / fftSize;
+            MelFilterBank filterBank (fftSize, sampleRate, 20, 100.0, 6000.0);
+
+            expectEquals (filterBank.getNumBands(), 20);
+            expectEquals (filterBank.getNumBins(), fftSize / 2 + 1);
+            expect (filterBank.getNumWeights() <= 2 * filterBank.getNumBins());
+
+            // the centres are evenly spaced on the Mel scale
+            const double melStep = melScale (filterBank.getCentreFrequency (1)) - melScale (filterBank.getCentreFrequency (0));
+
+            for (int b = 1; b < filterBank.getNumBands(); ++b)
+                expectWithinAbsoluteError (melScale (filterBank.getCentreFrequency (b)) - melScale (filterBank.getCentreFrequency (b - 1)),
+                                           melStep, 1.0e-6);
+
+            // neighbouring triangles overlap so an impulse between the first and last
+            // centres is split between two bands with weights that sum to 1
+            HeapBlock<float> spectrum ((size_t) filterBank.getNumBins(), true);
+            HeapBlock<float> energies ((size_t) filterBank.getNumBands());
+            const double firstCentre = filterBank.getCentreFrequency (0);
+            const double lastCentre = filterBank.getCentreFrequency (filterBank.getNumBands() - 1);
+
+            for (int bin = 0; bin < filterBank.getNumBins(); ++bin)
+            {
+                spectrum[bin] = 1.0f;
+                filterBank.process (spectrum, energies);
+                spectrum[bin] = 0.0f;
+
+                const double frequency = bin * binWidth;
+                float sum = 0.0f;
+                int numNonZero = 0;
+
+                for (int b = 0; b < filterBank.getNumBands(); ++b)
+                {
+                    expect (energies[b] >= 0.0f && energies[b] <= 1.0f);
+                    sum += energies[b];
+                    numNonZero += energies[b] > 0.0f ? 1 : 0;
+                }
+
+                expect (numNonZero <= 2);
+
+                if (frequency >= firstCentre && frequency <= lastCentre)
+                    expectWithinAbsoluteError (sum, 1.0f, 1.0e-5f);
+                else if (frequency <= 100.0 || frequency >= 6000.0)
+                    expectEquals (sum, 0.0f);
+            }
+        }
+
+        beginTest ("Round trip");
+        {
+            MFCCFeatures features (createFeatures (3, 50));
+
+            // unquantised frames are stored exactly
+            {
+                MFCCFeatures read;
+                expect (read.readFrom (*writeFeatures (features, true, false)));
+                expectEquals (read.numFrames, features.numFrames);
+                expectEquals (read.numCoefficients, features.numCoefficients);
+                expectEquals (read.fftSize, features.fftSize);
+                expectEquals (read.sampleRate, features.sampleRate);
+                expect (read.frames == features.frames);
+                expect (read.mean == features.mean && read.standardDeviation == features.standardDeviation);
+                expect (read.minimum == features.minimum && read.maximum == features.maximum);
+            }
+
+            // quantised frames are within half a step of each coefficient's range
+            {
+                MFCCFeatures read;
+                expect (read.readFrom (*writeFeatures (features, true, true)));
+                expect (read.hasFrames());
+
+                float maxError = 0.0f;
+
+                for (int i = 0; i < features.frames.size(); ++i)
+                {
+                    const int c = i % features.numCoefficients;
+                    const float step = (features.maximum[c] - features.minimum[c]) / 65535.0f;
+                    maxError = jmax (maxError, std::abs (read.frames[i] - features.frames[i]) / step);
+                }
+
+                expect (maxError <= 0.51f, "Quantisation error too large: " + String (maxError));
+            }
+
+            // the summary alone
+            {
+                MFCCFeatures read;
+                expect (read.readFrom (*writeFeatures (features, false, false)));
+                expectEquals (read.numFrames, features.numFrames);
+                expect (! read.hasFrames());
+                expect (read.mean == features.mean);
+            }
+        }
+
+        beginTest ("Invalid streams");
+        {
+            MFCCFeatures features (createFeatures (4, 10));
+            MemoryOutputStream output;
+            features.writeTo (output, true, false);
+
+            // truncated anywhere, including in the statistics
+            for (size_t size : { (size_t) 3, (size_t) 20, (size_t) 40, output.getDataSize() - 1 })
+            {
+                MFCCFeatures read;
+                MemoryInputStream input (output.getData(), size, false);
+                expect (! read.readFrom (input));
+                expectEquals (read.numCoefficients, 0);
+                expect (read.mean.isEmpty() && read.frames.isEmpty());
+            }
+
+            // corrupt counts
+            expect (! readHeader (0, 10));
+            expect (! readHeader (-1, 10));
+            expect (! readHeader (4, -1));
+            expect (! readHeader (MFCCHelpers::maxNumCoefficients + 1, 10));
+            expect (! readHeader (1024, std::numeric_limits<int>::max() / 512));
+            expect (! readHeader (13, std::numeric_limits<int>::max()));
+            expect (readHeader (4, 0));
+        }
+    }
+
+private:
+    static MFCCFeatures createFeatures (int numCoefficients, int numFrames)
+    {
+        MFCCFeatures features;
+        features.sampleRate = 44100.0;
+        features.fftSize = 2048;
+        features.hopSize = 512;
+        features.numBands = 40;
+        features.numCoefficients = numCoefficients;
+        features.numFrames = numFrames;
+
+        Random random (0x3c1a);
+
+        for (int i = 0; i < numFrames * numCoefficients; ++i)
+            features.frames.add (random.nextFloat() * 40.0f - 20.0f);
+
+        for (int c = 0; c < numCoefficients; ++c)
+        {
+            float sum = 0.0f, minimum = features.frames[c], maximum = features.frames[c];
+
+            for (int f = 0; f < numFrames; ++f)
+            {
+                const float value = features.frames[f * numCoefficients + c];
+                sum += value;
+                minimum = jmin (minimum, value);
+                maximum = jmax (maximum, value);
+            }
+
+            features.mean.add (sum / numFrames);
+            features.standardDeviation.add (1.0f + c);
+            features.minimum.add (minimum);
+            features.maximum.add (maximum);
+        }
+
+        return features;
+    }
+
+    static std::unique_ptr<MemoryInputStream> writeFeatures (const MFCCFeatures& features, bool includeFrames, bool quantiseFrames)
+    {
+        MemoryOutputStream output;
+        features.writeTo (output, includeFrames, quantiseFrames);
+
+        return std::make_unique<MemoryInputStream> (output.getMemoryBlock(), true);
+    }
+
+    /** Reads a header with the given counts followed by enough statistics for
+        numCoefficients and a single frame's worth of data.
+    */
+    static bool readHeader (int numCoefficients, int numFrames)
+    {
+        MemoryOutputStream output;
+        output.write ("dmfc", 4);
+        output.writeDouble (44100.0);
+        output.writeInt (2048);
+        output.writeInt (512);
+        output.writeInt (40);
+        output.writeInt (numCoefficients);
+        output.writeInt (numFrames);
+        output.writeByte ((char) MFCCHelpers::hasFramesFlag);
+
+        for (int i = 0; i < 5 * jlimit (0, 2048, numCoefficients); ++i)
+            output.writeFloat (0.0f);
+
+        MFCCFeatures read;
+        MemoryInputStream input (output.getData(), output.getDataSize(), false);
+
+        return read.readFrom (input);
+    }
+};
+
+static MFCCTests mfccTests;
+
+#endif // DROWAUDIO_UNIT_TESTS
+
+#endif // DROWAUDIO_USE_FFTREAL
@@ -0,0 +1,267 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_MFCC_H
+#define DROWAUDIO_MFCC_H
+
+#if DROWAUDIO_USE_FFTREAL || defined (DOXYGEN)
+
+//==============================================================================
+/** A bank of triangular filters spaced evenly on the Mel scale.
+
+    Each band only overlaps a handful of FFT bins so the weights are stored
+    sparsely as a start bin and a run of weights per band. Applying the whole bank
+    then costs roughly two multiply-adds per bin, rather than one per bin for
+    every band as a dense matrix would.
+
+    @see MFCCExtractor, melScale
+ */
+class MelFilterBank
+{
+public:
+    //==============================================================================
+    /** Creates a filter bank for spectra from an FFT of a given size.
+
+        The band edges are spread evenly on the Mel scale between the minimum and
+        maximum frequencies, the maximum being limited to the Nyquist frequency.
+        Each band has a peak weight of 1.
+     */
+    MelFilterBank (int fftSize, double sampleRate, int numBands,
+                   double minFrequency, double maxFrequency);
+
+    /** Destructor. */
+    ~MelFilterBank();
+
+    //==============================================================================
+    /** Returns the number of bands. */
+    int getNumBands() const noexcept                { return bands.size(); }
+
+    /** Returns the number of FFT bins the spectra passed to process should contain. */
+    int getNumBins() const noexcept                 { return numBins; }
+
+    /** Returns the total number of non-zero weights across all the bands. */
+    int getNumWeights() const noexcept              { return weights.size(); }
+
+    /** Returns the centre frequency of a band in hertz. */
+    double getCentreFrequency (int bandIndex) const noexcept;
+
+    //==============================================================================
+    /** Sums a spectrum into the bands.
+
+        The spectrum should contain getNumBins() values, i.e. fftSize / 2 + 1 and
+        the bandEnergies getNumBands() values.
+     */
+    void process (const float* spectrum, float* bandEnergies) const noexcept;
+
+private:
+    //==============================================================================
+    struct Band
+    {
+        int firstBin, numBins, weightOffset;
+        double centreFrequency;
+    };
+
+    const int numBins;
+    Array<Band> bands;
+    Array<float> weights;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MelFilterBank)
+};
+
+//==============================================================================
+/** Holds the MFCCs of a track along with some summary statistics of them.
+
+    These can be written to and read from a compact binary stream. The frames can
+    optionally be quantised to 16 bits per coefficient, relative to the range of
+    each coefficient over the track, which halves their size with an error well
+    below that of the analysis itself.
+
+    @see MFCCExtractor
+ */
+struct MFCCFeatures
+{
+    /** Creates an empty set of features. */
+    MFCCFeatures();
+
+    /** Returns the coefficients of a frame.
+        This will only be valid if the frames were kept during the analysis.
+     */
+    const float* getFrame (int frameIndex) const noexcept;
+
+    /** Returns true if the individual frames are held as well as the summary. */
+    bool hasFrames() const noexcept             { return frames.size() == numFrames * numCoefficients; }
+
+    /** Writes the features to a stream.
+        If includeFrames is false only the settings and summary statistics are written.
+     */
+    void writeTo (OutputStream& output, bool includeFrames = true, bool quantiseFrames = true) const;
+
+    /** Reads some features previously written with writeTo.
+        Returns false if the stream didn't contain valid data, including when the
+        counts it holds are larger than the stream could contain.
+     */
+    bool readFrom (InputStream& input);
+
+    //==============================================================================
+    /** The settings the features were extracted with. */
+    double sampleRate;
+    int fftSize, hopSize, numBands, numCoefficients;
+
+    /** The number of frames that were analysed. */
+    int numFrames;
+
+    /** The coefficients of each frame, interleaved frame by frame. */
+    Array<float> frames;
+
+    /** The per-coefficient statistics over the whole track. */
+    Array<float> mean, standardDeviation, minimum, maximum;
+};
+
+//==============================================================================
+/** Extracts Mel-frequency cepstral coefficients from a signal.
+
+    Each frame is windowed and transformed, the power spectrum summed into a
+    MelFilterBank, log compressed and then decorrelated with a DCT-II to give the
+    coefficients. The filter bank is sparse and the DCT a small precomputed
+    matrix so the cost of each frame is dominated by the FFT itself.
+
+    Samples can be streamed in blocks of any size with processSamples, or whole
+    readers analysed with processReader. For analysing a whole library use
+    processReaders which runs each reader on a ThreadPool.
+
+    @code
+        MFCCExtractor extractor (44100.0);
+        extractor.processSamples (monoSamples, numSamples);
+
+        MFCCFeatures features (extractor.getFeatures());
+        FileOutputStream output (featureFile);
+        features.writeTo (output);
+    @endcode
+ */
+class MFCCExtractor
+{
+public:
+    //==============================================================================
+    /** The analysis settings. */
+    struct Settings
+    {
+        /** Creates the default settings.
+            These are a 2048 sample FFT with a 512 sample hop, 40 bands between
+            20Hz and 8KHz and 13 coefficients.
+         */
+        Settings() noexcept;
+
+        int fftSizeLog2, hopSize, numBands, numCoefficients;
+        double minFrequency, maxFrequency;
+
+        /** If false only the summary statistics are kept which avoids storing
+            every frame of long tracks.
+         */
+        bool keepFrames;
+    };
+
+    //==============================================================================
+    /** Creates an extractor for a given sample rate. */
+    MFCCExtractor (double sampleRate, const Settings& settings = Settings());
+
+    /** Destructor. */
+    ~MFCCExtractor();
+
+    //==============================================================================
+    /** Clears any buffered samples, frames and statistics. */
+    void reset();
+
+    /** Adds a block of mono samples to the analysis.
+
+        A frame is analysed every hop once a full FFT's worth of samples has been
+        collected. Returns the number of frames completed by this block, the last
+        of which is available from getLastFrame().
+     */
+    int processSamples (const float* samples, int numSamples);
+
+    /** Mixes down and analyses the whole of an AudioFormatReader. */
+    void processReader (AudioFormatReader& reader);
+
+    //==============================================================================
+    /** Returns the number of frames analysed so far. */
+    int getNumFrames() const noexcept                   { return numFrames; }
+
+    /** Returns the coefficients of the most recently analysed frame. */
+    const float* getLastFrame() const noexcept          { return coefficients; }
+
+    /** Returns the number of coefficients in each frame. */
+    int getNumCoefficients() const noexcept             { return settings.numCoefficients; }
+
+    /** Returns the filter bank being used. */
+    const MelFilterBank& getFilterBank() const noexcept { return filterBank; }
+
+    /** Returns the features of all the samples analysed so far. */
+    MFCCFeatures getFeatures() const;
+
+    //==============================================================================
+    /** Analyses a number of readers concurrently on a ThreadPool.
+
+        Each reader is analysed by a single job so must not be shared with any other
+        thread until this returns. The features are returned in the same order as
+        the readers, using each reader's own sample rate.
+     */
+    static Array<MFCCFeatures> processReaders (const Array<AudioFormatReader*>& readers,
+                                               const Settings& settings = Settings(),
+                                               int numThreads = 4);
+
+private:
+    //==============================================================================
+    const double sampleRate;
+    const Settings settings;
+    const int fftSize;
+
+    FFT fft;
+    Window window;
+    MelFilterBank filterBank;
+
+    HeapBlock<float> inputBuffer, frameBuffer, powerBuffer, bandBuffer, coefficients, dctMatrix;
+    HeapBlock<double> runningMean, runningVariance;
+    HeapBlock<float> runningMinimum, runningMaximum;
+    Array<float> frames;
+    int numBuffered, numFrames;
+
+    void processFrame();
+    void updateStatistics();
+
+    friend class MFCCTests;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (MFCCExtractor)
+};
+
+#endif
+#endif  // DROWAUDIO_MFCC_H
@@ -0,0 +1,318 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#if DROWAUDIO_USE_FFTREAL
+
+namespace TempogramHelpers
+{
+    /** Returns the log2 of the smallest power of two that is at least minSize. */
+    static int getFFTSizeLog2 (int minSize) noexcept
+    {
+        int sizeLog2 = 1;
+
+        while ((1 << sizeLog2) < minSize)
+            ++sizeLog2;
+
+        return sizeLog2;
+    }
+
+    /** Perceptual weighting of tempo, a log-normal curve centred on 120 BPM with
+        a standard deviation of one octave. This resolves most of the ambiguity
+        between a tempo and its multiples which all show up in the autocorrelation.
+     */
+    static float getTempoWeight (double bpm) noexcept
+    {
+        const double octaves = std::log2 (bpm / 120.0);
+        return (float) std::exp (-0.5 * octaves * octaves);
+    }
+}
+
+//==============================================================================
+Tempogram::Tempogram (double sampleRate_, double windowSeconds, double hopSeconds)
+    : sampleRate        (sampleRate_),
+      hopSize           (jmax (1, roundToInt (sampleRate / 100.0))),
+      envelopeRate      (sampleRate / hopSize),
+      windowLength      (jmax (4, roundToInt (windowSeconds * envelopeRate))),
+      windowHop         (jmax (1, roundToInt (hopSeconds * envelopeRate))),
+      minBpm            (60.0),
+      maxBpm            (200.0),
+      minLag            (0),
+      maxLag            (0),
+      fft               (TempogramHelpers::getFFTSizeLog2 (2 * windowLength)),
+      windowBuffer      ((size_t) fft.getProperties().fftSize),
+      spectrumBuffer    ((size_t) fft.getProperties().fftSize),
+      lagWeights        ((size_t) fft.getProperties().fftSizeHalved + 1),
+      nextWindowStart   (0),
+      analysedEnd       (0),
+      hopPosition       (0),
+      hopEnergy         (0.0f),
+      lastLogEnergy     (0.0f)
+{
+    updateLagWeights();
+}
+
+Tempogram::~Tempogram()
+{
+}
+
+//==============================================================================
+void Tempogram::setBpmRange (double minimumBpm, double maximumBpm)
+{
+    jassert (minimumBpm > 0.0 && maximumBpm > minimumBpm);
+
+    minBpm = minimumBpm;
+    maxBpm = maximumBpm;
+    updateLagWeights();
+
+    estimates.clearQuick();
+    nextWindowStart = 0;
+    analysedEnd = 0;
+    analyseCompleteWindows();
+}
+
+void Tempogram::reset()
+{
+    envelope.clearQuick();
+    estimates.clearQuick();
+    nextWindowStart = 0;
+    analysedEnd = 0;
+    hopPosition = 0;
+    hopEnergy = 0.0f;
+    lastLogEnergy = 0.0f;
+}
+
+//==============================================================================
+void Tempogram::processSamples (const float* samples, int numSamples)
+{
+    while (numSamples > 0)
+    {
+        const int numThisTime = jmin (numSamples, hopSize - hopPosition);
+
+        for (int i = 0; i < numThisTime; ++i)
+            hopEnergy += samples[i] * samples[i];
+
+        samples += numThisTime;
+        numSamples -= numThisTime;
+        hopPosition += numThisTime;
+
+        if (hopPosition == hopSize)
+        {
+            // half-wave rectified change in log energy, the floor stops silence adding noise
+            const float logEnergy = std::log (hopEnergy / hopSize + 1.0e-9f);
+            envelope.add (envelope.isEmpty() ? 0.0f : jmax (0.0f, logEnergy - lastLogEnergy));
+
+            lastLogEnergy = logEnergy;
+            hopEnergy = 0.0f;
+            hopPosition = 0;
+        }
+    }
+
+    analyseCompleteWindows();
+}
+
+void Tempogram::processReader (AudioFormatReader& reader)
+{
+    const int numChannels = jmax (1, (int) reader.numChannels);
+    const int blockSize = 65536;
+    AudioSampleBuffer buffer (numChannels, blockSize);
+
+    for (int64 position = 0; position < reader.lengthInSamples; position += blockSize)
+    {
+        const int numThisTime = (int) jmin ((int64) blockSize, reader.lengthInSamples - position);
+        reader.read (&buffer, 0, numThisTime, position, true, true);
+
+        for (int c = 1; c < numChannels; ++c)
+            buffer.addFrom (0, 0, buffer, c, 0, numThisTime);
+
+        if (numChannels > 1)
+            buffer.applyGain (0, 0, numThisTime, 1.0f / numChannels);
+
+        processSamples (buffer.getReadPointer (0), numThisTime);
+    }
+
+    finish();
+}
+
+void Tempogram::finish()
+{
+    const int numFrames = envelope.size();
+
+    if (numFrames <= analysedEnd)
+        return;
+
+    // the last window is aligned to the end of the track and needs to be at least
+    // long enough to hold a couple of periods of the slowest tempo
+    const int start = jmax (0, numFrames - windowLength);
+
+    if (numFrames - start > 2 * minLag)
+        analyseWindow (start, numFrames - start);
+
+    analysedEnd = numFrames;
+}
+
+//==============================================================================
+double Tempogram::getGlobalBpm() const
+{
+    Array<TempoEstimate> sorted (estimates);
+    double totalConfidence = 0.0;
+
+    for (auto& e : sorted)
+        totalConfidence += e.confidence;
+
+    if (totalConfidence <= 0.0)
+        return 0.0;
+
+    std::sort (sorted.begin(), sorted.end(),
+               [] (const TempoEstimate& a, const TempoEstimate& b) { return a.bpm < b.bpm; });
+
+    double runningConfidence = 0.0;
+
+    for (auto& e : sorted)
+    {
+        runningConfidence += e.confidence;
+
+        if (runningConfidence >= 0.5 * totalConfidence)
+            return e.bpm;
+    }
+
+    return sorted.getLast().bpm;
+}
+
+//==============================================================================
+void Tempogram::updateLagWeights()
+{
+    const int numLags = fft.getProperties().fftSizeHalved + 1;
+
+    minLag = jmax (2, (int) std::floor (60.0 * envelopeRate / maxBpm));
+    maxLag = jmin (numLags - 2, (int) std::ceil (60.0 * envelopeRate / minBpm));
+
+    for (int lag = 0; lag < numLags; ++lag)
+        lagWeights[lag] = (lag >= minLag && lag <= maxLag)
+                            ? TempogramHelpers::getTempoWeight (60.0 * envelopeRate / lag)
+                            : 0.0f;
+}
+
+void Tempogram::analyseCompleteWindows()
+{
+    while (nextWindowStart + windowLength <= envelope.size())
+    {
+        analyseWindow (nextWindowStart, windowLength);
+        analysedEnd = nextWindowStart + windowLength;
+        nextWindowStart += windowHop;
+    }
+}
+
+void Tempogram::analyseWindow (int start, int length)
+{
+    const int fftSize = fft.getProperties().fftSize;
+    const int fftSizeHalved = fft.getProperties().fftSizeHalved;
+    const float* frames = envelope.getRawDataPointer() + start;
+
+    // onsets are only a frame or two wide so smooth them a little, otherwise periods
+    // that fall between two lags lose out to their better aligned multiples
+    float mean = 0.0f;
+
+    for (int i = 0; i < length; ++i)
+    {
+        const float previous = frames[jmax (0, i - 1)];
+        const float next = frames[jmin (length - 1, i + 1)];
+
+        windowBuffer[i] = 0.25f * previous + 0.5f * frames[i] + 0.25f * next;
+        mean += windowBuffer[i];
+    }
+
+    // remove the mean and zero pad to twice the length so the correlation isn't circular
+    mean /= length;
+
+    for (int i = 0; i < length; ++i)
+        windowBuffer[i] -= mean;
+
+    zeromem (windowBuffer + length, sizeof (float) * size_t (fftSize - length));
+
+    // the autocorrelation is the inverse transform of the power spectrum
+    fft.performFFT (windowBuffer);
+
+    const SplitComplex& split = fft.getFFTBuffer();
+    float* powerReal = spectrumBuffer;
+    float* powerImag = spectrumBuffer + fftSizeHalved;
+
+    powerReal[0] = split.realp[0] * split.realp[0];
+    powerImag[0] = split.imagp[0] * split.imagp[0]; // the Nyquist bin is packed in here
+
+    for (int i = 1; i < fftSizeHalved; ++i)
+    {
+        powerReal[i] = split.realp[i] * split.realp[i] + split.imagp[i] * split.imagp[i];
+        powerImag[i] = 0.0f;
+    }
+
+    fft.performIFFT (spectrumBuffer);
+    const float* correlation = fft.getBuffer();
+
+    if (correlation[0] <= 0.0f)
+        return;
+
+    // normalise each lag for the number of frames that overlap and by the energy
+    const int lastLag = jmin (maxLag, length / 2);
+    int bestLag = -1;
+    float bestScore = 0.0f;
+
+    for (int lag = minLag; lag <= lastLag; ++lag)
+    {
+        const float score = lagWeights[lag] * correlation[lag] / (length - lag);
+
+        if (score > bestScore)
+        {
+            bestScore = score;
+            bestLag = lag;
+        }
+    }
+
+    if (bestLag < 0)
+        return;
+
+    // refine the peak with a parabola through its unweighted neighbours
+    auto normalised = [&] (int lag) { return correlation[lag] * length / ((length - lag) * correlation[0]); };
+
+    const float before = normalised (bestLag - 1);
+    const float peak = normalised (bestLag);
+    const float after = normalised (bestLag + 1);
+    const float denominator = before - 2.0f * peak + after;
+    const double offset = (denominator < 0.0f) ? jlimit (-0.5, 0.5, 0.5 * (before - after) / denominator) : 0.0;
+
+    TempoEstimate estimate;
+    estimate.time = (start + 0.5 * length) / envelopeRate;
+    estimate.bpm = 60.0 * envelopeRate / (bestLag + offset);
+    estimate.confidence = jlimit (0.0, 1.0, (double) peak);
+
+    estimates.add (estimate);
+}
+
+#endif //DROWAUDIO_USE_FFTREAL
@@ -0,0 +1,155 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_TEMPOGRAM_H
+#define DROWAUDIO_TEMPOGRAM_H
+
+#if DROWAUDIO_USE_FFTREAL || defined (DOXYGEN)
+
+//==============================================================================
+/** Estimates the tempo of a signal over time using an autocorrelation tempogram.
+
+    The incoming samples are reduced to an onset envelope of roughly 100 frames
+    per second (the half-wave rectified difference of the log energy of each hop).
+    The envelope is then cut into overlapping analysis windows and the
+    autocorrelation of each window is calculated via an FFT, the peak of this in
+    the allowed tempo range giving the local tempo.
+
+    This gives a tempo curve for tracks that drift or change tempo as well as a
+    global estimate, which is the confidence weighted median of the local tempos.
+    As the correlation is done on a heavily decimated envelope and in the
+    frequency domain this is much faster than soundtouch::BPMDetect, which
+    correlates every envelope sample directly against its whole lag range.
+
+    @code
+        Tempogram tempogram (44100.0);
+        tempogram.processSamples (monoSamples, numSamples);
+        tempogram.finish();
+
+        const double bpm = tempogram.getGlobalBpm();
+    @endcode
+ */
+class Tempogram
+{
+public:
+    //==============================================================================
+    /** Holds the tempo found for one analysis window. */
+    struct TempoEstimate
+    {
+        /** The centre of the analysis window in seconds. */
+        double time;
+
+        /** The tempo in beats per minute. */
+        double bpm;
+
+        /** The normalised autocorrelation at the chosen lag, 0 to 1. */
+        double confidence;
+    };
+
+    //==============================================================================
+    /** Creates a Tempogram for a given sample rate.
+
+        The window length sets how many seconds of the envelope are used for each
+        local estimate and the hop how far apart these are. Longer windows give more
+        stable estimates but will follow tempo changes less closely.
+     */
+    Tempogram (double sampleRate, double windowSeconds = 8.0, double hopSeconds = 2.0);
+
+    /** Destructor. */
+    ~Tempogram();
+
+    //==============================================================================
+    /** Sets the range of tempos that will be looked for.
+        The default is 60 to 200 BPM. Any results so far will be recalculated from
+        the samples already added.
+     */
+    void setBpmRange (double minimumBpm, double maximumBpm);
+
+    /** Clears all the samples and results so far. */
+    void reset();
+
+    //==============================================================================
+    /** Adds a block of mono samples to the analysis.
+        Any analysis windows that have been completed are processed straight away.
+     */
+    void processSamples (const float* samples, int numSamples);
+
+    /** Mixes down and analyses the whole of an AudioFormatReader and then calls finish(). */
+    void processReader (AudioFormatReader& reader);
+
+    /** Analyses any samples left over at the end of the track.
+        Call this once all the samples have been added so that the last partial
+        window and tracks shorter than a single window still get an estimate.
+     */
+    void finish();
+
+    //==============================================================================
+    /** Returns the tempo of each analysis window in time order. */
+    const Array<TempoEstimate>& getTempoEstimates() const noexcept   { return estimates; }
+
+    /** Returns the tempo of the whole track.
+
+        This is the median of the local estimates weighted by their confidence so
+        is robust against sections with no clear beat and tempo drift.
+        Returns 0 if no estimate could be made.
+     */
+    double getGlobalBpm() const;
+
+    /** Returns the rate of the onset envelope in frames per second. */
+    double getEnvelopeRate() const noexcept                         { return envelopeRate; }
+
+private:
+    //==============================================================================
+    const double sampleRate;
+    const int hopSize;
+    const double envelopeRate;
+    const int windowLength, windowHop;
+    double minBpm, maxBpm;
+    int minLag, maxLag;
+
+    FFT fft;
+    HeapBlock<float> windowBuffer, spectrumBuffer, lagWeights;
+
+    Array<float> envelope;
+    Array<TempoEstimate> estimates;
+    int nextWindowStart, analysedEnd, hopPosition;
+    float hopEnergy, lastLogEnergy;
+
+    void updateLagWeights();
+    void analyseCompleteWindows();
+    void analyseWindow (int start, int length);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (Tempogram)
+};
+
+#endif
+#endif  // DROWAUDIO_TEMPOGRAM_H
@@ -30,24 +30,112 @@
 */
 
 //==============================================================================
+BiquadFilter::BiquadFilter() noexcept
+    : resetPending (false),
+      v1 (0.0f), v2 (0.0f)
+{
+}
+
+BiquadFilter::BiquadFilter (const BiquadFilter& other) noexcept
+    : coefficientSets (other.coefficientSets.getLatest()),
+      resetPending (false),
+      v1 (0.0f), v2 (0.0f)
+{
+}
+
+BiquadFilter::~BiquadFilter() noexcept
+{
+}
+
+//==============================================================================
+void BiquadFilter::setCoefficients (const IIRCoefficients& newCoefficients) noexcept
+{
+    CoefficientSet newSet;
+    memcpy (newSet.coefficients, newCoefficients.coefficients, sizeof (newSet.coefficients));
+    newSet.active = true;
+
+    coefficientSets.set (newSet);
+}
+
+IIRCoefficients BiquadFilter::getCoefficients() const noexcept
+{
+    const CoefficientSet latest (coefficientSets.getLatest());
+
+    IIRCoefficients result;
+    memcpy (result.coefficients, latest.coefficients, sizeof (latest.coefficients));
+
+    return result;
+}
+
+void BiquadFilter::makeInactive() noexcept
+{
+    CoefficientSet newSet;
+    zerostruct (newSet);
+
+    coefficientSets.set (newSet);
+}
+
+void BiquadFilter::reset() noexcept
+{
+    resetPending = true;
+}
+
+//==============================================================================
+void BiquadFilter::updateCoefficients() noexcept
+{
+    coefficientSets.update();
+
+    if (resetPending.exchange (false))
+        v1 = v2 = 0.0f;
+}
+
+const BiquadFilter::CoefficientSet& BiquadFilter::startBlock() noexcept
+{
+    updateCoefficients();
+    return coefficientSets.get();
+}
+
 void BiquadFilter::processSamples (float* const samples,
                                    const int numSamples) noexcept
 {
-    IIRFilter::processSamples (samples, numSamples);
+    const CoefficientSet& set = startBlock();
+
+    if (set.active)
+    {
+        const float c0 = set.coefficients[0];
+        const float c1 = set.coefficients[1];
+        const float c2 = set.coefficients[2];
+        const float c3 = set.coefficients[3];
+        const float c4 = set.coefficients[4];
+        float lv1 = v1, lv2 = v2;
+
+        for (int i = 0; i < numSamples; ++i)
+        {
+            const float in = samples[i];
+            const float out = c0 * in + lv1;
+            samples[i] = out;
+
+            lv1 = c1 * in - c3 * out + lv2;
+            lv2 = c2 * in - c4 * out;
+        }
+
+        JUCE_SNAP_TO_ZERO (lv1);  v1 = lv1;
+        JUCE_SNAP_TO_ZERO (lv2);  v2 = lv2;
+    }
 }
 
 void BiquadFilter::processSamples (int* const samples,
                                    const int numSamples) noexcept
 {
-    const SpinLock::ScopedLockType sl (processLock);
+    const CoefficientSet& set = startBlock();
 
-    if (active)
+    if (set.active)
     {
-        const float c0 = coefficients.coefficients[0];
-        const float c1 = coefficients.coefficients[1];
-        const float c2 = coefficients.coefficients[2];
-        const float c3 = coefficients.coefficients[3];
-        const float c4 = coefficients.coefficients[4];
+        const float c0 = set.coefficients[0];
+        const float c1 = set.coefficients[1];
+        const float c2 = set.coefficients[2];
+        const float c3 = set.coefficients[3];
+        const float c4 = set.coefficients[4];
         float lv1 = v1, lv2 = v2;
 
         for (int i = 0; i < numSamples; ++i)
@@ -65,6 +153,22 @@ void BiquadFilter::processSamples (int* const samples,
     }
 }
 
+float BiquadFilter::processSingleSampleRaw (const float in) noexcept
+{
+    const CoefficientSet& set = coefficientSets.get();
+
+    if (! set.active)
+        return in;
+
+    float out = set.coefficients[0] * in + v1;
+    JUCE_SNAP_TO_ZERO (out);
+
+    v1 = set.coefficients[1] * in - set.coefficients[3] * out + v2;
+    v2 = set.coefficients[2] * in - set.coefficients[4] * out;
+
+    return out;
+}
+
 IIRCoefficients BiquadFilter::makeLowPass (const double sampleRate,
                                            const double frequency,
                                            const double Q) noexcept
@@ -188,6 +292,7 @@ IIRCoefficients BiquadFilter::makeAllpass (const double sampleRate,
 
 void BiquadFilter::copyOutputsFrom (const BiquadFilter& other) noexcept
 {
+    resetPending = false;
     v1 = other.v1;
     v2 = other.v2;
 }
@@ -32,17 +32,57 @@
 #ifndef DROWAUDIO_BIQUADFILTER_H
 #define DROWAUDIO_BIQUADFILTER_H
 
+#include "../../utility/dRowAudio_DoubleBufferedValue.h"
+
 //==============================================================================
 /** A Biquad filter.
 
-    This filter is a subclass of the Juce IIR filter but uses
-    some additional methods to give more filter designs.
+    This has the same interface as the Juce IIRFilter but uses some additional
+    methods to give more filter designs.
+
+    The coefficients can be changed from any thread while the filter is being
+    processed. They are double buffered and swapped in at the start of the next
+    processSamples call so the processing never takes a lock, e.g. a UI control
+    can be dragged without ever holding up the audio thread.
+
+    @see DoubleBufferedValue
  */
-class BiquadFilter : public IIRFilter
+class BiquadFilter
 {
 public:
     //==============================================================================
-    /** Performs the filter operation on the given set of int samples.
+    /** Creates an inactive filter.
+        This will not perform any filtering until setCoefficients is called.
+     */
+    BiquadFilter() noexcept;
+
+    /** Creates a copy of another filter's coefficients, the state is cleared. */
+    BiquadFilter (const BiquadFilter& other) noexcept;
+
+    /** Destructor. */
+    ~BiquadFilter() noexcept;
+
+    //==============================================================================
+    /** Applies a set of coefficients to this filter.
+        This can be called from any thread, the coefficients are picked up at the
+        start of the next block to be processed.
+     */
+    void setCoefficients (const IIRCoefficients& newCoefficients) noexcept;
+
+    /** Returns the coefficients most recently set. */
+    IIRCoefficients getCoefficients() const noexcept;
+
+    /** Clears the filter so that any incoming data passes through unchanged. */
+    void makeInactive() noexcept;
+
+    /** Resets the filter's processing pipeline, ready to start a new stream of data.
+        If this is called while the filter is being processed on another thread the
+        state will be cleared at the start of the next block.
+     */
+    void reset() noexcept;
+
+    //==============================================================================
+    /** Performs the filter operation on the given set of float samples.
      */
     void processSamples (float* samples,
                          int numSamples) noexcept;
@@ -52,6 +92,18 @@ public:
     void processSamples (int* samples,
                          int numSamples) noexcept;
 
+    /** Picks up any coefficients set, or reset requested, since the last block.
+        processSamples() does this itself. Call it once before each block of
+        processSingleSampleRaw() calls, from the thread that processes the filter.
+     */
+    void updateCoefficients() noexcept;
+
+    /** Processes a single sample, without any locking or checking.
+        This uses the coefficients picked up by the last call to processSamples() or
+        updateCoefficients().
+     */
+    float processSingleSampleRaw (float sample) noexcept;
+
     //==============================================================================
     /**    Makes the filter a Low-pass filter. */
     static IIRCoefficients makeLowPass (const double sampleRate,
@@ -93,6 +145,19 @@ public:
     void copyOutputsFrom (const BiquadFilter& other) noexcept;
 
 private:
+    //==============================================================================
+    struct CoefficientSet
+    {
+        float coefficients[5];
+        bool active;
+    };
+
+    DoubleBufferedValue<CoefficientSet> coefficientSets;
+    std::atomic<bool> resetPending;
+    float v1, v2;
+
+    const CoefficientSet& startBlock() noexcept;
+
     //==============================================================================
     JUCE_LEAK_DETECTOR (BiquadFilter)
 };
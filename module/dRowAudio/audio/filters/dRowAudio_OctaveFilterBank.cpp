@@ -0,0 +1,347 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+namespace OctaveFilterBankHelpers
+{
+    /** Octaves centred above this fraction of the sample rate are too close to the
+        Nyquist frequency for the octave below to be decimated cleanly, so these
+        are run at the full rate with their own coefficients.
+     */
+    static const double maxDecimatedCentre = 0.2;
+
+    /** Returns the ratio of the highest band centre in an octave to the octave's centre. */
+    static double getTopBandRatio (int bandsPerOctave) noexcept
+    {
+        return std::pow (2.0, (bandsPerOctave / 2) / (double) bandsPerOctave);
+    }
+
+    /** Returns the highest base-two octave centre whose top band fits below the Nyquist frequency. */
+    static double getTopCentreFrequency (double sampleRate, int bandsPerOctave) noexcept
+    {
+        const double maxTopBand = 0.46 * sampleRate;
+        return 1000.0 * std::pow (2.0, std::floor (std::log2 (maxTopBand / (1000.0 * getTopBandRatio (bandsPerOctave)))));
+    }
+
+    static int getNumFullRateOctaves (double sampleRate, int bandsPerOctave, int numOctaves) noexcept
+    {
+        const double topCentre = getTopCentreFrequency (sampleRate, bandsPerOctave);
+        int numFullRate = 0;
+
+        while (numFullRate < numOctaves && topCentre / (1 << numFullRate) > maxDecimatedCentre * sampleRate)
+            ++numFullRate;
+
+        return numFullRate;
+    }
+
+    static inline void snapToZero (float& value) noexcept
+    {
+        if (! (std::abs (value) > 1.0e-15f))
+            value = 0.0f;
+    }
+}
+
+//==============================================================================
+OctaveFilterBank::OctaveFilterBank (double sampleRate_, int bandsPerOctave_, int numOctaves_)
+    : sampleRate            (sampleRate_),
+      bandsPerOctave        (bandsPerOctave_ == 1 ? 1 : 3),
+      numOctaves            (jmax (1, numOctaves_)),
+      numFullRateOctaves    (OctaveFilterBankHelpers::getNumFullRateOctaves (sampleRate, bandsPerOctave, numOctaves)),
+      topCentreFrequency    (OctaveFilterBankHelpers::getTopCentreFrequency (sampleRate, bandsPerOctave)),
+      integrationTime       (0.125),
+      decimatedBufferSize   (0)
+{
+    jassert (bandsPerOctave_ == 1 || bandsPerOctave_ == 3);
+
+    // the octaves near the top each have their own coefficients, every octave after
+    // that has the same ones as it runs at half the rate of the one above
+    for (int o = 0; o <= jmin (numFullRateOctaves, numOctaves - 1); ++o)
+        bandCoefficients.add (createBandCoefficients (sampleRate, topCentreFrequency / (1 << o)));
+
+    octaves.calloc ((size_t) numOctaves);
+
+    for (int o = 0; o < numOctaves; ++o)
+    {
+        octaves[o].coefficientsIndex = jmin (o, numFullRateOctaves);
+        octaves[o].sampleRate = sampleRate / (1 << jmax (0, o - numFullRateOctaves));
+    }
+
+    // a sixth order Butterworth low-pass keeping the top band of the next octave
+    // down and rejecting what would alias into it
+    const double decimatedCentre = topCentreFrequency / (1 << numFullRateOctaves);
+    const double cutoff = 0.9 * decimatedCentre;
+    const double qs[numDecimatorSections] = { 0.51764, 0.70711, 1.93185 };
+
+    for (int s = 0; s < numDecimatorSections; ++s)
+        decimatorCoefficients[s] = BiquadFilter::makeLowPass (sampleRate, cutoff, qs[s]);
+
+    decimators.calloc ((size_t) jmax (1, numOctaves - numFullRateOctaves - 1));
+    levels.calloc ((size_t) getNumBands());
+}
+
+OctaveFilterBank::~OctaveFilterBank()
+{
+}
+
+//==============================================================================
+void OctaveFilterBank::prepare (int maximumBlockSize)
+{
+    const int numDecimators = jmax (1, numOctaves - numFullRateOctaves - 1);
+
+    jassert (maximumBlockSize > 0);
+
+    // processSamples() works through blocks of up to 2 * (decimatedBufferSize - 1)
+    // samples, so this must be at least 2 for it to make any progress
+    decimatedBufferSize = jmax (2, maximumBlockSize / 2 + 1);
+    decimatedBuffers.malloc ((size_t) (numDecimators * decimatedBufferSize));
+
+    reset();
+}
+
+void OctaveFilterBank::reset() noexcept
+{
+    for (int o = 0; o < numOctaves; ++o)
+    {
+        OctaveState& octave = octaves[o];
+        zeromem (octave.z1, sizeof (octave.z1));
+        zeromem (octave.z2, sizeof (octave.z2));
+        zeromem (octave.meanSquare, sizeof (octave.meanSquare));
+    }
+
+    for (int d = 0; d < jmax (1, numOctaves - numFullRateOctaves - 1); ++d)
+    {
+        DecimatorState& decimator = decimators[d];
+        zeromem (decimator.z1, sizeof (decimator.z1));
+        zeromem (decimator.z2, sizeof (decimator.z2));
+        decimator.skipNext = false;
+    }
+
+    for (int b = 0; b < getNumBands(); ++b)
+        levels[b].store (0.0f);
+}
+
+void OctaveFilterBank::setIntegrationTime (double seconds) noexcept
+{
+    integrationTime = jmax (0.001, seconds);
+}
+
+//==============================================================================
+void OctaveFilterBank::processSamples (const float* samples, int numSamples) noexcept
+{
+    DROWAUDIO_TRACE_SCOPE ("OctaveFilterBank::processSamples")
+
+    jassert (decimatedBufferSize > 0); // call prepare first!
+
+    if (decimatedBufferSize <= 0)
+        return;
+
+    const int maxBlockSize = 2 * (decimatedBufferSize - 1);
+
+    while (numSamples > 0)
+    {
+        const int numThisTime = jmin (numSamples, maxBlockSize);
+
+        for (int o = 0; o < numFullRateOctaves; ++o)
+            processOctave (octaves[o], samples, numThisTime);
+
+        const float* input = samples;
+        int numInput = numThisTime;
+
+        for (int o = numFullRateOctaves; o < numOctaves; ++o)
+        {
+            processOctave (octaves[o], input, numInput);
+
+            if (o + 1 < numOctaves)
+            {
+                const int decimatorIndex = o - numFullRateOctaves;
+                float* const dest = decimatedBuffers + decimatorIndex * decimatedBufferSize;
+
+                numInput = decimate (decimators[decimatorIndex], input, numInput, dest);
+                input = dest;
+            }
+        }
+
+        samples += numThisTime;
+        numSamples -= numThisTime;
+    }
+
+    // the octaves run from the top down but the bands are numbered from the bottom up
+    for (int o = 0; o < numOctaves; ++o)
+        for (int j = 0; j < bandsPerOctave; ++j)
+            levels[(numOctaves - 1 - o) * bandsPerOctave + j].store (octaves[o].meanSquare[j], std::memory_order_relaxed);
+}
+
+//==============================================================================
+double OctaveFilterBank::getBandCentreFrequency (int bandIndex) const noexcept
+{
+    jassert (isPositiveAndBelow (bandIndex, getNumBands()));
+
+    const int octave = numOctaves - 1 - bandIndex / bandsPerOctave;
+    const int lane = bandIndex % bandsPerOctave;
+
+    return topCentreFrequency / (1 << octave) * std::pow (2.0, (lane - (bandsPerOctave - 1) / 2) / (double) bandsPerOctave);
+}
+
+float OctaveFilterBank::getBandLevel (int bandIndex) const noexcept
+{
+    if (! isPositiveAndBelow (bandIndex, getNumBands()))
+        return 0.0f;
+
+    return std::sqrt (levels[bandIndex].load (std::memory_order_relaxed));
+}
+
+void OctaveFilterBank::getBandLevels (float* destLevels) const noexcept
+{
+    for (int b = 0; b < getNumBands(); ++b)
+        destLevels[b] = std::sqrt (levels[b].load (std::memory_order_relaxed));
+}
+
+//==============================================================================
+OctaveFilterBank::BandCoefficients OctaveFilterBank::createBandCoefficients (double rate, double octaveCentre) const
+{
+    BandCoefficients c;
+    zerostruct (c);
+
+    // two identical sections are 3dB down where each is 1.5dB down, so widen them
+    // to put the band edges half a band either side of the centre
+    const double edgeRatio = std::pow (2.0, 0.5 / bandsPerOctave);
+    const double q = std::sqrt (std::sqrt (2.0) - 1.0) / (edgeRatio - 1.0 / edgeRatio);
+
+    for (int j = 0; j < bandsPerOctave; ++j)
+    {
+        const double centre = octaveCentre * std::pow (2.0, (j - (bandsPerOctave - 1) / 2) / (double) bandsPerOctave);
+
+        // the bilinear transform squeezes bands together towards the Nyquist
+        // frequency, lowering the Q by the same amount keeps their widths constant
+        const double w0 = 2.0 * MathConstants<double>::pi * centre / rate;
+        const IIRCoefficients section (BiquadFilter::makeBandPass (rate, centre, q * std::sin (w0) / w0));
+
+        for (int s = 0; s < numSections; ++s)
+        {
+            c.b0[s][j] = section.coefficients[0];
+            c.b1[s][j] = section.coefficients[1];
+            c.b2[s][j] = section.coefficients[2];
+            c.a1[s][j] = section.coefficients[3];
+            c.a2[s][j] = section.coefficients[4];
+        }
+    }
+
+    return c;
+}
+
+void OctaveFilterBank::processOctave (OctaveState& octave, const float* samples, int numSamples) noexcept
+{
+    if (numSamples <= 0)
+        return;
+
+    const BandCoefficients& c = bandCoefficients.getReference (octave.coefficientsIndex);
+
+    // work on local copies so the lane loops stay in registers and vectorise
+    float z1[numSections][numLanes], z2[numSections][numLanes];
+    float sumSquares[numLanes] = { 0.0f };
+    memcpy (z1, octave.z1, sizeof (z1));
+    memcpy (z2, octave.z2, sizeof (z2));
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        const float in = samples[i];
+
+        for (int j = 0; j < numLanes; ++j)
+        {
+            const float y0 = c.b0[0][j] * in + z1[0][j];
+            z1[0][j] = c.b1[0][j] * in - c.a1[0][j] * y0 + z2[0][j];
+            z2[0][j] = c.b2[0][j] * in - c.a2[0][j] * y0;
+
+            const float y1 = c.b0[1][j] * y0 + z1[1][j];
+            z1[1][j] = c.b1[1][j] * y0 - c.a1[1][j] * y1 + z2[1][j];
+            z2[1][j] = c.b2[1][j] * y0 - c.a2[1][j] * y1;
+
+            sumSquares[j] += y1 * y1;
+        }
+    }
+
+    const float decay = (float) std::exp (-numSamples / (integrationTime.load() * octave.sampleRate));
+
+    for (int s = 0; s < numSections; ++s)
+    {
+        for (int j = 0; j < numLanes; ++j)
+        {
+            OctaveFilterBankHelpers::snapToZero (z1[s][j]);
+            OctaveFilterBankHelpers::snapToZero (z2[s][j]);
+        }
+    }
+
+    memcpy (octave.z1, z1, sizeof (z1));
+    memcpy (octave.z2, z2, sizeof (z2));
+
+    for (int j = 0; j < numLanes; ++j)
+        octave.meanSquare[j] = decay * octave.meanSquare[j] + (1.0f - decay) * sumSquares[j] / numSamples;
+}
+
+int OctaveFilterBank::decimate (DecimatorState& decimator, const float* samples, int numSamples, float* dest) noexcept
+{
+    float z1[numDecimatorSections], z2[numDecimatorSections];
+    memcpy (z1, decimator.z1, sizeof (z1));
+    memcpy (z2, decimator.z2, sizeof (z2));
+
+    bool skipNext = decimator.skipNext;
+    int numOut = 0;
+
+    for (int i = 0; i < numSamples; ++i)
+    {
+        float x = samples[i];
+
+        for (int s = 0; s < numDecimatorSections; ++s)
+        {
+            const float* c = decimatorCoefficients[s].coefficients;
+            const float y = c[0] * x + z1[s];
+            z1[s] = c[1] * x - c[3] * y + z2[s];
+            z2[s] = c[2] * x - c[4] * y;
+            x = y;
+        }
+
+        if (! skipNext)
+            dest[numOut++] = x;
+
+        skipNext = ! skipNext;
+    }
+
+    for (int s = 0; s < numDecimatorSections; ++s)
+    {
+        OctaveFilterBankHelpers::snapToZero (z1[s]);
+        OctaveFilterBankHelpers::snapToZero (z2[s]);
+        decimator.z1[s] = z1[s];
+        decimator.z2[s] = z2[s];
+    }
+
+    decimator.skipNext = skipNext;
+
+    return numOut;
+}
@@ -0,0 +1,157 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_OCTAVEFILTERBANK_H
+#define DROWAUDIO_OCTAVEFILTERBANK_H
+
+//==============================================================================
+/** A real-time analyser filter bank giving the level in octave or third-octave
+    bands.
+
+    Unlike a linear FFT this has the same relative resolution at all frequencies,
+    which is what room measurement and RTA displays need.
+
+    Each band is a pair of BiquadFilter band-pass sections. Rather than running
+    every band at the full sample rate, the signal is low-pass filtered and
+    decimated by two after each octave, so each lower octave is processed at half
+    the rate of the one above it using exactly the same filter coefficients. As
+    the rates form a halving series the total cost stays within a small constant
+    multiple of one octave's, however many octaves are analysed. The octaves
+    nearest the Nyquist frequency, which are too close to it to decimate below
+    cleanly, are run at the full rate with their own coefficients.
+
+    The band filters of an octave are held side by side so that each sample is
+    run through all of the bands, and its energy integrated, in a single loop
+    the compiler can vectorise.
+
+    processSamples() is safe to call on the audio thread and the levels can be
+    read from any thread, e.g. by a display's timer.
+ */
+class OctaveFilterBank
+{
+public:
+    //==============================================================================
+    /** Creates a filter bank.
+
+        @param sampleRate       the rate of the samples that will be processed
+        @param bandsPerOctave   1 for octave bands or 3 for third-octave bands
+        @param numOctaves       the number of octaves, counting down from the highest
+                                standard octave that fits below the Nyquist frequency
+     */
+    OctaveFilterBank (double sampleRate, int bandsPerOctave = 3, int numOctaves = 10);
+
+    /** Destructor. */
+    ~OctaveFilterBank();
+
+    //==============================================================================
+    /** Allocates the buffers needed for blocks of up to a given size.
+        Call this before processing but not on the audio thread.
+     */
+    void prepare (int maximumBlockSize);
+
+    /** Clears the filters and levels. */
+    void reset() noexcept;
+
+    /** Sets the time constant the band energies are averaged over.
+        The default is 0.125 seconds, the "fast" setting of a sound level meter,
+        use 1 second for "slow".
+     */
+    void setIntegrationTime (double seconds) noexcept;
+
+    //==============================================================================
+    /** Analyses a block of mono samples. */
+    void processSamples (const float* samples, int numSamples) noexcept;
+
+    //==============================================================================
+    /** Returns the number of bands. */
+    int getNumBands() const noexcept                    { return numOctaves * bandsPerOctave; }
+
+    /** Returns the number of bands in each octave. */
+    int getNumBandsPerOctave() const noexcept           { return bandsPerOctave; }
+
+    /** Returns the exact centre frequency of a band, in order from the lowest up.
+        These are the base-two frequencies 1000 * 2^(n / bandsPerOctave) rather than
+        the rounded nominal ones, e.g. 15.85KHz rather than 16KHz.
+     */
+    double getBandCentreFrequency (int bandIndex) const noexcept;
+
+    /** Returns the RMS level of a band, in order from the lowest up. */
+    float getBandLevel (int bandIndex) const noexcept;
+
+    /** Fills an array with the RMS levels of all the bands, from the lowest up. */
+    void getBandLevels (float* destLevels) const noexcept;
+
+private:
+    //==============================================================================
+    enum { numLanes = 4, numSections = 2, numDecimatorSections = 3 };
+
+    struct BandCoefficients
+    {
+        float b0[numSections][numLanes], b1[numSections][numLanes], b2[numSections][numLanes];
+        float a1[numSections][numLanes], a2[numSections][numLanes];
+    };
+
+    struct OctaveState
+    {
+        float z1[numSections][numLanes], z2[numSections][numLanes];
+        float meanSquare[numLanes];
+        int coefficientsIndex;
+        double sampleRate;
+    };
+
+    struct DecimatorState
+    {
+        float z1[numDecimatorSections], z2[numDecimatorSections];
+        bool skipNext;
+    };
+
+    const double sampleRate;
+    const int bandsPerOctave, numOctaves, numFullRateOctaves;
+    const double topCentreFrequency;
+    std::atomic<double> integrationTime;
+
+    Array<BandCoefficients> bandCoefficients;
+    IIRCoefficients decimatorCoefficients[numDecimatorSections];
+    HeapBlock<OctaveState> octaves;
+    HeapBlock<DecimatorState> decimators;
+    HeapBlock<float> decimatedBuffers;
+    int decimatedBufferSize;
+    HeapBlock<std::atomic<float>> levels;
+
+    BandCoefficients createBandCoefficients (double rate, double octaveCentre) const;
+    void processOctave (OctaveState&, const float* samples, int numSamples) noexcept;
+    int decimate (DecimatorState&, const float* samples, int numSamples, float* dest) noexcept;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OctaveFilterBank)
+};
+
+#endif   // DROWAUDIO_OCTAVEFILTERBANK_H
@@ -32,7 +32,8 @@
 
 
 OnePoleFilter::OnePoleFilter() noexcept
-    : y1 (0.0f), b0 (1.0f), a1 (0.0f)
+    : coefficients ({ 1.0f, 0.0f }),
+      y1 (0.0f)
 {
 }
 
@@ -43,14 +44,18 @@ OnePoleFilter::~OnePoleFilter() noexcept
 void OnePoleFilter::processSamples (float* const samples,
                                     const int numSamples) noexcept
 {
-    // make sure sample values are locked
-    const ScopedLock sl (lock);
+    coefficients.update();
+    const float b0 = coefficients.get().b0;
+    const float a1 = coefficients.get().a1;
+    float ly1 = y1;
 
     for (int i = 0; i < numSamples; ++i)
     {
-        samples[i] = (b0 * samples[i]) + (a1 * y1);
-        y1 = samples[i];
+        samples[i] = (b0 * samples[i]) + (a1 * ly1);
+        ly1 = samples[i];
     }
+
+    y1 = ly1;
 }
 
 
@@ -62,10 +67,7 @@ void OnePoleFilter::makeLowPass (const double sampleRate,
 
     const double alpha = (2.0f - cos_w0) - sqrt ((2.0 - cos_w0) * (2.0 - cos_w0) - 1.0);
 
-    const ScopedLock sl (lock);
-
-    b0 = 1.0f - (float) alpha;
-    a1 = (float) alpha;
+    coefficients.set ({ 1.0f - (float) alpha, (float) alpha });
 }
 
 void OnePoleFilter::makeHighPass (const double sampleRate,
@@ -76,8 +78,5 @@ void OnePoleFilter::makeHighPass (const double sampleRate,
 
     const double alpha = (2.0 + cos_w0) - sqrt ((2.0 + cos_w0) * (2.0 + cos_w0) - 1.0);
 
-    const ScopedLock sl (lock);
-
-    b0 = (float) alpha - 1.0f;
-    a1 = (float) -alpha;
+    coefficients.set ({ (float) alpha - 1.0f, (float) -alpha });
 }
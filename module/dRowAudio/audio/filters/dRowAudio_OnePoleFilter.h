@@ -32,6 +32,8 @@
 #ifndef DROWAUDIO_ONEPOLEFILTER_H
 #define DROWAUDIO_ONEPOLEFILTER_H
 
+#include "../../utility/dRowAudio_DoubleBufferedValue.h"
+
 //==============================================================================
 /**
     One-Pole Filter.
@@ -39,6 +41,10 @@
     This is a simple filter that uses only one pole. As such it is very
     computationaly efficient especially if used to process a buffer of samples.
     It has a slope of -6dB/octave.
+
+    The make... methods can be called from any thread while the filter is being
+    processed. The new coefficients are swapped in at the start of the next block
+    without the processing ever taking a lock.
  */
 class OnePoleFilter
 {
@@ -61,13 +67,22 @@ public:
     void processSamples (float* const samples,
                          const int numSamples) noexcept;
 
+    /** Picks up any coefficients made since the last block.
+        processSamples() does this itself. Call it once before each block of
+        processSingleSample() calls, from the thread that processes the filter.
+     */
+    void updateCoefficients() noexcept                  { coefficients.update(); }
+
     /**    Process a single sample.
         Less efficient method but leaves the sample unchanged,
-        returning a filtered copy of it.
+        returning a filtered copy of it. This uses the coefficients picked up by
+        the last call to processSamples() or updateCoefficients().
      */
     inline float processSingleSample (const float sampleToProcess) noexcept
     {
-        return y1 = (b0 * sampleToProcess) + (a1 * y1);
+        const Coefficients& c = coefficients.get();
+
+        return y1 = (c.b0 * sampleToProcess) + (c.a1 * y1);
     }
 
     /**    Turns the filter into a Low-pass.
@@ -81,8 +96,13 @@ public:
 
 private:
     //==============================================================================
-    CriticalSection lock;
-    float y1, b0, a1;
+    struct Coefficients
+    {
+        float b0, a1;
+    };
+
+    DoubleBufferedValue<Coefficients> coefficients;
+    float y1;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (OnePoleFilter)
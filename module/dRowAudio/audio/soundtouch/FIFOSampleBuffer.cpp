@@ -50,8 +50,17 @@
 
 #include "FIFOSampleBuffer.h"
 
+// STTypes.h decides whether the mirrored buffers are used
+#if SOUNDTOUCH_USE_MIRRORED_FIFO
+    #include <sys/mman.h>
+    #include <sys/syscall.h>
+    #include <unistd.h>
+#endif
+
 using namespace soundtouch;
 
+int FIFOSampleBuffer::mirroredMemoryEnabled = SOUNDTOUCH_USE_MIRRORED_FIFO;
+
 // Constructor
 FIFOSampleBuffer::FIFOSampleBuffer(int numChannels)
 {
@@ -62,6 +71,7 @@ FIFOSampleBuffer::FIFOSampleBuffer(int numChannels)
     samplesInBuffer = 0;
     bufferPos = 0;
     channels = (uint)numChannels;
+    mirrored = 0;
     ensureCapacity(32);     // allocate initial capacity
 }
 
@@ -69,9 +79,7 @@ FIFOSampleBuffer::FIFOSampleBuffer(int numChannels)
 // destructor
 FIFOSampleBuffer::~FIFOSampleBuffer()
 {
-    delete[] bufferUnaligned;
-    bufferUnaligned = NULL;
-    buffer = NULL;
+    freeBuffer();
 }
 
 
@@ -140,7 +148,7 @@ void FIFOSampleBuffer::putSamples(uint nSamples)
 SAMPLETYPE *FIFOSampleBuffer::ptrEnd(uint slackCapacity)
 {
     ensureCapacity(samplesInBuffer + slackCapacity);
-    return buffer + samplesInBuffer * channels;
+    return ptrBegin() + samplesInBuffer * channels;
 }
 
 
@@ -154,42 +162,67 @@ SAMPLETYPE *FIFOSampleBuffer::ptrEnd(uint slackCapacity)
 SAMPLETYPE *FIFOSampleBuffer::ptrBegin()
 {
     assert(buffer);
-    return buffer + bufferPos * channels;
+    return buffer + bufferPos;
 }
 
 
 // Ensures that the buffer has enought capacity, i.e. space for _at least_
 // 'capacityRequirement' number of samples. The buffer is grown in steps of
 // 4 kilobytes to eliminate the need for frequently growing up the buffer,
-// as well as to round the buffer size up to the virtual memory page size.
+// as well as to round the buffer size up to the virtual memory page size,
+// and is at least doubled each time so growth stays rare.
+//
+// A mirrored buffer never needs rewinding as the samples stay contiguous
+// across the wrap. A linear buffer is only rewound if the samples wouldn't
+// fit after the current position.
 void FIFOSampleBuffer::ensureCapacity(uint capacityRequirement)
 {
     SAMPLETYPE *tempUnaligned, *temp;
+    uint newSizeInBytes;
 
     if (capacityRequirement > getCapacity())
     {
+        newSizeInBytes = capacityRequirement * channels * sizeof(SAMPLETYPE);
+        if (newSizeInBytes < 2 * sizeInBytes) newSizeInBytes = 2 * sizeInBytes;
+
+#if SOUNDTOUCH_USE_MIRRORED_FIFO
+        // mappings have to be whole pages
+        const uint pageSize = (uint)sysconf(_SC_PAGESIZE);
+        newSizeInBytes = (newSizeInBytes + pageSize - 1) / pageSize * pageSize;
+#else
         // enlarge the buffer in 4kbyte steps (round up to next 4k boundary)
-        sizeInBytes = (capacityRequirement * channels * sizeof(SAMPLETYPE) + 4095) & (uint)-4096;
-        assert(sizeInBytes % 2 == 0);
-        tempUnaligned = new SAMPLETYPE[sizeInBytes / sizeof(SAMPLETYPE) + 16 / sizeof(SAMPLETYPE)];
-        if (tempUnaligned == NULL)
+        newSizeInBytes = (newSizeInBytes + 4095) & (uint)-4096;
+#endif
+        assert(newSizeInBytes % 2 == 0);
+
+        temp = mirroredMemoryEnabled ? allocateMirrored(newSizeInBytes) : NULL;
+        tempUnaligned = NULL;
+
+        if (temp == NULL)
         {
-            ST_THROW_RT_ERROR("Couldn't allocate memory!\n");
+            tempUnaligned = new SAMPLETYPE[newSizeInBytes / sizeof(SAMPLETYPE) + 16 / sizeof(SAMPLETYPE)];
+            if (tempUnaligned == NULL)
+            {
+                ST_THROW_RT_ERROR("Couldn't allocate memory!\n");
+            }
+            // Align the buffer to begin at 16byte cache line boundary for optimal performance
+            temp = (SAMPLETYPE *)(((ulong)tempUnaligned + 15) & (ulong)-16);
         }
-        // Align the buffer to begin at 16byte cache line boundary for optimal performance
-        temp = (SAMPLETYPE *)(((ulong)tempUnaligned + 15) & (ulong)-16);
         if (samplesInBuffer)
         {
             memcpy(temp, ptrBegin(), samplesInBuffer * channels * sizeof(SAMPLETYPE));
         }
-        delete[] bufferUnaligned;
+        freeBuffer();
         buffer = temp;
         bufferUnaligned = tempUnaligned;
+        sizeInBytes = newSizeInBytes;
+        mirrored = (tempUnaligned == NULL);
         bufferPos = 0;
     }
-    else
+    else if (! mirrored
+             && (bufferPos + capacityRequirement * channels) * sizeof(SAMPLETYPE) > sizeInBytes)
     {
-        // simply rewind the buffer (if necessary)
+        // not enough room after the end, rewind the buffer
         rewind();
     }
 }
@@ -236,11 +269,18 @@ uint FIFOSampleBuffer::receiveSamples(uint maxSamples)
 
         temp = samplesInBuffer;
         samplesInBuffer = 0;
+        bufferPos = 0;
         return temp;
     }
 
     samplesInBuffer -= maxSamples;
-    bufferPos += maxSamples;
+    bufferPos += maxSamples * channels;
+
+    // the second mapping aliases the first so wrap back into it
+    if (mirrored && bufferPos * sizeof(SAMPLETYPE) >= sizeInBytes)
+    {
+        bufferPos -= sizeInBytes / sizeof(SAMPLETYPE);
+    }
 
     return maxSamples;
 }
@@ -259,3 +299,90 @@ void FIFOSampleBuffer::clear()
     samplesInBuffer = 0;
     bufferPos = 0;
 }
+
+
+// Sets whether buffers allocated from now on should try to use mirrored memory
+void FIFOSampleBuffer::setMirroredMemoryEnabled(int enabled)
+{
+    mirroredMemoryEnabled = (SOUNDTOUCH_USE_MIRRORED_FIFO && enabled) ? 1 : 0;
+}
+
+
+// Returns nonzero if this buffer is using mirrored memory
+int FIFOSampleBuffer::isMirrored() const
+{
+    return mirrored;
+}
+
+
+// Releases the buffer memory
+void FIFOSampleBuffer::freeBuffer()
+{
+    if (mirrored)
+    {
+        freeMirrored(buffer, sizeInBytes);
+    }
+    else
+    {
+        delete[] bufferUnaligned;
+    }
+    bufferUnaligned = NULL;
+    buffer = NULL;
+    mirrored = 0;
+}
+
+
+// Creates an anonymous memory file and maps it twice into a reserved region
+// of twice its size, so that any span of up to 'numBytes' starting in the
+// first half is contiguous.
+SAMPLETYPE *FIFOSampleBuffer::allocateMirrored(uint numBytes)
+{
+#if SOUNDTOUCH_USE_MIRRORED_FIFO && defined(SYS_memfd_create)
+    void *region, *first, *second;
+    int fd;
+
+    fd = (int)syscall(SYS_memfd_create, "soundtouch_fifo", 1u /* MFD_CLOEXEC */);
+    if (fd < 0) return NULL;
+
+    if (ftruncate(fd, (off_t)numBytes) != 0)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    // reserve the whole range first so nothing else can be mapped in between
+    region = mmap(NULL, 2 * (size_t)numBytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (region == MAP_FAILED)
+    {
+        close(fd);
+        return NULL;
+    }
+
+    first = mmap(region, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    second = mmap((char *)region + numBytes, numBytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0);
+    close(fd);
+
+    if (first != region || second != (char *)region + numBytes)
+    {
+        munmap(region, 2 * (size_t)numBytes);
+        return NULL;
+    }
+
+    return (SAMPLETYPE *)region;
+#else
+    (void)numBytes;
+    return NULL;
+#endif
+}
+
+
+// Releases memory allocated by allocateMirrored
+void FIFOSampleBuffer::freeMirrored(SAMPLETYPE *mem, uint numBytes)
+{
+#if SOUNDTOUCH_USE_MIRRORED_FIFO
+    if (mem) munmap(mem, 2 * (size_t)numBytes);
+#else
+    (void)mem;
+    (void)numBytes;
+#endif
+}
@@ -63,10 +63,11 @@ private:
     SAMPLETYPE *buffer;
 
     // Raw unaligned buffer memory. 'buffer' is made aligned by pointing it to first
-    // 16-byte aligned location of this buffer
+    // 16-byte aligned location of this buffer. Unused when the buffer is mirrored.
     SAMPLETYPE *bufferUnaligned;
 
-    /// Sample buffer size in bytes
+    /// Sample buffer size in bytes. When mirrored this is the size of one of the
+    /// two mappings.
     uint sizeInBytes;
 
     /// How many samples are currently in buffer.
@@ -75,11 +76,18 @@ private:
     /// Channels, 1=mono, 2=stereo.
     uint channels;
 
-    /// Current position pointer to the buffer. This pointer is increased when samples are
-    /// removed from the pipe so that it's necessary to actually rewind buffer (move data)
-    /// only new data when is put to the pipe.
+    /// Offset of the first sample in the buffer, in SAMPLETYPE units. This is increased
+    /// when samples are removed from the pipe. A linear buffer is only rewound (data
+    /// moved) when there isn't enough room left after the end, a mirrored buffer just
+    /// wraps this back into the first mapping.
     uint bufferPos;
 
+    /// Nonzero if 'buffer' points to a double mapped ring.
+    int mirrored;
+
+    /// Whether new buffers should try to use mirrored memory.
+    static int mirroredMemoryEnabled;
+
     /// Rewind the buffer by moving data from position pointed by 'bufferPos' to real
     /// beginning of the buffer.
     void rewind();
@@ -90,6 +98,17 @@ private:
     /// Returns current capacity.
     uint getCapacity() const;
 
+    /// Releases the buffer memory.
+    void freeBuffer();
+
+    /// Maps 'numBytes' of memory twice in a row so that writes to one half appear in
+    /// the other. 'numBytes' must be a multiple of the page size. Returns NULL if the
+    /// platform doesn't support this or the mapping failed.
+    static SAMPLETYPE *allocateMirrored(uint numBytes);
+
+    /// Releases memory allocated by allocateMirrored.
+    static void freeMirrored(SAMPLETYPE *mem, uint numBytes);
+
 public:
 
     /// Constructor
@@ -167,6 +186,14 @@ public:
 
     /// Clears all the samples.
     virtual void clear();
+
+    /// Sets whether buffers allocated from now on should try to use mirrored memory.
+    /// This is on by default when SOUNDTOUCH_USE_MIRRORED_FIFO is set and is mainly
+    /// useful for comparing the two.
+    static void setMirroredMemoryEnabled(int enabled);
+
+    /// Returns nonzero if this buffer is using mirrored memory.
+    int isMirrored() const;
 };
 
 }
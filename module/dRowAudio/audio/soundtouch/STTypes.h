@@ -108,6 +108,19 @@ namespace soundtouch
 
     #endif
 
+    /// Define this to 1 to let FIFOSampleBuffer map its storage twice, back to back,
+    /// in virtual memory so it can work as a ring buffer whilst still handing out
+    /// contiguous pointers. This avoids moving the samples down whenever new ones
+    /// are put in. Only Linux (memfd) is supported, elsewhere the buffers fall back
+    /// to ordinary memory that is only rewound when it runs out of room.
+    #ifndef SOUNDTOUCH_USE_MIRRORED_FIFO
+        #if defined(__linux__) && ! defined(__ANDROID__)
+            #define SOUNDTOUCH_USE_MIRRORED_FIFO    1
+        #else
+            #define SOUNDTOUCH_USE_MIRRORED_FIFO    0
+        #endif
+    #endif
+
     // If defined, allows the SIMD-optimized routines to take minor shortcuts
     // for improved performance. Undefine to require faithfully similar SIMD
     // calculations as in normal C implementation.
@@ -395,6 +395,11 @@ bool SoundTouch::setSetting(int settingId, int value)
             pTDStretch->enableQuickSeek((value != 0) ? TRUE : FALSE);
             return TRUE;
 
+        case SETTING_USE_HIERARCHICAL_SEEK :
+            // enables / disables tempo routine hierarchical seeking algorithm
+            pTDStretch->enableHierarchicalSeek((value != 0) ? TRUE : FALSE);
+            return TRUE;
+
         case SETTING_SEQUENCE_MS:
             // change time-stretch sequence duration parameter
             pTDStretch->setParameters(sampleRate, value, seekWindowMs, overlapMs);
@@ -435,6 +440,9 @@ int SoundTouch::getSetting(int settingId) const
         case SETTING_USE_QUICKSEEK :
             return (int) pTDStretch->isQuickSeekEnabled();
 
+        case SETTING_USE_HIERARCHICAL_SEEK :
+            return (int) pTDStretch->isHierarchicalSeekEnabled();
+
         case SETTING_SEQUENCE_MS:
             pTDStretch->getParameters(NULL, &temp, NULL, NULL);
             return temp;
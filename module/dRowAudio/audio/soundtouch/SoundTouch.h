@@ -141,6 +141,12 @@ namespace soundtouch
 ///   tempo/pitch/rate/samplerate settings.
 #define SETTING_NOMINAL_OUTPUT_SEQUENCE        7
 
+/// Enable/disable hierarchical seeking algorithm in tempo changer routine. This
+/// searches a decimated signal first and refines the best candidates, which is
+/// much cheaper than the full search and closer to it than quick seeking.
+/// Takes precedence over SETTING_USE_QUICKSEEK.
+#define SETTING_USE_HIERARCHICAL_SEEK         8
+
 class SoundTouch : public FIFOProcessor
 {
 private:
@@ -87,8 +87,12 @@ static const short _scanOffsets[5][24]={
 TDStretch::TDStretch() : FIFOProcessor(&outputBuffer)
 {
     bQuickSeek = FALSE;
+    bHierarchicalSeek = FALSE;
     channels = 2;
 
+    pDecimatedBuffer = NULL;
+    decimatedBufferSize = 0;
+
     pMidBuffer = NULL;
     pRefMidBufferUnaligned = NULL;
     overlapLength = 0;
@@ -112,6 +116,7 @@ TDStretch::~TDStretch()
 {
     delete[] pMidBuffer;
     delete[] pRefMidBufferUnaligned;
+    delete[] pDecimatedBuffer;
 }
 
 
@@ -243,9 +248,28 @@ bool TDStretch::isQuickSeekEnabled() const
 }
 
 
+// Enables/disables the hierarchical position seeking algorithm.
+void TDStretch::enableHierarchicalSeek(bool enable)
+{
+    bHierarchicalSeek = enable;
+}
+
+
+// Returns nonzero if the hierarchical seeking algorithm is enabled.
+bool TDStretch::isHierarchicalSeekEnabled() const
+{
+    return bHierarchicalSeek;
+}
+
+
 // Seeks for the optimal overlap-mixing position.
 int TDStretch::seekBestOverlapPosition(const SAMPLETYPE *refPos)
 {
+    if (bHierarchicalSeek)
+    {
+        return seekBestOverlapPositionHierarchical(refPos);
+    }
+
     if (channels == 2)
     {
         // stereo sound
@@ -500,6 +524,201 @@ int TDStretch::seekBestOverlapPositionMonoQuick(const SAMPLETYPE *refPos)
 }
 
 
+// Number of candidates from the decimated pass that are refined at full rate
+#define HIERARCHICAL_NUM_CANDIDATES     3
+
+// Seeks for the optimal overlap-mixing position using a coarse-to-fine search.
+//
+// The reference and the seek window are mixed to mono and decimated by
+// averaging, then the decimated reference is correlated against every
+// decimated offset. The best few local maxima of that are then rescanned at
+// the full rate over the positions they could have come from, using the same
+// score as the full search, so the result is usually identical to it whilst
+// only computing a small fraction of the full rate correlations.
+int TDStretch::seekBestOverlapPositionHierarchical(const SAMPLETYPE *refPos)
+{
+    int factor, numRef, numCoarse, numIn;
+    int i, j, k, c;
+    float *decRef, *decIn, *coarseScore;
+    double norm, corr, tmp;
+    int candidates[HIERARCHICAL_NUM_CANDIDATES];
+    float candidateScores[HIERARCHICAL_NUM_CANDIDATES];
+    int bestOffs;
+    double bestCorr;
+
+    if (channels == 2)
+    {
+        precalcCorrReferenceStereo();
+    }
+    else
+    {
+        precalcCorrReferenceMono();
+    }
+
+    factor = getSeekDecimationFactor();
+    numRef = overlapLength / factor;
+    numCoarse = (seekLength + factor - 1) / factor;
+    numIn = numCoarse + numRef;
+
+    // the reference, input and scores share one buffer that is kept between
+    // sequences so it's only reallocated if the parameters grow
+    if (numRef + numIn + numCoarse > decimatedBufferSize)
+    {
+        delete[] pDecimatedBuffer;
+        decimatedBufferSize = numRef + numIn + numCoarse;
+        pDecimatedBuffer = new float[decimatedBufferSize];
+    }
+    decRef = pDecimatedBuffer;
+    decIn = decRef + numRef;
+    coarseScore = decIn + numIn;
+
+    decimateToMono(decRef, pRefMidBuffer, numRef, factor);
+    decimateToMono(decIn, refPos, numIn, factor);
+
+    // coarse pass, normalised by a running energy of the input window
+    norm = 0;
+    for (j = 0; j < numRef; j ++)
+    {
+        norm += decIn[j] * decIn[j];
+    }
+
+    for (k = 0; k < numCoarse; k ++)
+    {
+        // four partial sums so the compiler can keep this in vector registers
+        float sum0 = 0, sum1 = 0, sum2 = 0, sum3 = 0;
+        const float *pIn = decIn + k;
+        for (j = 0; j + 3 < numRef; j += 4)
+        {
+            sum0 += decRef[j] * pIn[j];
+            sum1 += decRef[j + 1] * pIn[j + 1];
+            sum2 += decRef[j + 2] * pIn[j + 2];
+            sum3 += decRef[j + 3] * pIn[j + 3];
+        }
+        for (; j < numRef; j ++)
+        {
+            sum0 += decRef[j] * pIn[j];
+        }
+        corr = (double)((sum0 + sum1) + (sum2 + sum3));
+        tmp = (double)(2 * k * factor - seekLength) / seekLength;
+        coarseScore[k] = (float)(corr / sqrt(norm > 1e-9 ? norm : 1.0) * (1.0 - 0.25 * tmp * tmp));
+
+        norm += decIn[k + numRef] * decIn[k + numRef] - decIn[k] * decIn[k];
+    }
+
+    // pick the best few local maxima
+    for (c = 0; c < HIERARCHICAL_NUM_CANDIDATES; c ++)
+    {
+        candidates[c] = -1;
+        candidateScores[c] = -FLT_MAX;
+    }
+
+    for (k = 0; k < numCoarse; k ++)
+    {
+        if ((k > 0 && coarseScore[k] < coarseScore[k - 1])
+            || (k < numCoarse - 1 && coarseScore[k] < coarseScore[k + 1]))
+        {
+            continue;
+        }
+
+        for (c = 0; c < HIERARCHICAL_NUM_CANDIDATES; c ++)
+        {
+            if (coarseScore[k] > candidateScores[c])
+            {
+                for (i = HIERARCHICAL_NUM_CANDIDATES - 1; i > c; i --)
+                {
+                    candidates[i] = candidates[i - 1];
+                    candidateScores[i] = candidateScores[i - 1];
+                }
+                candidates[c] = k;
+                candidateScores[c] = coarseScore[k];
+                break;
+            }
+        }
+    }
+
+    // fine pass around each candidate at the full rate
+    bestCorr = FLT_MIN;
+    bestOffs = 0;
+
+    for (c = 0; c < HIERARCHICAL_NUM_CANDIDATES && candidates[c] >= 0; c ++)
+    {
+        const int start = max(0, candidates[c] * factor - factor + 1);
+        const int end = (candidates[c] * factor + factor < seekLength) ? candidates[c] * factor + factor : seekLength;
+
+        for (i = start; i < end; i ++)
+        {
+            corr = calcOverlapScore(refPos, i);
+
+            if (corr > bestCorr)
+            {
+                bestCorr = corr;
+                bestOffs = i;
+            }
+        }
+    }
+    // clear cross correlation routine state if necessary (is so e.g. in MMX routines).
+    clearCrossCorrState();
+
+    return bestOffs;
+}
+
+
+// Returns the decimation factor used by the hierarchical search. This aims for
+// roughly an 11kHz rate for the coarse pass whilst keeping enough points in
+// the decimated reference to be meaningful.
+int TDStretch::getSeekDecimationFactor() const
+{
+    int factor;
+
+    factor = sampleRate / 11025;
+    if (factor > 8) factor = 8;
+    while (factor > 1 && overlapLength / factor < 16) factor --;
+    if (factor < 1) factor = 1;
+
+    return factor;
+}
+
+
+// Mixes 'src' to mono and decimates it by averaging 'factor' frames at a time.
+// The output isn't scaled as it's only used for normalised correlations.
+void TDStretch::decimateToMono(float *dest, const SAMPLETYPE *src, int numOut, int factor) const
+{
+    int i, j;
+    const int step = factor * channels;
+
+    for (i = 0; i < numOut; i ++)
+    {
+        float sum = 0;
+        for (j = 0; j < step; j ++)
+        {
+            sum += (float)src[j];
+        }
+        dest[i] = sum;
+        src += step;
+    }
+}
+
+
+// Returns the same score the full search uses for a given offset. The
+// reference must already have been calculated.
+double TDStretch::calcOverlapScore(const SAMPLETYPE *refPos, int offset) const
+{
+    double corr, tmp;
+
+    if (channels == 2)
+    {
+        corr = (double)calcCrossCorrStereo(refPos + 2 * offset, pRefMidBuffer);
+    }
+    else
+    {
+        corr = (double)calcCrossCorrMono(pRefMidBuffer, refPos + offset);
+    }
+    // heuristic rule to slightly favour values close to mid of the range
+    tmp = (double)(2 * offset - seekLength) / seekLength;
+    return (corr + 0.1) * (1.0 - 0.25 * tmp * tmp);
+}
+
+
 /// clear cross correlation routine state if necessary
 void TDStretch::clearCrossCorrState()
 {
@@ -127,6 +127,9 @@ protected:
     FIFOSampleBuffer outputBuffer;
     FIFOSampleBuffer inputBuffer;
     bool bQuickSeek;
+    bool bHierarchicalSeek;
+    float *pDecimatedBuffer;
+    int decimatedBufferSize;
 //    int outDebt;
 //    bool bMidBufferDirty;
 
@@ -149,8 +152,13 @@ protected:
     virtual int seekBestOverlapPositionStereoQuick(const SAMPLETYPE *refPos);
     virtual int seekBestOverlapPositionMono(const SAMPLETYPE *refPos);
     virtual int seekBestOverlapPositionMonoQuick(const SAMPLETYPE *refPos);
+    virtual int seekBestOverlapPositionHierarchical(const SAMPLETYPE *refPos);
     int seekBestOverlapPosition(const SAMPLETYPE *refPos);
 
+    int getSeekDecimationFactor() const;
+    void decimateToMono(float *dest, const SAMPLETYPE *src, int numOut, int factor) const;
+    double calcOverlapScore(const SAMPLETYPE *refPos, int offset) const;
+
     virtual void overlapStereo(SAMPLETYPE *output, const SAMPLETYPE *input) const;
     virtual void overlapMono(SAMPLETYPE *output, const SAMPLETYPE *input) const;
 
@@ -207,6 +215,14 @@ public:
     /// Returns nonzero if the quick seeking algorithm is enabled.
     bool isQuickSeekEnabled() const;
 
+    /// Enables/disables the hierarchical position seeking algorithm. This correlates
+    /// a decimated mono mix over the whole seek window and then refines the best few
+    /// candidates at the full rate. It takes precedence over quick seeking.
+    void enableHierarchicalSeek(bool enable);
+
+    /// Returns nonzero if the hierarchical seeking algorithm is enabled.
+    bool isHierarchicalSeekEnabled() const;
+
     /// Sets routine control parameters. These control are certain time constants
     /// defining how the sound is stretched to the desired duration.
     //
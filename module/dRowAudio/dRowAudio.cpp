@@ -73,6 +73,8 @@
 
 namespace drow
 {
+    #include "audio/dRowAudio_ProcessTimeHistogram.cpp"
+    #include "audio/dRowAudio_ScratchArena.cpp"
     #include "audio/dRowAudio_AudioFilePlayer.cpp"
     #include "audio/dRowAudio_AudioFilePlayerExt.cpp"
     #include "audio/dRowAudio_AudioSampleBufferAudioFormat.cpp"
@@ -81,15 +83,21 @@ namespace drow
     #include "audio/dRowAudio_FilteringAudioSource.cpp"
     #include "audio/dRowAudio_ReversibleAudioSource.cpp"
     #include "audio/dRowAudio_LoopingAudioSource.cpp"
+    #include "audio/dRowAudio_ScrubbingAudioSource.cpp"
     #include "audio/dRowAudio_PitchDetector.cpp"
     #include "audio/dRowAudio_AudioUtilityUnitTests.cpp"
+    #include "audio/dRowAudio_AudioBenchmarks.cpp"
     #include "audio/dRowAudio_EnvelopeFollower.cpp"
     #include "audio/dRowAudio_SampleRateConverter.cpp"
+    #include "audio/dRowAudio_Oversampler.cpp"
     #include "audio/filters/dRowAudio_BiquadFilter.cpp"
+    #include "audio/filters/dRowAudio_OctaveFilterBank.cpp"
     #include "audio/filters/dRowAudio_OnePoleFilter.cpp"
     #include "audio/fft/dRowAudio_Window.cpp"
     #include "audio/fft/dRowAudio_FFT.cpp"
     #include "audio/fft/dRowAudio_LTAS.cpp"
+    #include "audio/fft/dRowAudio_Tempogram.cpp"
+    #include "audio/fft/dRowAudio_MFCC.cpp"
     #include "gui/dRowAudio_AudioFileDropTarget.cpp"
     #include "gui/dRowAudio_DefaultColours.cpp"
     #include "gui/dRowAudio_GraphicalComponent.cpp"
@@ -109,6 +117,9 @@ namespace drow
     #include "gui/audiothumbnail/dRowAudio_ColouredAudioThumbnail.cpp"
     #include "gui/audiothumbnail/dRowAudio_PositionableWaveDisplay.cpp"
     #include "gui/audiothumbnail/dRowAudio_DraggableWaveDisplay.cpp"
+    #include "gui/audiothumbnail/dRowAudio_WaveformRenderer.cpp"
+    #include "gui/dRowAudio_BatchImageRenderer.cpp"
+    #include "gui/dRowAudio_GuiBenchmarks.cpp"
     #include "maths/dRowAudio_MathsUnitTests.cpp"
    #if JUCE_IOS
     #include "native/dRowAudio_AudioPicker.mm"
@@ -126,8 +137,17 @@ namespace drow
     #include "utility/dRowAudio_ITunesLibraryParser.cpp"
     #include "utility/dRowAudio_UnityBuilder.cpp"
     #include "utility/dRowAudio_UnityProjectBuilder.cpp"
+    #include "utility/dRowAudio_PerformanceBenchmark.cpp"
+    #include "utility/dRowAudio_PriorityTimeSliceThread.cpp"
+    #include "utility/dRowAudio_RealtimeSafetyChecker.cpp"
+    #include "utility/dRowAudio_TraceRecorder.cpp"
+    #include "utility/dRowAudio_XmlIndex.cpp"
+    #include "utility/dRowAudio_UtilityBenchmarks.cpp"
 }
 
+// the global allocation and locking replacements can't go inside the namespace
+#include "utility/dRowAudio_RealtimeSafetyCheckerOverrides.cpp"
+
 #if JUCE_MSVC
     #pragma warning (pop)
 #endif
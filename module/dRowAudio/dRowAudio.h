@@ -242,6 +242,35 @@ END_JUCE_MODULE_DECLARATION
     #undef DROWAUDIO_USE_CURL
 #endif
 
+/** Config: DROWAUDIO_USE_PROCESS_TIMING
+    When enabled, the module's AudioSources record the time spent in each call
+    to getNextAudioBlock into a ProcessTimeHistogram which can be retrieved from
+    their getProcessTimeHistogram() methods. When disabled all the timing code
+    and the histograms are removed. By default this is disabled.
+*/
+#ifndef DROWAUDIO_USE_PROCESS_TIMING
+    #define DROWAUDIO_USE_PROCESS_TIMING 0
+#endif
+
+/** Config: DROWAUDIO_REALTIME_SAFETY_CHECKS
+    Enables the RealtimeSafetyChecker which reports memory allocations and lock
+    acquisitions made inside a real-time scope such as an audio callback. This
+    replaces the global operator new and delete, and on Linux malloc and free, so
+    should only be used in debug and test builds. By default this is disabled.
+*/
+#ifndef DROWAUDIO_REALTIME_SAFETY_CHECKS
+    #define DROWAUDIO_REALTIME_SAFETY_CHECKS 0
+#endif
+
+/** Config: DROWAUDIO_BENCHMARKS
+    Compiles in the PerformanceBenchmark suite which times the module's main
+    processing classes. Use a PerformanceBenchmarkRunner from a console app to
+    run them. By default this is disabled.
+*/
+#ifndef DROWAUDIO_BENCHMARKS
+    #define DROWAUDIO_BENCHMARKS 0
+#endif
+
 //=============================================================================
 #if JUCE_MSVC
     #pragma warning (push)
@@ -269,24 +298,33 @@ namespace drow
     #include "audio/dRowAudio_FifoBuffer.h"
     #include "audio/dRowAudio_FilteringAudioSource.h"
     #include "audio/dRowAudio_LoopingAudioSource.h"
+    #include "audio/dRowAudio_Oversampler.h"
     #include "audio/dRowAudio_Pitch.h"
     #include "audio/dRowAudio_PitchDetector.h"
+    #include "audio/dRowAudio_ProcessTimeHistogram.h"
     #include "audio/dRowAudio_ReversibleAudioSource.h"
     #include "audio/dRowAudio_SampleRateConverter.h"
+    #include "audio/dRowAudio_ScratchArena.h"
+    #include "audio/dRowAudio_ScrubbingAudioSource.h"
     #include "audio/dRowAudio_SoundTouchAudioSource.h"
     #include "audio/dRowAudio_SoundTouchProcessor.h"
     #include "audio/fft/dRowAudio_FFT.h"
     #include "audio/fft/dRowAudio_LTAS.h"
+    #include "audio/fft/dRowAudio_MFCC.h"
+    #include "audio/fft/dRowAudio_Tempogram.h"
     #include "audio/fft/dRowAudio_Window.h"
     #include "audio/filters/dRowAudio_BiquadFilter.h"
+    #include "audio/filters/dRowAudio_OctaveFilterBank.h"
     #include "audio/filters/dRowAudio_OnePoleFilter.h"
     #include "gui/audiothumbnail/dRowAudio_AudioThumbnailImage.h"
     #include "gui/audiothumbnail/dRowAudio_ColouredAudioThumbnail.h"
     #include "gui/audiothumbnail/dRowAudio_DraggableWaveDisplay.h"
     #include "gui/audiothumbnail/dRowAudio_PositionableWaveDisplay.h"
+    #include "gui/audiothumbnail/dRowAudio_WaveformRenderer.h"
     #include "gui/dRowAudio_AudioFileDropTarget.h"
     #include "gui/dRowAudio_AudioOscilloscope.h"
     #include "gui/dRowAudio_AudioTransportCursor.h"
+    #include "gui/dRowAudio_BatchImageRenderer.h"
     #include "gui/dRowAudio_CentreAlignViewport.h"
     #include "gui/dRowAudio_Clock.h"
     #include "gui/dRowAudio_CpuMeter.h"
@@ -316,16 +354,22 @@ namespace drow
     #include "utility/dRowAudio_Comparators.h"
     #include "utility/dRowAudio_Constants.h"
     #include "utility/dRowAudio_DebugObject.h"
+    #include "utility/dRowAudio_DoubleBufferedValue.h"
     #include "utility/dRowAudio_EncryptedString.h"
     #include "utility/dRowAudio_ITunesLibrary.h"
     #include "utility/dRowAudio_ITunesLibraryParser.h"
     #include "utility/dRowAudio_LockedPointer.h"
     #include "utility/dRowAudio_MusicLibraryHelpers.h"
+    #include "utility/dRowAudio_PerformanceBenchmark.h"
+    #include "utility/dRowAudio_PriorityTimeSliceThread.h"
+    #include "utility/dRowAudio_RealtimeSafetyChecker.h"
     #include "utility/dRowAudio_StateVariable.h"
+    #include "utility/dRowAudio_TraceRecorder.h"
     #include "utility/dRowAudio_UnityBuilder.h"
     #include "utility/dRowAudio_UnityProjectBuilder.h"
     #include "utility/dRowAudio_Utility.h"
     #include "utility/dRowAudio_XmlHelpers.h"
+    #include "utility/dRowAudio_XmlIndex.h"
 }
 
 #ifdef __clang__
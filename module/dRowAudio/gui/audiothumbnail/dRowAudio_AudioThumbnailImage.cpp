@@ -44,7 +44,8 @@ AudioThumbnailImage::AudioThumbnailImage (AudioFilePlayer& sourceToBeUsed,
       currentSampleRate                 (44100.0),
       oneOverSampleRate                 (1.0 / currentSampleRate),
       lastTimeDrawn                     (0.0),
-      resolution                        (3.0)
+      numPixelsRendered                 (0),
+      imageGeneration                   (0)
 {
     waveformImage = Image (Image::RGB, 1, 1, false);
     refreshFromFilePlayer();
@@ -73,12 +74,16 @@ void AudioThumbnailImage::setWaveformColour (const Colour& newWaveformColour)
     triggerWaveformRefresh();
 }
 
-void AudioThumbnailImage::setResolution (double newResolution)
+void AudioThumbnailImage::setAntialiasing (bool shouldAntialias)
 {
-    resolution = newResolution;
+    waveformRenderer.setAntialiasing (shouldAntialias);
     triggerWaveformRefresh();
 }
 
+void AudioThumbnailImage::setResolution (double /*newResolution*/)
+{
+}
+
 //====================================================================================
 const Image AudioThumbnailImage::getImageAtTime (double startTime, double duration)
 {
@@ -112,6 +117,7 @@ void AudioThumbnailImage::timerCallback()
 
 int AudioThumbnailImage::useTimeSlice()
 {
+    DROWAUDIO_TRACE_THREAD();
     refreshWaveform();
 
     return 25;
@@ -156,6 +162,8 @@ void AudioThumbnailImage::refreshFromFilePlayer()
 
                 const int imageWidth = roundToInt (filePlayer.getTotalLength() / sourceSamplesPerThumbnailSample);
                 waveformImage = Image (Image::RGB, jmax (1, imageWidth), 100, true);
+                numPixelsRendered = 0;
+                ++imageGeneration;
                 // image will be cleared in triggerWaveformRefresh()
 
                 const File newFile (filePlayer.getFile());
@@ -203,6 +211,8 @@ void AudioThumbnailImage::triggerWaveformRefresh()
         const ScopedWriteLock sl (imageLock);
 
         lastTimeDrawn = 0.0;
+        numPixelsRendered = 0;
+        ++imageGeneration;
         waveformImage.clear (waveformImage.getBounds(), backgroundColour);
         renderComplete = false;
     }
@@ -218,6 +228,8 @@ void AudioThumbnailImage::triggerWaveformRefresh()
 
 void AudioThumbnailImage::refreshWaveform()
 {
+    DROWAUDIO_TRACE_SCOPE ("AudioThumbnailImage::refreshWaveform")
+
     if (sourceLoaded && audioThumbnail.getNumSamplesFinished() > 0)
     {
         const double timeRendered = audioThumbnail.getNumSamplesFinished() * oneOverSampleRate;
@@ -234,34 +246,31 @@ void AudioThumbnailImage::refreshWaveform()
         const int nextPixel = roundToInt (endTime * oneOverFileLength * waveformImageWidth);
         const int startPixelX = roundToInt (lastTimeDrawn * oneOverFileLength * waveformImageWidth);
         const int numPixels = nextPixel - startPixelX;
-        const int numTempPixels = roundToInt (numPixels * resolution);
 
-        if (numTempPixels > 0)
+        if (numPixels > 0)
         {
-            if (tempSectionImage.getWidth() < numTempPixels)
-            {
-                tempSectionImage = Image (Image::RGB,
-                                          numTempPixels, waveformImageHeight,
-                                          false);
-            }
-
-            Rectangle<int> rectangleToDraw (0, 0, numTempPixels, waveformImageHeight);
-
-            Graphics gTemp (tempSectionImage);
-            tempSectionImage.clear (tempSectionImage.getBounds(), backgroundColour);
-            gTemp.setColour (waveformColour);
-            audioThumbnail.drawChannel (gTemp, rectangleToDraw,
-                                        lastTimeDrawn, endTime,
-                                        0, 1.0f);
+            // read the levels before taking the lock so the image isn't held
+            // whilst the thumbnail is being scanned
+            const double secondsPerPixel = fileLength / waveformImageWidth;
+            waveformRenderer.readColumns (audioThumbnail, 0,
+                                          startPixelX * secondsPerPixel, secondsPerPixel,
+                                          numPixels);
 
             lastTimeDrawn = endTime;
 
             const ScopedWriteLock sl (imageLock);
 
-            Graphics g (waveformImage);
-            g.drawImage (tempSectionImage,
-                         startPixelX, 0, numPixels, waveformImageHeight,
-                         0, 0, numTempPixels, tempSectionImage.getHeight());
+            // the image may have been replaced since we read its size
+            if (waveformImage.getWidth() == waveformImageWidth
+                 && waveformImage.getHeight() == waveformImageHeight)
+            {
+                const Image::BitmapData destData (waveformImage, startPixelX, 0,
+                                                  numPixels, waveformImageHeight,
+                                                  Image::BitmapData::writeOnly);
+                waveformRenderer.render (destData, 0, waveformColour, backgroundColour);
+
+                numPixelsRendered = nextPixel;
+            }
         }
 
         if (endSamples == audioThumbnail.getNumSamplesFinished())
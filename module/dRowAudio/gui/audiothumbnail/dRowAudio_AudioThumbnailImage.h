@@ -32,6 +32,8 @@
 #ifndef DROWAUDIO_AUDIOTHUMBNAILIMAGE_H
 #define DROWAUDIO_AUDIOTHUMBNAILIMAGE_H
 
+#include "dRowAudio_WaveformRenderer.h"
+
 //==============================================================================
 /** A class to display the waveform of an audio file.
 
@@ -74,9 +76,17 @@ public:
      */
     void setWaveformColour (const Colour& newWaveformColour);
 
-    /** Sets the image resolution in lines per pixel.
+    /** Sets whether the edges of the waveform should be anti-aliased.
         This will cause the waveform to be re-generated from the source.
      */
+    void setAntialiasing (bool shouldAntialias);
+
+    /** This used to set the number of lines drawn per pixel.
+
+        The waveform is now rasterised directly from the thumbnail's levels at one
+        column per pixel so this has no effect.
+        @see setAntialiasing
+     */
     void setResolution (double newResolution);
 
     //====================================================================================
@@ -96,6 +106,27 @@ public:
      */
     double getTimeRendered()                        {   return lastTimeDrawn;   }
 
+    /** Returns the number of pixels from the left of the image that have been rendered.
+
+        The image is rendered from left to right and pixels before this won't change
+        until the image is cleared, which changes getImageGeneration(). If you keep a
+        copy of the image you only need to update the pixels between the last value
+        this returned and the current one, as long as the generation is the same.
+     */
+    int getNumPixelsRendered() const noexcept       {   return numPixelsRendered.load();   }
+
+    /** Returns a number that changes every time the image is cleared or replaced.
+
+        Read this and getNumPixelsRendered() whilst holding the image lock to be sure
+        they refer to the same image.
+     */
+    uint32 getImageGeneration() const noexcept      {   return imageGeneration.load();   }
+
+    /** Returns the lock that should be held for reading whilst accessing the image
+        from a thread other than the message thread.
+     */
+    const ReadWriteLock& getImageLock() const noexcept  {   return imageLock;   }
+
     /** Returns true if the Image has finished rendering;
      */
     bool hasFinishedLoading()                       {   return renderComplete;  }
@@ -166,13 +197,16 @@ private:
     int sourceSamplesPerThumbnailSample;
 
     ReadWriteLock imageLock;
-    Image waveformImage, tempSectionImage;
+    Image waveformImage;
+    WaveformRenderer waveformRenderer;
 
     Colour backgroundColour, waveformColour;
 
     bool sourceLoaded, renderComplete;
     double fileLength, oneOverFileLength, currentSampleRate, oneOverSampleRate;
-    double lastTimeDrawn, resolution;
+    double lastTimeDrawn;
+    std::atomic<int> numPixelsRendered;
+    std::atomic<uint32> imageGeneration;
 
     ListenerList <Listener> listeners;
 
@@ -130,14 +130,14 @@ public:
     LevelDataSource (ColouredAudioThumbnail& owner_, AudioFormatReader* newReader, int64 hash)
         : lengthInSamples (0), numSamplesFinished (0), sampleRate (0), numChannels (0),
           hashCode (hash), owner (owner_), reader (newReader),
-          tempSampleBufferSize (0), tempFilteredBufferSize (0)
+          overviewStride (0), numOverviewProbes (0), numOverviewProbesDone (0)
     {
     }
 
     LevelDataSource (ColouredAudioThumbnail& owner_, InputSource* source_)
         : lengthInSamples (0), numSamplesFinished (0), sampleRate (0), numChannels (0),
           hashCode (source_->hashCode()), owner (owner_), source (source_),
-          tempSampleBufferSize (0), tempFilteredBufferSize (0)
+          overviewStride (0), numOverviewProbes (0), numOverviewProbesDone (0)
     {
     }
 
@@ -146,14 +146,31 @@ public:
         owner.cache.getTimeSliceThread().removeTimeSliceClient (this);
     }
 
-    enum { timeBeforeDeletingReader = 2000 };
-
-    void initialise (int64 numSamplesFinished_)
+    enum
+    {
+        timeBeforeDeletingReader = 2000,
+        maxThumbSamplesPerBlock = 256,
+        maxSamplesPerRead = 4096,
+        maxOverviewProbes = 512,
+        minOverviewStride = 4,
+        overviewProbesPerBlock = 32,
+        overviewPrerollSamples = 1024
+    };
+
+    void initialise (int64 numSamplesFinished_, bool progressive)
     {
         const ScopedLock sl (readerLock);
 
         numSamplesFinished = numSamplesFinished_;
 
+        // room for the read and filter buffers for one thumb sample
+        scratchArena.setSize (ScratchArena::getRequiredSize<int> (maxSamplesPerRead * 2 + 64)
+                               + ScratchArena::getRequiredSize<int> (maxSamplesPerRead * 4));
+
+        // the levels are handed to the owner with the lock released, so they can't
+        // live in the arena where a call to getLevels() could reset them underneath us
+        levelData.malloc ((size_t) (maxThumbSamplesPerBlock + 1) * 2);
+
         createReader();
 
         if (reader != nullptr)
@@ -162,15 +179,15 @@ public:
             numChannels = int (reader->numChannels);
             sampleRate = reader->sampleRate;
 
-            filterLow.makeBandPass (reader->sampleRate, 130.0, 2);
-            filterLowMid.makeBandPass (reader->sampleRate, 650.0, 2.0);
-            filterHighMid.makeBandPass (reader->sampleRate, 1300.0, 2.0);
-            filterHigh.makeHighPass (reader->sampleRate, 2700.0, 0.5);
+            scanFilters.prepare (reader->sampleRate);
+            directFilters.prepare (reader->sampleRate);
+            overviewFilters.prepare (reader->sampleRate);
 
-            filterLow.reset();
-            filterLowMid.reset();
-            filterHighMid.reset();
-            filterHigh.reset();
+            numOverviewProbes = numOverviewProbesDone = 0;
+
+            // only worth doing for a fresh scan of a file that is long enough to skip through
+            if (progressive && numSamplesFinished == 0)
+                prepareOverview();
 
             if (lengthInSamples <= 0)
                 reader = nullptr;
@@ -186,10 +203,12 @@ public:
 
         if (reader != nullptr)
         {
+            scratchArena.reset();
+
             float l[4] = { 0 };
             Colour colourLeft, colourRight;
 
-            readMaxLevelsFilteringWithColour (startSample, numSamples,
+            readMaxLevelsFilteringWithColour (directFilters, startSample, numSamples,
                                               l[0], l[1], l[2], l[3], colourLeft, colourRight);
             levels.clearQuick();
             levels.addArray ((const float*) l, 4);
@@ -209,13 +228,16 @@ public:
 
     int useTimeSlice()
     {
+        DROWAUDIO_TRACE_THREAD();
+        DROWAUDIO_TRACE_SCOPE ("ColouredAudioThumbnail::useTimeSlice")
+
         if (isFullyLoaded())
         {
             if (reader != nullptr && source != nullptr)
                 startTimer (timeBeforeDeletingReader);
 
             owner.cache.getTimeSliceThread().removeTimeSliceClient (this);
-            return false;
+            return -1;
         }
 
         stopTimer();
@@ -229,8 +251,17 @@ public:
 
             if (reader != nullptr)
             {
-                if (! readNextBlock())
-                    return true;
+                if (! isOverviewComplete())
+                {
+                    readNextOverviewBlock();
+                    return 0;
+                }
+
+                const bool finishedLoading = readNextBlock();
+                DROWAUDIO_TRACE_COUNTER ("thumbnail samples loaded", numSamplesFinished);
+
+                if (! finishedLoading)
+                    return 1;
 
                 justFinished = true;
             }
@@ -239,7 +270,8 @@ public:
         if (justFinished)
             owner.cache.storeThumb (owner, hashCode);
 
-        return false;
+        // come straight back to release the reader and remove ourselves
+        return 0;
     }
 
     void timerCallback()
@@ -253,6 +285,11 @@ public:
         return numSamplesFinished >= lengthInSamples;
     }
 
+    bool isOverviewComplete() const noexcept
+    {
+        return numOverviewProbesDone >= numOverviewProbes;
+    }
+
     inline int sampleToThumbSample (const int64 originalSample) const noexcept
     {
         return (int) (originalSample / owner.samplesPerThumbSample);
@@ -268,9 +305,39 @@ private:
     std::unique_ptr <InputSource> source;
     std::unique_ptr <AudioFormatReader> reader;
     CriticalSection readerLock;
-    BiquadFilter filterLow, filterLowMid, filterHighMid, filterHigh;
-    HeapBlock<int> tempSampleBuffer, tempFilteredBuffer;
-    int tempSampleBufferSize, tempFilteredBufferSize;
+    ScratchArena scratchArena;
+
+    /** The band filters used to find the colour of a section.
+        The sequential scan, direct reads and the overview each keep their own set so
+        that reading from elsewhere in the file never disturbs the scan's filter state.
+    */
+    struct ColourFilters
+    {
+        void prepare (double newSampleRate)
+        {
+            low.setCoefficients (BiquadFilter::makeBandPass (newSampleRate, 130.0, 2.0));
+            lowMid.setCoefficients (BiquadFilter::makeBandPass (newSampleRate, 650.0, 2.0));
+            highMid.setCoefficients (BiquadFilter::makeBandPass (newSampleRate, 1300.0, 2.0));
+            high.setCoefficients (BiquadFilter::makeHighPass (newSampleRate, 2700.0, 0.5));
+
+            reset();
+        }
+
+        void reset()
+        {
+            low.reset();
+            lowMid.reset();
+            highMid.reset();
+            high.reset();
+        }
+
+        BiquadFilter low, lowMid, highMid, high;
+    };
+
+    ColourFilters scanFilters, directFilters, overviewFilters;
+
+    int overviewStride, numOverviewProbes, numOverviewProbesDone;
+    HeapBlock<MinMaxColourValue> levelData, overviewLevels;
 
     void createReader()
     {
@@ -289,7 +356,7 @@ private:
 
         if (! isFullyLoaded())
         {
-            const int numToDo = (int) jmin (256 * (int64) owner.samplesPerThumbSample, lengthInSamples - numSamplesFinished);
+            const int numToDo = (int) jmin (maxThumbSamplesPerBlock * (int64) owner.samplesPerThumbSample, lengthInSamples - numSamplesFinished);
 
             if (numToDo > 0)
             {
@@ -299,15 +366,18 @@ private:
                 const int lastThumbIndex  = sampleToThumbSample (startSample + numToDo);
                 const int numThumbSamps = lastThumbIndex - firstThumbIndex;
 
-                HeapBlock<MinMaxColourValue> levelData (numThumbSamps * 2);
-                MinMaxColourValue* levels[2] = { levelData, levelData + numThumbSamps };
+                jassert (numThumbSamps <= maxThumbSamplesPerBlock + 1);
+
+                scratchArena.reset();
+
+                MinMaxColourValue* levels[2] = { levelData.getData(), levelData + numThumbSamps };
 
                 for (int i = 0; i < numThumbSamps; ++i)
                 {
                     float lowestLeft, highestLeft, lowestRight, highestRight;
                     Colour colourLeft, colourRight;
 
-                    readMaxLevelsFilteringWithColour ((firstThumbIndex + i) * owner.samplesPerThumbSample, owner.samplesPerThumbSample,
+                    readMaxLevelsFilteringWithColour (scanFilters, (firstThumbIndex + i) * owner.samplesPerThumbSample, owner.samplesPerThumbSample,
                                                       lowestLeft, highestLeft, lowestRight, highestRight,
                                                       colourLeft, colourRight);
 
@@ -330,7 +400,82 @@ private:
         return isFullyLoaded();
     }
 
-    void readMaxLevelsFilteringWithColour (int64 startSampleInFile,
+    //==============================================================================
+    /** Spreads the overview probes evenly across the thumb samples the scan will cover. */
+    void prepareOverview()
+    {
+        const int numThumbSamples = sampleToThumbSample (lengthInSamples);
+        overviewStride = numThumbSamples / maxOverviewProbes;
+
+        if (overviewStride < minOverviewStride)
+            return;
+
+        // the last probe also covers the remainder so is less than two strides long
+        numOverviewProbes = numThumbSamples / overviewStride;
+        overviewLevels.malloc ((size_t) (overviewProbesPerBlock + 1) * (size_t) overviewStride * 2);
+    }
+
+    /** Reads the next few overview probes, each one a single thumb sample from the
+        middle of its stride that is then used for the whole stride.
+    */
+    void readNextOverviewBlock()
+    {
+        jassert (reader != nullptr);
+
+        const int numThumbSamples = sampleToThumbSample (lengthInSamples);
+        const int firstProbe = numOverviewProbesDone;
+        const int endProbe = jmin (numOverviewProbes, firstProbe + (int) overviewProbesPerBlock);
+
+        auto getProbeStart = [&] (int probe) { return probe == numOverviewProbes ? numThumbSamples : probe * overviewStride; };
+
+        const int firstThumbIndex = getProbeStart (firstProbe);
+        const int numThumbSamps = getProbeStart (endProbe) - firstThumbIndex;
+
+        MinMaxColourValue* levels[2] = { overviewLevels.getData(), overviewLevels + numThumbSamps };
+
+        scratchArena.reset();
+
+        for (int probe = firstProbe; probe < endProbe; ++probe)
+        {
+            const int start = getProbeStart (probe) - firstThumbIndex;
+            const int end = getProbeStart (probe + 1) - firstThumbIndex;
+            const int64 probeSample = (firstThumbIndex + (start + end) / 2) * (int64) owner.samplesPerThumbSample;
+            const int64 prerollStart = jmax ((int64) 0, probeSample - overviewPrerollSamples);
+
+            float lowestLeft, highestLeft, lowestRight, highestRight;
+            Colour colourLeft, colourRight;
+
+            // let the filters settle on the preceding samples before taking the levels
+            overviewFilters.reset();
+            readMaxLevelsFilteringWithColour (overviewFilters, prerollStart, probeSample - prerollStart,
+                                              lowestLeft, highestLeft, lowestRight, highestRight,
+                                              colourLeft, colourRight);
+
+            readMaxLevelsFilteringWithColour (overviewFilters, probeSample, owner.samplesPerThumbSample,
+                                              lowestLeft, highestLeft, lowestRight, highestRight,
+                                              colourLeft, colourRight);
+
+            levels[0][start].setFloat (lowestLeft, highestLeft);
+            levels[1][start].setFloat (lowestRight, highestRight);
+            levels[0][start].setColour (colourLeft);
+            levels[1][start].setColour (colourRight);
+
+            for (int i = start + 1; i < end; ++i)
+            {
+                levels[0][i] = levels[0][start];
+                levels[1][i] = levels[1][start];
+            }
+        }
+
+        numOverviewProbesDone = endProbe;
+
+        {
+            const ScopedUnlock su (readerLock);
+            owner.setLevels (levels, firstThumbIndex, 2, numThumbSamps, false);
+        }
+    }
+
+    void readMaxLevelsFilteringWithColour (ColourFilters& filters, int64 startSampleInFile,
                                            int64 numSamples,
                                            float& lowestLeft, float& highestLeft,
                                            float& lowestRight, float& highestRight,
@@ -349,28 +494,17 @@ private:
             return;
         }
 
-        const int bufferSize = (int) jmin (numSamples, (int64) 4096);
-        const int newTempSampleBufferSize = bufferSize * 2 + 64;
+        // this is called for every thumb sample so give the space back when done
+        const ScratchArena::ScopedRewind rewind (scratchArena);
 
-        if (tempSampleBufferSize < newTempSampleBufferSize)
-        {
-            tempSampleBuffer.malloc (newTempSampleBufferSize);
-            tempSampleBufferSize = newTempSampleBufferSize;
-        }
+        const int bufferSize = (int) jmin (numSamples, (int64) maxSamplesPerRead);
 
-        int* tempSpace = tempSampleBuffer.getData();
+        int* tempSpace = scratchArena.allocate<int> ((size_t) bufferSize * 2 + 64);
         int* tempBuffer[3] = {&tempSpace[0],
                                 &tempSpace[bufferSize],
                                 nullptr};
 
-        const int filteredBlockSize = bufferSize * 4;
-        if (tempFilteredBufferSize < filteredBlockSize)
-        {
-            tempFilteredBuffer.malloc (filteredBlockSize);
-            tempFilteredBufferSize = filteredBlockSize;
-        }
-
-        int* filteredBlock = tempFilteredBuffer.getData();
+        int* filteredBlock = scratchArena.allocate<int> ((size_t) bufferSize * 4);
         int* filteredArray[4] = {&filteredBlock[0],
                                 &filteredBlock[bufferSize],
                                 &filteredBlock[bufferSize * 2],
@@ -398,10 +532,10 @@ private:
                 memcpy (filteredArray[3], tempBuffer[0], sizeof (int) * size_t (numToDo));
 
                 // filter buffers
-                filterLow.processSamples (reinterpret_cast<float*> (filteredArray[0]), numToDo);
-                filterLowMid.processSamples (reinterpret_cast<float*> (filteredArray[1]), numToDo);
-                filterHighMid.processSamples (reinterpret_cast<float*> (filteredArray[2]), numToDo);
-                filterHigh.processSamples (reinterpret_cast<float*> (filteredArray[3]), numToDo);
+                filters.low.processSamples (reinterpret_cast<float*> (filteredArray[0]), numToDo);
+                filters.lowMid.processSamples (reinterpret_cast<float*> (filteredArray[1]), numToDo);
+                filters.highMid.processSamples (reinterpret_cast<float*> (filteredArray[2]), numToDo);
+                filters.high.processSamples (reinterpret_cast<float*> (filteredArray[3]), numToDo);
 
                 // calculate colour
                 for (int i = 0; i < numToDo; ++i)
@@ -448,10 +582,10 @@ private:
                 memcpy (filteredArray[3], tempBuffer[0], sizeof (int) * size_t (numToDo));
 
                 // filter buffers
-                filterLow.processSamples ((filteredArray[0]), numToDo);
-                filterLowMid.processSamples ((filteredArray[1]), numToDo);
-                filterHighMid.processSamples ((filteredArray[2]), numToDo);
-                filterHigh.processSamples ((filteredArray[3]), numToDo);
+                filters.low.processSamples ((filteredArray[0]), numToDo);
+                filters.lowMid.processSamples ((filteredArray[1]), numToDo);
+                filters.highMid.processSamples ((filteredArray[2]), numToDo);
+                filters.high.processSamples ((filteredArray[3]), numToDo);
 
                 // calculate colour
                 for (int i = 0; i < numToDo; ++i)
@@ -542,7 +676,7 @@ public:
         result.set (1, 0);
     }
 
-    void getColour (int startSample, int endSample,  MinMaxColourValue& result) noexcept
+    void getColour (int startSample, int endSample,  MinMaxColourValue& result) const noexcept
     {
         const int numSamples = endSample - startSample;
 
@@ -840,8 +974,11 @@ ColouredAudioThumbnail::ColouredAudioThumbnail (const int originalSamplesPerThum
     window (new CachedWindow()),
     samplesPerThumbSample (originalSamplesPerThumbnailSample),
     totalSamples (0),
+    numSamplesFinished (0),
+    numOverviewSamples (0),
     numChannels (0),
-    sampleRate (0)
+    sampleRate (0),
+    progressive (false)
 {
 }
 
@@ -857,7 +994,7 @@ void ColouredAudioThumbnail::clear()
     const ScopedLock sl (lock);
     window->invalidate();
     channels.clear();
-    totalSamples = numSamplesFinished = 0;
+    totalSamples = numSamplesFinished = numOverviewSamples = 0;
     numChannels = 0;
     sampleRate = 0;
 
@@ -948,7 +1085,7 @@ bool ColouredAudioThumbnail::setDataSource (LevelDataSource* newSource)
         source.reset (newSource); // (make sure this isn't done before loadThumb is called)
 
         const ScopedLock sl (lock);
-        source->initialise (numSamplesFinished);
+        source->initialise (numSamplesFinished, progressive);
 
         totalSamples = source->lengthInSamples;
         sampleRate = source->sampleRate;
@@ -1014,17 +1151,43 @@ void ColouredAudioThumbnail::addBlock (const int64 startSample, const AudioSampl
     }
 }
 
-void ColouredAudioThumbnail::setLevels (const MinMaxColourValue* const* values, int thumbIndex, int numChans, int numValues)
+void ColouredAudioThumbnail::setLevels (const MinMaxColourValue* const* values, int thumbIndex, int numChans, int numValues,
+                                        bool isExact)
 {
-    const ScopedLock sl (lock);
+    const int64 startSample = thumbIndex * (int64) samplesPerThumbSample;
+    const int64 endSample = (thumbIndex + numValues) * (int64) samplesPerThumbSample;
+    double sampleRateUsed;
 
-    for (int i = jmin (numChans, channels.size()); --i >= 0;)
-        channels.getUnchecked(i)->write (values[i], thumbIndex, numValues);
+    {
+        const ScopedLock sl (lock);
 
-    numSamplesFinished = jmax (numSamplesFinished, (thumbIndex + numValues) * (int64) samplesPerThumbSample);
-    totalSamples = jmax (numSamplesFinished, totalSamples);
-    window->invalidate();
-    sendChangeMessage();
+        for (int i = jmin (numChans, channels.size()); --i >= 0;)
+            channels.getUnchecked(i)->write (values[i], thumbIndex, numValues);
+
+        // approximate levels from a progressive overview don't count as finished
+        if (isExact)
+            numSamplesFinished = jmax (numSamplesFinished, endSample);
+
+        numOverviewSamples = jmax (numOverviewSamples, endSample);
+        totalSamples = jmax (numSamplesFinished, totalSamples);
+        sampleRateUsed = sampleRate;
+        window->invalidate();
+        sendChangeMessage();
+    }
+
+    if (sampleRateUsed > 0.0)
+        listeners.call (&Listener::thumbnailLevelsChanged, this,
+                        startSample / sampleRateUsed, endSample / sampleRateUsed, isExact);
+}
+
+void ColouredAudioThumbnail::addListener (Listener* const listener)
+{
+    listeners.add (listener);
+}
+
+void ColouredAudioThumbnail::removeListener (Listener* const listener)
+{
+    listeners.remove (listener);
 }
 
 //==============================================================================
@@ -1043,6 +1206,11 @@ bool ColouredAudioThumbnail::isFullyLoaded() const noexcept
     return numSamplesFinished >= totalSamples - samplesPerThumbSample;
 }
 
+bool ColouredAudioThumbnail::isOverviewComplete() const noexcept
+{
+    return isFullyLoaded() || numOverviewSamples >= totalSamples - samplesPerThumbSample;
+}
+
 int64 ColouredAudioThumbnail::getNumSamplesFinished() const noexcept
 {
     return numSamplesFinished;
@@ -1077,6 +1245,27 @@ void ColouredAudioThumbnail::getApproximateMinMax (const double startTime, const
     maxValue = result.getMaxValue() / 128.0f;
 }
 
+void ColouredAudioThumbnail::getApproximateMinMaxColour (const double startTime, const double endTime, const int channelIndex,
+                                                         float& minValue, float& maxValue, Colour& colour) const noexcept
+{
+    const ScopedLock sl (lock);
+    MinMaxColourValue result;
+    const ThumbData* const data = channels [channelIndex];
+
+    if (data != nullptr && sampleRate > 0)
+    {
+        const int firstThumbIndex = (int) ((startTime * sampleRate) / samplesPerThumbSample);
+        const int lastThumbIndex  = (int) (((endTime * sampleRate) + samplesPerThumbSample - 1) / samplesPerThumbSample);
+
+        data->getMinMax (jmax (0, firstThumbIndex), lastThumbIndex, result);
+        data->getColour (jmax (0, firstThumbIndex), lastThumbIndex, result);
+    }
+
+    minValue = result.getMinValue() / 128.0f;
+    maxValue = result.getMaxValue() / 128.0f;
+    colour = result.colour;
+}
+
 void ColouredAudioThumbnail::drawChannel (Graphics& g, const Rectangle<int>& area, double startTime,
                                           double endTime, int channelNum, float verticalZoomFactor)
 {
@@ -180,6 +180,64 @@ public:
     /** Returns true if the low res preview is fully generated. */
     bool isFullyLoaded() const noexcept;
 
+    //==============================================================================
+    /** Enables a coarse-to-fine scan for sources set after this call.
+
+        Normally the file is scanned from start to end so the overview fills in from
+        left to right. In progressive mode a first pass reads a single thumb sample
+        from a few hundred windows spread across the whole file and stretches these
+        over the gaps, giving an approximate overview of the entire track almost
+        immediately. The normal sequential scan then replaces this with the exact
+        levels, which are identical to those of a non-progressive scan.
+
+        This is off by default.
+        @see isOverviewComplete, Listener
+    */
+    void setProgressive (bool shouldBeProgressive) noexcept     { progressive = shouldBeProgressive; }
+
+    /** Returns true if progressive mode is enabled. */
+    bool isProgressive() const noexcept                         { return progressive; }
+
+    /** Returns true once the whole length of the source has at least approximate levels.
+        This will be true as soon as the first pass of a progressive scan has finished
+        or when the thumbnail is fully loaded.
+    */
+    bool isOverviewComplete() const noexcept;
+
+    //==============================================================================
+    /** Receives notifications of the ranges of a ColouredAudioThumbnail that have changed.
+
+        Unlike the change message this tells you which part of the thumbnail has been
+        updated, so that only that area needs repainting.
+
+        @see ColouredAudioThumbnail::addListener
+    */
+    class Listener
+    {
+    public:
+        /** Destructor. */
+        virtual ~Listener() {}
+
+        /** Called when the levels for a range of the thumbnail have been set.
+
+            isExact will be false for the approximate levels of a progressive scan's
+            first pass, these ranges will be called again with isExact set to true
+            once the sequential scan reaches them.
+
+            @note This is called on the thread that is generating the levels, usually
+                  the AudioThumbnailCache's TimeSliceThread. The list is locked while
+                  it is called so removeListener will wait for it to return.
+        */
+        virtual void thumbnailLevelsChanged (ColouredAudioThumbnail* thumbnail,
+                                             double startTime, double endTime, bool isExact) = 0;
+    };
+
+    /** Adds a listener to be told when ranges of the thumbnail are updated. */
+    void addListener (Listener* listener);
+
+    /** Removes a previously-registered listener. */
+    void removeListener (Listener* listener);
+
     /** Returns the number of samples that have been set in the thumbnail. */
     int64 getNumSamplesFinished() const noexcept;
 
@@ -201,6 +259,13 @@ public:
     void getApproximateMinMax (double startTime, double endTime, int channelIndex,
                                float& minValue, float& maxValue) const noexcept;
 
+    /** Reads the approximate min and max levels and the colour from a section of the thumbnail.
+        This is the same as getApproximateMinMax() but also returns the frequency colour
+        that drawColouredChannel() would use to draw that section.
+    */
+    void getApproximateMinMaxColour (double startTime, double endTime, int channelIndex,
+                                     float& minValue, float& maxValue, Colour& colour) const noexcept;
+
     /** Returns the hash code that was set by setSource() or setReader(). */
     int64 getHashCode() const;
 
@@ -226,14 +291,17 @@ private:
     OwnedArray<ThumbData> channels;
 
     int32 samplesPerThumbSample;
-    int64 totalSamples, numSamplesFinished;
+    int64 totalSamples, numSamplesFinished, numOverviewSamples;
     int32 numChannels;
     double sampleRate;
+    bool progressive;
     CriticalSection lock;
+    ListenerList<Listener, Array<Listener*, CriticalSection>> listeners;
 
     //==============================================================================
     bool setDataSource (LevelDataSource* newSource);
-    void setLevels (const MinMaxColourValue* const* values, int thumbIndex, int numChans, int numValues);
+    void setLevels (const MinMaxColourValue* const* values, int thumbIndex, int numChans, int numValues,
+                    bool isExact = true);
     void createChannels (int length);
 
     //==============================================================================
@@ -38,8 +38,16 @@ DraggableWaveDisplay::DraggableWaveDisplay (AudioThumbnailImage& sourceToBeUsed)
       zoomRatio                     (1.0f),
       oneOverZoomRatio              (1.0f / zoomRatio),
       playheadPos                   (0.5f),
+      numRingColumns                (0),
+      ringStartColumn               (0),
+      ringEndColumn                 (0),
+      ringZoomRatio                 (1.0f),
+      ringNeedsRefresh              (true),
       isDraggable                   (true),
-      mouseShouldTogglePlay         (true)
+      mouseShouldTogglePlay         (true),
+      scrubbingSource               (nullptr),
+      scrubTargetTime               (0.0),
+      lastScrubTargetMs             (0.0)
 {
     setOpaque (true);
 
@@ -77,6 +85,14 @@ void DraggableWaveDisplay::setDraggable (bool isWaveformDraggable)
     isDraggable = isWaveformDraggable;
 }
 
+void DraggableWaveDisplay::setScrubbingAudioSource (ScrubbingAudioSource* newScrubbingSource)
+{
+    if (scrubbingSource != nullptr && scrubbingSource->isScrubbing())
+        scrubbingSource->endScrubbing (filePlayer.getAudioTransportSource()->isPlaying());
+
+    scrubbingSource = newScrubbingSource;
+}
+
 //====================================================================================
 void DraggableWaveDisplay::resized()
 {
@@ -92,28 +108,24 @@ void DraggableWaveDisplay::resized()
 void DraggableWaveDisplay::paint (Graphics &g)
 {
     const int w = getWidth();
-    const int h = getHeight();
-
-    g.fillAll (Colours::darkgrey);
 
     const int playHeadXPos = roundToInt (playheadPos * w);
     const double timeToPlayHead = pixelsToTime (playHeadXPos);
-    const double startTime = filePlayer.getAudioTransportSource()->getCurrentPosition() - timeToPlayHead;
-    const double duration = filePlayer.getAudioTransportSource()->getLengthInSeconds();
-    const double timeToDisplay = pixelsToTime (w);
+    const double startTime = getDisplayPosition() - timeToPlayHead;
 
-    const Image clippedImage (audioThumbnailImage.getImageAtTime (startTime, timeToDisplay));
+    // the waveform is kept as rings of display-sized columns at the current zoom
+    // so only the columns that have scrolled into view need to be rendered. There's
+    // a ring for each sub-pixel phase so the offset never has to be resampled
+    const int64 startPhase = (int64) std::floor (timeToPixels (startTime) * numSubPixelPhases + 0.5);
+    const int64 firstColumn = (int64) std::floor (startPhase / (double) numSubPixelPhases);
+    const int phase = (int) (startPhase - firstColumn * numSubPixelPhases);
 
-    int padLeft = 0, padRight = 0;
-    if (startTime < 0.0)
-        padLeft = roundToInt (timeToPixels (std::abs (startTime)));
-    if ((startTime + timeToDisplay) > duration)
-        padRight = roundToInt (timeToPixels (std::abs (duration - (startTime + timeToDisplay))));
+    updateRingImages (firstColumn);
 
-    g.drawImage (clippedImage,
-                 padLeft, 0, w - padLeft - padRight, h,
-                 0, 0, clippedImage.getWidth(), clippedImage.getHeight(),
-                 false);
+    // the ring is blitted twice, either side of the slot holding the first column
+    const int firstSlotX = -getRingSlot (firstColumn);
+    g.drawImageAt (ringImages[phase], firstSlotX + numRingColumns, 0);
+    g.drawImageAt (ringImages[phase], firstSlotX, 0);
 
     g.drawImageAt (playheadImage, playHeadXPos - 1, 0);
 }
@@ -140,6 +152,15 @@ void DraggableWaveDisplay::mouseDown (const MouseEvent &e)
 
         setMouseCursor (MouseCursor::DraggingHandCursor);
 
+        if (scrubbingSource != nullptr)
+        {
+            scrubTargetTime = filePlayer.getAudioTransportSource()->getCurrentPosition();
+            lastScrubTargetMs = Time::getMillisecondCounterHiRes();
+
+            scrubbingSource->beginScrubbing();
+            scrubbingSource->setScrubTarget ((int64) (scrubTargetTime * currentSampleRate), 0.0);
+        }
+
         startTimer (waveformMoved, 40);
     }
 }
@@ -150,6 +171,11 @@ void DraggableWaveDisplay::mouseUp (const MouseEvent& /*e*/)
 
     if (isDraggable)
     {
+        // a stopped transport is only about to play again if the drag stopped it
+        if (scrubbingSource != nullptr)
+            scrubbingSource->endScrubbing ((mouseShouldTogglePlay && shouldBePlaying)
+                                            || filePlayer.getAudioTransportSource()->isPlaying());
+
         if (mouseShouldTogglePlay)
         {
             if (shouldBePlaying && ! filePlayer.getAudioTransportSource()->isPlaying())
@@ -169,7 +195,8 @@ void DraggableWaveDisplay::timerCallback (const int timerId)
 {
     if (timerId == waveformUpdated) //moved due to file position changing
     {
-        movedX = roundToInt (timeToPixels (filePlayer.getAudioTransportSource()->getCurrentPosition()));
+        // only repaint when the waveform has moved by at least a sub-pixel phase
+        movedX = std::floor (timeToPixels (getDisplayPosition()) * numSubPixelPhases + 0.5);
 
         if (! movedX.areEqual())
             repaint();
@@ -181,7 +208,23 @@ void DraggableWaveDisplay::timerCallback (const int timerId)
             mouseX = getMouseXYRelative().getX();
             const int currentXDrag = mouseX.getDifference();
 
-            if (currentXDrag != 0)
+            if (scrubbingSource != nullptr)
+            {
+                // post a target every tick, even if it hasn't moved, so the scrub slows to a stop
+                const double nowMs = Time::getMillisecondCounterHiRes();
+                const double elapsedSeconds = jmax (0.001, (nowMs - lastScrubTargetMs) * 0.001);
+                const double timeMoved = -pixelsToTime (currentXDrag);
+
+                scrubTargetTime += timeMoved;
+                lastScrubTargetMs = nowMs;
+
+                scrubbingSource->setScrubTarget ((int64) (scrubTargetTime * currentSampleRate),
+                                                 timeMoved / elapsedSeconds);
+
+                if (currentXDrag != 0)
+                    repaint();
+            }
+            else if (currentXDrag != 0)
             {
                 const double position = filePlayer.getAudioTransportSource()->getCurrentPosition() - pixelsToTime (currentXDrag);
                 filePlayer.getAudioTransportSource()->setPosition (position);
@@ -195,7 +238,7 @@ void DraggableWaveDisplay::timerCallback (const int timerId)
         const int w = getWidth();
         const int playHeadXPos = roundToInt (playheadPos * w);
         const double timeToPlayHead = pixelsToTime (playHeadXPos);
-        const double startTime = filePlayer.getAudioTransportSource()->getCurrentPosition() - timeToPlayHead;
+        const double startTime = getDisplayPosition() - timeToPlayHead;
         const double timeToDisplay = pixelsToTime (w);
 
         const double timeAtEnd = startTime + timeToDisplay;
@@ -216,6 +259,7 @@ void DraggableWaveDisplay::imageChanged (AudioThumbnailImage* changedAudioThumbn
     if (changedAudioThumbnailImage == &audioThumbnailImage)
     {
         bool sourceLoaded = false;
+        ringNeedsRefresh = true;
 
         if (filePlayer.getAudioFormatReaderSource() != nullptr
             && filePlayer.getAudioFormatReaderSource()->getAudioFormatReader() != nullptr)
@@ -249,6 +293,14 @@ void DraggableWaveDisplay::imageChanged (AudioThumbnailImage* changedAudioThumbn
 }
 
 //==============================================================================
+double DraggableWaveDisplay::getDisplayPosition()
+{
+    if (scrubbingSource != nullptr && scrubbingSource->isScrubbing())
+        return scrubTargetTime;
+
+    return filePlayer.getAudioTransportSource()->getCurrentPosition();
+}
+
 double DraggableWaveDisplay::pixelsToTime (double numPixels)
 {
     return numPixels * timePerPixel * oneOverZoomRatio;
@@ -258,3 +310,97 @@ double DraggableWaveDisplay::timeToPixels (double timeInSecs)
 {
     return timeInSecs / (timePerPixel * oneOverZoomRatio);
 }
+
+//==============================================================================
+void DraggableWaveDisplay::updateRingImages (int64 firstColumn)
+{
+    const int w = jmax (1, getWidth());
+    const int h = jmax (1, getHeight());
+
+    if (ringNeedsRefresh.exchange (false)
+         || numRingColumns != w
+         || ringImages[0].getHeight() != h
+         || ringZoomRatio != zoomRatio)
+    {
+        numRingColumns = w;
+
+        for (auto& ringImage : ringImages)
+            ringImage = Image (Image::RGB, numRingColumns, h, false);
+
+        ringZoomRatio = zoomRatio;
+        ringStartColumn = ringEndColumn = firstColumn;
+    }
+
+    const int64 lastColumn = firstColumn + numRingColumns;
+
+    // columns past the end of what the thumbnail has rendered will need drawing again,
+    // allowing for the last phase reaching almost a column further into the source
+    int64 numCompleteColumns = lastColumn;
+
+    if (! audioThumbnailImage.hasFinishedLoading())
+        numCompleteColumns = (int64) std::floor (audioThumbnailImage.getNumPixelsRendered() * zoomRatio) - 1;
+
+    if (firstColumn < ringStartColumn || lastColumn > ringEndColumn)
+    {
+        const ScopedReadLock sl (audioThumbnailImage.getImageLock());
+        const Image sourceImage (audioThumbnailImage.getImage());
+
+        if (firstColumn >= ringEndColumn || lastColumn <= ringStartColumn)
+        {
+            renderRingColumns (sourceImage, firstColumn, lastColumn);
+        }
+        else
+        {
+            if (firstColumn < ringStartColumn)
+                renderRingColumns (sourceImage, firstColumn, ringStartColumn);
+
+            if (lastColumn > ringEndColumn)
+                renderRingColumns (sourceImage, ringEndColumn, lastColumn);
+        }
+    }
+
+    ringStartColumn = firstColumn;
+    ringEndColumn = jmax (firstColumn, jmin (lastColumn, numCompleteColumns));
+}
+
+void DraggableWaveDisplay::renderRingColumns (const Image& sourceImage, int64 startColumn, int64 endColumn)
+{
+    for (int phase = 0; phase < numSubPixelPhases; ++phase)
+    {
+        Graphics g (ringImages[phase]);
+        const double phaseOffset = phase / (double) numSubPixelPhases;
+
+        for (int64 column = startColumn; column < endColumn;)
+        {
+            const int slot = getRingSlot (column);
+            const int numColumns = (int) jmin (endColumn - column, (int64) (numRingColumns - slot));
+
+            drawRingColumns (g, sourceImage, column + phaseOffset, numColumns, slot);
+
+            column += numColumns;
+        }
+    }
+}
+
+void DraggableWaveDisplay::drawRingColumns (Graphics& g, const Image& sourceImage, double startColumn, int numColumns, int ringX)
+{
+    const int h = ringImages[0].getHeight();
+
+    Graphics::ScopedSaveState ss (g);
+    g.reduceClipRegion (ringX, 0, numColumns, h);
+    g.fillAll (Colours::darkgrey);
+
+    if (sourceImage.isValid())
+    {
+        // source pixels map to display columns by the zoom ratio, anything
+        // before the start or after the end of the file is left as padding
+        g.drawImageTransformed (sourceImage,
+                                AffineTransform::scale (zoomRatio, h / (float) sourceImage.getHeight())
+                                                .translated ((float) (ringX - startColumn), 0.0f));
+    }
+}
+
+int DraggableWaveDisplay::getRingSlot (int64 column) const noexcept
+{
+    return (int) (((column % numRingColumns) + numRingColumns) % numRingColumns);
+}
@@ -78,6 +78,14 @@ public:
      */
     bool getDraggable() const { return isDraggable; }
 
+    /** Sets a ScrubbingAudioSource to use when dragging.
+        When this is set, dragging the waveform scrubs through the audio rather than
+        repositioning the transport every time the mouse moves. The source should be
+        playing the same AudioFilePlayer as this display. Pass nullptr to go back to
+        repositioning the transport.
+     */
+    void setScrubbingAudioSource (ScrubbingAudioSource* newScrubbingSource);
+
     //====================================================================================
     /** @internal */
     void imageChanged (AudioThumbnailImage* audioThumbnailImage) override;
@@ -102,6 +110,28 @@ private:
      */
     inline double timeToPixels (double timeInSecs);
 
+    /** Returns the position to display, which is the scrub target whilst scrubbing.
+     */
+    double getDisplayPosition();
+
+    /** Renders any columns from firstColumn to the width of the display that
+        aren't already in the ring images.
+     */
+    void updateRingImages (int64 firstColumn);
+
+    /** Renders a range of display columns into their slots in each phase's ring image.
+     */
+    void renderRingColumns (const Image& sourceImage, int64 startColumn, int64 endColumn);
+
+    /** Draws a run of display columns, which may start part way into a column,
+        at a position in a ring image.
+     */
+    void drawRingColumns (Graphics& g, const Image& sourceImage, double startColumn, int numColumns, int ringX);
+
+    /** Returns the slot in the ring images that a display column is drawn into.
+     */
+    inline int getRingSlot (int64 column) const noexcept;
+
     /** Used to start and stop the various internal timers.
      */
     enum
@@ -111,6 +141,10 @@ private:
         waveformLoading
     };
 
+    /** The number of sub-pixel offsets the waveform can be drawn at.
+     */
+    enum { numSubPixelPhases = 4 };
+
     //==============================================================================
     AudioThumbnailImage& audioThumbnailImage;
     AudioFilePlayer& filePlayer;
@@ -125,8 +159,18 @@ private:
     CriticalSection lock;
     Image playheadImage;
 
+    Image ringImages[numSubPixelPhases];
+    int numRingColumns;
+    int64 ringStartColumn, ringEndColumn;
+    float ringZoomRatio;
+    std::atomic<bool> ringNeedsRefresh;
+
     bool isMouseDown, isDraggable, shouldBePlaying, mouseShouldTogglePlay;
-    StateVariable<int> mouseX, movedX;
+
+    ScrubbingAudioSource* scrubbingSource;
+    double scrubTargetTime, lastScrubTargetMs;
+    StateVariable<int> mouseX;
+    StateVariable<double> movedX;
 
     friend class SwitchableDraggableWaveDisplay;
 
@@ -40,6 +40,8 @@ PositionableWaveDisplay::PositionableWaveDisplay (AudioThumbnailImage& sourceToB
       verticalZoomRatio     (1.0),
       backgroundColour      (Colours::black),
       waveformColour        (Colours::green),
+      numSourcePixelsCached (0),
+      sourceGenerationCached (audioThumbnailImage.getImageGeneration()),
       audioTransportCursor  (audioFilePlayer)
 {
     setOpaque (true);
@@ -175,17 +177,31 @@ int PositionableWaveDisplay::useTimeSlice()
 {
     const ScopedLock sl (imageLock);
 
-    drawTimes = audioThumbnailImage.getTimeRendered();
+    // check this first so we don't miss the last section if it finishes in between
+    const bool finishedLoading = audioThumbnailImage.hasFinishedLoading();
 
-    if (! drawTimes.areEqual())
+    // hold the source lock throughout so the count and generation match the pixels drawn
+    const ScopedReadLock sourceLock (audioThumbnailImage.getImageLock());
+    const int numSourcePixelsRendered = audioThumbnailImage.getNumPixelsRendered();
+    const uint32 sourceGeneration = audioThumbnailImage.getImageGeneration();
+
+    // the source has been cleared or replaced since we last looked
+    if (sourceGeneration != sourceGenerationCached)
     {
-        cachedImage = audioThumbnailImage.getImage()
-                       .rescaled (cachedImage.getWidth(), cachedImage.getHeight());
+        cachedImage.clear (cachedImage.getBounds(), backgroundColour);
+        numSourcePixelsCached = 0;
+        sourceGenerationCached = sourceGeneration;
+    }
+
+    if (numSourcePixelsRendered > numSourcePixelsCached)
+    {
+        updateCachedImage (numSourcePixelsCached, numSourcePixelsRendered);
+        numSourcePixelsCached = numSourcePixelsRendered;
 
         triggerAsyncUpdate();
     }
 
-    if (audioThumbnailImage.hasFinishedLoading())
+    if (finishedLoading)
         threadToUse.removeTimeSliceClient (this);
 
     return 100;
@@ -199,6 +215,26 @@ void PositionableWaveDisplay::handleAsyncUpdate()
 //====================================================================================
 void PositionableWaveDisplay::refreshCachedImage()
 {
-    drawTimes.setBoth (0.0);
+    {
+        const ScopedLock sl (imageLock);
+        numSourcePixelsCached = 0;
+    }
+
     threadToUse.addTimeSliceClient (this);
 }
+
+void PositionableWaveDisplay::updateCachedImage (int startSourcePixel, int endSourcePixel)
+{
+    const Image sourceImage (audioThumbnailImage.getImage());
+    const float scaleX = cachedImage.getWidth() / (float) sourceImage.getWidth();
+    const float scaleY = cachedImage.getHeight() / (float) sourceImage.getHeight();
+
+    // redraw a pixel either side as the resampling may have blended in the neighbouring pixels
+    const int startX = jmax (0, (int) std::floor (startSourcePixel * scaleX) - 1);
+    const int endX = jmin (cachedImage.getWidth(), (int) std::ceil (endSourcePixel * scaleX) + 1);
+
+    // use the transform for the whole image so the strip lines up with the pixels already drawn
+    Graphics g (cachedImage);
+    g.reduceClipRegion (startX, 0, endX - startX, cachedImage.getHeight());
+    g.drawImageTransformed (sourceImage, AffineTransform::scale (scaleX, scaleY), false);
+}
@@ -115,13 +115,15 @@ private:
 
     Colour backgroundColour, waveformColour;
     Image cachedImage, cursorImage;
-
-    StateVariable<double> drawTimes;
+    int numSourcePixelsCached;
+    uint32 sourceGenerationCached;
 
     AudioTransportCursor audioTransportCursor;
 
     //==============================================================================
     void refreshCachedImage();
+    /** Draws a strip of the source image, the caller must hold its image lock. */
+    void updateCachedImage (int startSourcePixel, int endSourcePixel);
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PositionableWaveDisplay)
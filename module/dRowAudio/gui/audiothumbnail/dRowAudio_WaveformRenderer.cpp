@@ -0,0 +1,219 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+namespace WaveformRendererHelpers
+{
+    inline uint32 coverageToAlpha (float coverage) noexcept
+    {
+        return (uint32) jlimit (0, 255, roundToInt (coverage * 255.0f));
+    }
+
+    template <class PixelType>
+    inline void fillPixel (PixelType& dest, const PixelARGB& colour) noexcept
+    {
+        if (colour.getAlpha() == 255)
+            dest.set (colour);
+        else
+            dest.blend (colour);
+    }
+}
+
+//==============================================================================
+WaveformRenderer::WaveformRenderer()
+    : numColumns (0),
+      numColumnsAllocated (0),
+      hasColours (false),
+      antialias (true)
+{
+}
+
+WaveformRenderer::~WaveformRenderer()
+{
+}
+
+//==============================================================================
+void WaveformRenderer::readColumns (const AudioThumbnailBase& thumbnail, int channelNum,
+                                    double startTime, double secondsPerColumn, int numColumnsToRead)
+{
+    ensureColumnsAllocated (numColumnsToRead);
+
+    const ColouredAudioThumbnail* const colouredThumbnail = dynamic_cast<const ColouredAudioThumbnail*> (&thumbnail);
+    hasColours = colouredThumbnail != nullptr;
+
+    for (int i = 0; i < numColumns; ++i)
+    {
+        const double columnStartTime = startTime + i * secondsPerColumn;
+        const double columnEndTime = columnStartTime + secondsPerColumn;
+
+        if (colouredThumbnail != nullptr)
+        {
+            Colour colour;
+            colouredThumbnail->getApproximateMinMaxColour (columnStartTime, columnEndTime, channelNum,
+                                                           minValues[i], maxValues[i], colour);
+            colours[i] = colour.getPixelARGB();
+        }
+        else
+        {
+            thumbnail.getApproximateMinMax (columnStartTime, columnEndTime, channelNum,
+                                            minValues[i], maxValues[i]);
+        }
+    }
+}
+
+void WaveformRenderer::setColumns (const float* newMinValues, const float* newMaxValues,
+                                   const Colour* newColours, int numColumnsToSet)
+{
+    ensureColumnsAllocated (numColumnsToSet);
+    hasColours = newColours != nullptr;
+
+    for (int i = 0; i < numColumns; ++i)
+    {
+        minValues[i] = newMinValues[i];
+        maxValues[i] = newMaxValues[i];
+
+        if (hasColours)
+            colours[i] = newColours[i].getPixelARGB();
+    }
+}
+
+void WaveformRenderer::render (const Image::BitmapData& destData, int destX,
+                               Colour waveformColour, Colour backgroundColour) const noexcept
+{
+    switch (destData.pixelFormat)
+    {
+        case Image::RGB:    renderColumns<PixelRGB>  (destData, destX, waveformColour, backgroundColour); break;
+        case Image::ARGB:   renderColumns<PixelARGB> (destData, destX, waveformColour, backgroundColour); break;
+        default:            jassertfalse; break;
+    }
+}
+
+//==============================================================================
+void WaveformRenderer::ensureColumnsAllocated (int numColumnsNeeded)
+{
+    numColumns = jmax (0, numColumnsNeeded);
+
+    if (numColumns > numColumnsAllocated)
+    {
+        numColumnsAllocated = numColumns;
+        minValues.malloc ((size_t) numColumnsAllocated);
+        maxValues.malloc ((size_t) numColumnsAllocated);
+        colours.malloc ((size_t) numColumnsAllocated);
+    }
+}
+
+template <class PixelType>
+void WaveformRenderer::renderColumns (const Image::BitmapData& destData, int destX,
+                                      Colour waveformColour, Colour backgroundColour) const noexcept
+{
+    using namespace WaveformRendererHelpers;
+
+    const int width = jmin (numColumns, destData.width - destX);
+    const int height = destData.height;
+
+    if (destX < 0 || width <= 0 || height <= 0)
+        return;
+
+    PixelType background;
+    background.set (backgroundColour.getPixelARGB());
+
+    // the background rows are contiguous so can be filled in one go,
+    // the columns are then drawn over the top of them
+    for (int y = 0; y < height; ++y)
+    {
+        uint8* pixel = destData.getPixelPointer (destX, y);
+
+        if (destData.pixelStride == (int) sizeof (PixelType))
+        {
+            std::fill_n (reinterpret_cast<PixelType*> (pixel), width, background);
+        }
+        else
+        {
+            for (int x = 0; x < width; ++x, pixel += destData.pixelStride)
+                reinterpret_cast<PixelType*> (pixel)->set (background);
+        }
+    }
+
+    const PixelARGB waveformPixel (waveformColour.getPixelARGB());
+    const float midY = height * 0.5f;
+    const float scale = height * 0.5f;
+
+    for (int i = 0; i < width; ++i)
+    {
+        if (maxValues[i] <= minValues[i])
+            continue;
+
+        // these match the extents used by AudioThumbnail::drawChannel()
+        const float top = jmax (midY - maxValues[i] * scale - 0.3f, 0.0f);
+        const float bottom = jmin (midY - minValues[i] * scale + 0.3f, (float) height);
+
+        if (bottom <= top)
+            continue;
+
+        const PixelARGB colour (hasColours ? colours[i] : waveformPixel);
+        uint8* const column = destData.getPixelPointer (destX + i, 0);
+        const int lineStride = destData.lineStride;
+
+        auto pixelAt = [column, lineStride] (int y) -> PixelType&
+        {
+            return *reinterpret_cast<PixelType*> (column + y * lineStride);
+        };
+
+        int firstSolidRow, endSolidRow;
+
+        if (antialias)
+        {
+            const int topRow = (int) top;
+            const int bottomRow = (int) bottom;
+
+            if (topRow == bottomRow)
+            {
+                pixelAt (topRow).blend (colour, coverageToAlpha (bottom - top));
+                continue;
+            }
+
+            pixelAt (topRow).blend (colour, coverageToAlpha (topRow + 1 - top));
+
+            if (bottomRow < height)
+                pixelAt (bottomRow).blend (colour, coverageToAlpha (bottom - bottomRow));
+
+            firstSolidRow = topRow + 1;
+            endSolidRow = bottomRow;
+        }
+        else
+        {
+            firstSolidRow = roundToInt (top);
+            endSolidRow = jmin (height, jmax (firstSolidRow + 1, roundToInt (bottom)));
+        }
+
+        for (int y = firstSolidRow; y < endSolidRow; ++y)
+            fillPixel (pixelAt (y), colour);
+    }
+}
@@ -0,0 +1,115 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_WAVEFORMRENDERER_H
+#define DROWAUDIO_WAVEFORMRENDERER_H
+
+//==============================================================================
+/** Rasterises a waveform strip straight into an Image's pixels.
+
+    Rather than drawing an oversampled strip with a Graphics context and then
+    scaling it down, this reads one min/max pair (and colour if the thumbnail is
+    a ColouredAudioThumbnail) per destination pixel column and writes the spans
+    directly into an Image::BitmapData. The partially covered pixels at each end
+    of a span can optionally be blended by their coverage to give an analytically
+    anti-aliased edge.
+
+    This is used by AudioThumbnailImage but can be used on its own to render
+    sections of a thumbnail into any RGB or ARGB image.
+
+    @see AudioThumbnailImage
+ */
+class WaveformRenderer
+{
+public:
+    //==============================================================================
+    /** Creates an empty WaveformRenderer. */
+    WaveformRenderer();
+
+    /** Destructor. */
+    ~WaveformRenderer();
+
+    /** Sets whether the ends of each column should be blended by their coverage.
+        This is on by default.
+     */
+    void setAntialiasing (bool shouldAntialias) noexcept    {   antialias = shouldAntialias;    }
+
+    /** Returns true if the ends of the columns will be anti-aliased. */
+    bool isAntialiasing() const noexcept                    {   return antialias;               }
+
+    //==============================================================================
+    /** Reads the levels for a number of columns from a thumbnail.
+
+        Each column covers secondsPerColumn of the source starting at startTime.
+        If the thumbnail is a ColouredAudioThumbnail the frequency colour of each
+        column is read as well and will be used instead of the waveform colour
+        passed to render().
+     */
+    void readColumns (const AudioThumbnailBase& thumbnail, int channelNum,
+                      double startTime, double secondsPerColumn, int numColumns);
+
+    /** Sets the columns directly from a set of levels rather than reading them from a thumbnail.
+
+        This is useful if the levels have been calculated elsewhere, e.g. when streaming
+        a file. If newColours is nullptr the waveform colour passed to render() will be used.
+     */
+    void setColumns (const float* newMinValues, const float* newMaxValues,
+                     const Colour* newColours, int numColumnsToSet);
+
+    /** Returns the number of columns read by the last call to readColumns() or setColumns(). */
+    int getNumColumns() const noexcept                      {   return numColumns;              }
+
+    /** Renders the columns read by the last call to readColumns() or setColumns().
+
+        The columns are drawn starting at destX, filling the full height of the
+        bitmap with the background colour first. Only RGB and ARGB images are
+        supported.
+     */
+    void render (const Image::BitmapData& destData, int destX,
+                 Colour waveformColour, Colour backgroundColour) const noexcept;
+
+private:
+    //==============================================================================
+    HeapBlock<float> minValues, maxValues;
+    HeapBlock<PixelARGB> colours;
+    int numColumns, numColumnsAllocated;
+    bool hasColours, antialias;
+
+    void ensureColumnsAllocated (int numColumnsNeeded);
+
+    template <class PixelType>
+    void renderColumns (const Image::BitmapData&, int destX, Colour waveformColour, Colour backgroundColour) const noexcept;
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (WaveformRenderer)
+};
+
+#endif  // DROWAUDIO_WAVEFORMRENDERER_H
@@ -0,0 +1,746 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+namespace BatchImageRendererHelpers
+{
+    /** The number of samples read from each file at once. */
+    static const int readBlockSize = 16384;
+
+    /** Each waveform column is made from at least this many levels. */
+    static const int levelsPerColumn = 4;
+
+    /** Converts a magnitude to the grey level used by Spectrograph. */
+    inline uint8 magnitudeToGrey (float magnitude) noexcept
+    {
+        const double level = jlimit (0.0, 1.0, 1.0 + toDecibels (magnitude) / 100.0);
+        return (uint8) roundToInt (level * 255.0);
+    }
+}
+
+//==============================================================================
+/*  Gathers the min/max levels of each channel and the frequency colour in a single
+    pass, at a resolution fine enough to be reduced to any of the requested widths.
+    The colour uses the same bands as ColouredAudioThumbnail.
+ */
+class BatchImageRenderer::LevelAnalyser
+{
+public:
+    LevelAnalyser (int numChannels_, double sampleRate, int64 lengthInSamples, int maxWidth)
+        : numChannels (numChannels_),
+          samplesPerLevel ((int) jmax ((int64) 1, (lengthInSamples + maxWidth * BatchImageRendererHelpers::levelsPerColumn - 1)
+                                                    / (maxWidth * BatchImageRendererHelpers::levelsPerColumn))),
+          numLevels ((int) ((lengthInSamples + samplesPerLevel - 1) / samplesPerLevel)),
+          minValues ((size_t) (numChannels * numLevels)),
+          maxValues ((size_t) (numChannels * numLevels)),
+          colours ((size_t) numLevels, true),
+          bands ((size_t) BatchImageRendererHelpers::readBlockSize * 4),
+          levelIndex (0), levelPosition (0)
+    {
+        filterLow.setCoefficients (BiquadFilter::makeBandPass (sampleRate, 130.0, 2.0));
+        filterLowMid.setCoefficients (BiquadFilter::makeBandPass (sampleRate, 650.0, 2.0));
+        filterHighMid.setCoefficients (BiquadFilter::makeBandPass (sampleRate, 1300.0, 2.0));
+        filterHigh.setCoefficients (BiquadFilter::makeHighPass (sampleRate, 2700.0, 0.5));
+
+        resetLevel();
+    }
+
+    static size_t getMemoryUsage (int numChannels, int64 lengthInSamples, int maxWidth) noexcept
+    {
+        const int64 numLevels = jmin (lengthInSamples, (int64) maxWidth * BatchImageRendererHelpers::levelsPerColumn);
+        return (size_t) numLevels * (sizeof (float) * 2 * (size_t) numChannels + sizeof (Colour))
+                + sizeof (float) * 4 * BatchImageRendererHelpers::readBlockSize;
+    }
+
+    void process (const AudioSampleBuffer& buffer, int numSamples)
+    {
+        jassert (numSamples <= BatchImageRendererHelpers::readBlockSize);
+
+        // the colour is taken from the first channel's bands, the two mid bands are summed
+        float* const low = bands;
+        float* const mid = bands + BatchImageRendererHelpers::readBlockSize;
+        float* const highMid = mid + BatchImageRendererHelpers::readBlockSize;
+        float* const high = highMid + BatchImageRendererHelpers::readBlockSize;
+
+        const float* const firstChannel = buffer.getReadPointer (0);
+        FloatVectorOperations::copy (low, firstChannel, numSamples);
+        FloatVectorOperations::copy (mid, firstChannel, numSamples);
+        FloatVectorOperations::copy (highMid, firstChannel, numSamples);
+        FloatVectorOperations::copy (high, firstChannel, numSamples);
+
+        filterLow.processSamples (low, numSamples);
+        filterLowMid.processSamples (mid, numSamples);
+        filterHighMid.processSamples (highMid, numSamples);
+        filterHigh.processSamples (high, numSamples);
+
+        FloatVectorOperations::abs (low, low, numSamples);
+        FloatVectorOperations::abs (mid, mid, numSamples);
+        FloatVectorOperations::abs (highMid, highMid, numSamples);
+        FloatVectorOperations::abs (high, high, numSamples);
+        FloatVectorOperations::add (mid, highMid, numSamples);
+
+        for (int start = 0; start < numSamples;)
+        {
+            const int numThisTime = jmin (numSamples - start, samplesPerLevel - levelPosition);
+
+            for (int c = 0; c < numChannels; ++c)
+            {
+                const Range<float> range (FloatVectorOperations::findMinAndMax (buffer.getReadPointer (c, start), numThisTime));
+                levelMin[c] = jmin (levelMin[c], range.getStart());
+                levelMax[c] = jmax (levelMax[c], range.getEnd());
+            }
+
+            maxLow = jmax (maxLow, FloatVectorOperations::findMaximum (low + start, numThisTime));
+            maxMid = jmax (maxMid, FloatVectorOperations::findMaximum (mid + start, numThisTime));
+            maxHigh = jmax (maxHigh, FloatVectorOperations::findMaximum (high + start, numThisTime));
+
+            start += numThisTime;
+            levelPosition += numThisTime;
+
+            if (levelPosition == samplesPerLevel)
+                storeLevel();
+        }
+    }
+
+    /** Stores the last partial level, call this once the whole file has been processed. */
+    void finish()
+    {
+        if (levelPosition > 0)
+            storeLevel();
+    }
+
+    Image createImage (int width, int height, Colour backgroundColour) const
+    {
+        Image image (Image::RGB, width, height, false);
+        HeapBlock<float> columnMins ((size_t) width), columnMaxs ((size_t) width);
+        HeapBlock<Colour> columnColours ((size_t) width, true);
+        WaveformRenderer renderer;
+
+        // one strip per channel, stacked in the same way as drawChannels()
+        for (int c = 0; c < numChannels; ++c)
+        {
+            const int y1 = (c * height) / numChannels;
+            const int y2 = ((c + 1) * height) / numChannels;
+
+            if (y2 <= y1)
+                continue;
+
+            getColumns (c, width, columnMins, columnMaxs, columnColours);
+            renderer.setColumns (columnMins, columnMaxs, columnColours, width);
+
+            const Image::BitmapData destData (image, 0, y1, width, y2 - y1, Image::BitmapData::writeOnly);
+            renderer.render (destData, 0, Colours::white, backgroundColour);
+        }
+
+        return image;
+    }
+
+private:
+    const int numChannels, samplesPerLevel, numLevels;
+    HeapBlock<float> minValues, maxValues;
+    HeapBlock<Colour> colours;
+    HeapBlock<float> bands;
+    BiquadFilter filterLow, filterLowMid, filterHighMid, filterHigh;
+
+    int levelIndex, levelPosition;
+    float levelMin[2], levelMax[2];
+    float maxLow, maxMid, maxHigh;
+
+    void resetLevel() noexcept
+    {
+        for (int c = 0; c < 2; ++c)
+        {
+            levelMin[c] = std::numeric_limits<float>::max();
+            levelMax[c] = -std::numeric_limits<float>::max();
+        }
+
+        maxLow = maxMid = maxHigh = 0.0f;
+        levelPosition = 0;
+    }
+
+    void storeLevel() noexcept
+    {
+        if (levelIndex < numLevels)
+        {
+            for (int c = 0; c < numChannels; ++c)
+            {
+                minValues[c * numLevels + levelIndex] = levelMin[c];
+                maxValues[c * numLevels + levelIndex] = levelMax[c];
+            }
+
+            // the same weighting ColouredAudioThumbnail uses, kept at full brightness
+            colours[levelIndex] = Colour::fromRGB ((uint8) jlimit (0.0f, 255.0f, maxLow * 255.0f),
+                                                   (uint8) jlimit (0.0f, 255.0f, maxMid * 255.0f * 0.66f),
+                                                   (uint8) jlimit (0.0f, 255.0f, maxHigh * 255.0f * 0.33f))
+                                        .withBrightness (1.0f);
+            ++levelIndex;
+        }
+
+        resetLevel();
+    }
+
+    void getColumns (int channel, int numColumns, float* mins, float* maxs, Colour* columnColours) const noexcept
+    {
+        const float* const channelMins = minValues + channel * numLevels;
+        const float* const channelMaxs = maxValues + channel * numLevels;
+
+        for (int i = 0; i < numColumns; ++i)
+        {
+            const int start = jmin (levelIndex - 1, (int) ((i * (int64) levelIndex) / numColumns));
+            const int end = jmax (start + 1, (int) (((i + 1) * (int64) levelIndex) / numColumns));
+
+            float mn = channelMins[start], mx = channelMaxs[start];
+            uint8 red = 0, green = 0, blue = 0;
+
+            for (int l = start; l < end; ++l)
+            {
+                mn = jmin (mn, channelMins[l]);
+                mx = jmax (mx, channelMaxs[l]);
+                red = jmax (red, colours[l].getRed());
+                green = jmax (green, colours[l].getGreen());
+                blue = jmax (blue, colours[l].getBlue());
+            }
+
+            mins[i] = mn;
+            maxs[i] = mx;
+            columnColours[i] = Colour (red, green, blue);
+        }
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (LevelAnalyser)
+};
+
+#if DROWAUDIO_USE_FFTREAL
+//==============================================================================
+/*  Accumulates the average spectrum of the frames falling in each column of each
+    requested spectrogram, so only the columns are ever stored rather than every
+    frame of the file.
+ */
+class BatchImageRenderer::SpectrogramAnalyser
+{
+public:
+    SpectrogramAnalyser (int fftSizeLog2, int64 lengthInSamples, const Array<int>& widths)
+        : fftEngine (fftSizeLog2),
+          fftSize (fftEngine.getFFTSize()),
+          numBins (fftEngine.getFFTProperties().fftSizeHalved),
+          numFrames ((int) jmax ((int64) 1, lengthInSamples / fftSize)),
+          frame ((size_t) fftSize),
+          numInFrame (0), frameIndex (0)
+    {
+        fftEngine.setWindowType (Window::Hann);
+
+        for (auto width : widths)
+            columns.add (new Columns (width, numBins));
+    }
+
+    static size_t getMemoryUsage (int fftSizeLog2, const Array<int>& widths) noexcept
+    {
+        const size_t numBins = (size_t) 1 << (fftSizeLog2 - 1);
+        size_t bytes = sizeof (float) * 8 * numBins;
+
+        for (auto width : widths)
+            bytes += (size_t) width * (numBins * sizeof (float) + sizeof (int));
+
+        return bytes;
+    }
+
+    void process (const float* samples, int numSamples)
+    {
+        while (numSamples > 0)
+        {
+            const int numThisTime = jmin (numSamples, fftSize - numInFrame);
+            FloatVectorOperations::copy (frame + numInFrame, samples, numThisTime);
+
+            numInFrame += numThisTime;
+            samples += numThisTime;
+            numSamples -= numThisTime;
+
+            if (numInFrame == fftSize)
+            {
+                // the window is applied in place
+                fftEngine.performFFT (frame);
+                fftEngine.findMagnitudes();
+
+                const float* const magnitudes = fftEngine.getMagnitudesBuffer().getData();
+
+                for (auto* c : columns)
+                    c->add (jmin (c->width - 1, (int) ((frameIndex * (int64) c->width) / numFrames)), magnitudes);
+
+                ++frameIndex;
+                numInFrame = 0;
+            }
+        }
+    }
+
+    Image createImage (int columnsIndex, int height, bool logFrequency) const
+    {
+        using namespace BatchImageRendererHelpers;
+
+        const Columns& c = *columns.getUnchecked (columnsIndex);
+        Image image (Image::RGB, c.width, height, false);
+        const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+
+        // the range of bins covered by each row, using the same log scale as Spectrograph
+        HeapBlock<int> rowStart ((size_t) height), rowEnd ((size_t) height);
+
+        for (int y = 0; y < height; ++y)
+        {
+            double bottom = (height - 1 - y) / (double) height;
+            double top = (height - y) / (double) height;
+
+            if (logFrequency)
+            {
+                bottom = (std::pow (40.0, bottom) - 1.0) / 39.0;
+                top = (std::pow (40.0, top) - 1.0) / 39.0;
+            }
+
+            rowStart[y] = jlimit (0, numBins - 1, (int) std::floor (bottom * numBins));
+            rowEnd[y] = jlimit (rowStart[y] + 1, numBins, (int) std::ceil (top * numBins));
+        }
+
+        // columns with no frames of their own (short files) repeat the previous one
+        int lastColumn = -1;
+
+        for (int x = 0; x < c.width; ++x)
+        {
+            if (c.counts[x] > 0)
+                lastColumn = x;
+
+            const float* const sums = lastColumn >= 0 ? c.sums + lastColumn * numBins : nullptr;
+            const float scale = lastColumn >= 0 ? 1.0f / c.counts[lastColumn] : 0.0f;
+
+            for (int y = 0; y < height; ++y)
+            {
+                const uint8 grey = sums != nullptr
+                                    ? magnitudeToGrey (scale * FloatVectorOperations::findMaximum (sums + rowStart[y], rowEnd[y] - rowStart[y]))
+                                    : 0;
+
+                reinterpret_cast<PixelRGB*> (destData.getPixelPointer (x, y))->setARGB (255, grey, grey, grey);
+            }
+        }
+
+        return image;
+    }
+
+private:
+    struct Columns
+    {
+        Columns (int width_, int numBins_)
+            : width (width_), numBins (numBins_),
+              sums ((size_t) (width_ * numBins_), true),
+              counts ((size_t) width_, true)
+        {
+        }
+
+        void add (int column, const float* magnitudes) noexcept
+        {
+            FloatVectorOperations::add (sums + column * numBins, magnitudes, numBins);
+            ++counts[column];
+        }
+
+        const int width, numBins;
+        HeapBlock<float> sums;
+        HeapBlock<int> counts;
+    };
+
+    FFTEngine fftEngine;
+    const int fftSize, numBins, numFrames;
+    HeapBlock<float> frame;
+    int numInFrame;
+    int64 frameIndex;
+    OwnedArray<Columns> columns;
+
+    JUCE_DECLARE_NON_COPYABLE (SpectrogramAnalyser)
+};
+#endif
+
+//==============================================================================
+/*  Hands out bytes from a fixed budget, blocking until enough have been returned.
+    A request bigger than the whole budget is allowed once nothing else holds any
+    so that one very long file can't stall the batch.
+ */
+class BatchImageRenderer::MemoryBudget
+{
+public:
+    MemoryBudget (size_t totalBytes_)
+        : totalBytes (totalBytes_), bytesInUse (0)
+    {
+    }
+
+    bool acquire (size_t bytes, ThreadPoolJob& job)
+    {
+        for (;;)
+        {
+            {
+                const ScopedLock sl (lock);
+
+                if (bytesInUse == 0 || bytesInUse + bytes <= totalBytes)
+                {
+                    bytesInUse += bytes;
+                    return true;
+                }
+            }
+
+            if (job.shouldExit())
+                return false;
+
+            bytesReleased.wait (50);
+        }
+    }
+
+    void release (size_t bytes)
+    {
+        {
+            const ScopedLock sl (lock);
+            jassert (bytes <= bytesInUse);
+            bytesInUse -= bytes;
+        }
+
+        bytesReleased.signal();
+    }
+
+private:
+    const size_t totalBytes;
+    size_t bytesInUse;
+    CriticalSection lock;
+    WaitableEvent bytesReleased;
+
+    JUCE_DECLARE_NON_COPYABLE (MemoryBudget)
+};
+
+//==============================================================================
+class BatchImageRenderer::RenderJob  : public ThreadPoolJob
+{
+public:
+    RenderJob (const BatchImageRenderer& owner_, MemoryBudget& budget_,
+               const File& sourceFile_, const File& outputDirectory_, const String& outputName_)
+        : ThreadPoolJob ("BatchImageRenderer: " + sourceFile_.getFileName()),
+          numImagesWritten (0),
+          owner (owner_), budget (budget_),
+          sourceFile (sourceFile_), outputDirectory (outputDirectory_),
+          outputName (outputName_)
+    {
+    }
+
+    JobStatus runJob() override
+    {
+        DROWAUDIO_TRACE_THREAD();
+        DROWAUDIO_TRACE_SCOPE ("BatchImageRenderer::RenderJob")
+
+        size_t bytesNeeded = 0;
+
+        {
+            // the reader is only opened long enough to get the length, so waiting jobs
+            // don't hold on to file handles and read buffers
+            const std::unique_ptr<AudioFormatReader> reader (owner.formatManager.createReaderFor (sourceFile));
+
+            if (reader == nullptr)
+            {
+                error = "Unable to open " + sourceFile.getFullPathName();
+                return jobHasFinished;
+            }
+
+            bytesNeeded = owner.estimateMemoryUsage (*reader);
+        }
+
+        if (! budget.acquire (bytesNeeded, *this))
+        {
+            error = "Cancelled " + sourceFile.getFullPathName();
+            return jobHasFinished;
+        }
+
+        std::unique_ptr<AudioFormatReader> reader (owner.formatManager.createReaderFor (sourceFile));
+
+        if (reader == nullptr)
+        {
+            error = "Unable to open " + sourceFile.getFullPathName();
+        }
+        else
+        {
+            const Array<Image> images (owner.renderImages (*reader));
+            reader = nullptr;
+
+            PNGImageFormat pngFormat;
+
+            for (int i = 0; i < images.size(); ++i)
+            {
+                // only a spectrogram can't be rendered, when there's no FFT
+                if (! images.getReference (i).isValid())
+                {
+                    error = "Unable to render a spectrogram of " + sourceFile.getFullPathName()
+                             + " without DROWAUDIO_USE_FFTREAL";
+                    continue;
+                }
+
+                const File destFile (outputDirectory.getChildFile (getImageFileName (outputName, owner.imageSpecs.getReference (i))));
+                destFile.deleteFile();
+                FileOutputStream output (destFile);
+
+                if (output.openedOk() && pngFormat.writeImageToStream (images.getReference (i), output))
+                    ++numImagesWritten;
+                else
+                    error = "Unable to write " + destFile.getFullPathName();
+            }
+        }
+
+        budget.release (bytesNeeded);
+
+        return jobHasFinished;
+    }
+
+    int numImagesWritten;
+    String error;
+
+private:
+    const BatchImageRenderer& owner;
+    MemoryBudget& budget;
+    const File sourceFile, outputDirectory;
+    const String outputName;
+
+    JUCE_DECLARE_NON_COPYABLE (RenderJob)
+};
+
+//==============================================================================
+BatchImageRenderer::BatchImageRenderer (AudioFormatManager& formatManagerToUse)
+    : formatManager (formatManagerToUse),
+      backgroundColour (Colours::black),
+      fftSizeLog2 (11),
+      numThreads (SystemStats::getNumCpus()),
+      memoryBudget ((size_t) 256 * 1024 * 1024),
+      logFrequency (true)
+{
+}
+
+BatchImageRenderer::~BatchImageRenderer()
+{
+}
+
+//==============================================================================
+void BatchImageRenderer::addImage (ImageType type, int width, int height)
+{
+    jassert (width > 0 && height > 0);
+
+   #if ! DROWAUDIO_USE_FFTREAL
+    // spectrograms need the FFT, enable DROWAUDIO_USE_FFTREAL
+    jassert (type != spectrogram);
+   #endif
+
+    ImageSpec spec;
+    spec.type = type;
+    spec.width = jmax (1, width);
+    spec.height = jmax (1, height);
+
+    imageSpecs.add (spec);
+}
+
+void BatchImageRenderer::clearImages()
+{
+    imageSpecs.clear();
+}
+
+//==============================================================================
+BatchImageRenderer::Statistics BatchImageRenderer::renderFiles (const Array<File>& files, const File& outputDirectory)
+{
+    Statistics stats;
+    outputDirectory.createDirectory();
+
+    const double startMs = Time::getMillisecondCounterHiRes();
+    MemoryBudget budget (memoryBudget);
+    OwnedArray<RenderJob> jobs;
+    StringArray outputNames;
+
+    // files with the same name from different folders are numbered so their images
+    // don't overwrite each other
+    for (auto& file : files)
+    {
+        const String name (file.getFileNameWithoutExtension());
+        String outputName (name);
+
+        for (int n = 2; outputNames.contains (outputName, true); ++n)
+            outputName = name + "_" + String (n);
+
+        outputNames.add (outputName);
+    }
+
+    {
+        ThreadPool pool (numThreads);
+
+        for (int i = 0; i < files.size(); ++i)
+            pool.addJob (jobs.add (new RenderJob (*this, budget, files.getReference (i), outputDirectory, outputNames[i])), false);
+
+        for (auto* job : jobs)
+            pool.waitForJobToFinish (job, -1);
+    }
+
+    stats.secondsElapsed = (Time::getMillisecondCounterHiRes() - startMs) / 1000.0;
+
+    for (auto* job : jobs)
+    {
+        stats.numImagesWritten += job->numImagesWritten;
+
+        if (job->error.isEmpty())
+        {
+            ++stats.numFilesRendered;
+        }
+        else
+        {
+            ++stats.numFilesFailed;
+            stats.errors.add (job->error);
+        }
+    }
+
+    return stats;
+}
+
+Array<Image> BatchImageRenderer::renderImages (AudioFormatReader& reader) const
+{
+    using namespace BatchImageRendererHelpers;
+
+    Array<Image> images;
+    const int64 lengthInSamples = reader.lengthInSamples;
+    const int numChannels = jlimit (1, 2, (int) reader.numChannels);
+
+    if (lengthInSamples <= 0 || imageSpecs.isEmpty())
+        return images;
+
+    int maxWaveformWidth = 0;
+    Array<int> spectrogramWidths;
+
+    for (auto& spec : imageSpecs)
+    {
+        if (spec.type == waveform)
+            maxWaveformWidth = jmax (maxWaveformWidth, spec.width);
+        else
+            spectrogramWidths.add (spec.width);
+    }
+
+    std::unique_ptr<LevelAnalyser> levels;
+
+    if (maxWaveformWidth > 0)
+        levels = std::make_unique<LevelAnalyser> (numChannels, reader.sampleRate, lengthInSamples, maxWaveformWidth);
+
+   #if DROWAUDIO_USE_FFTREAL
+    std::unique_ptr<SpectrogramAnalyser> spectrograms;
+
+    if (! spectrogramWidths.isEmpty())
+        spectrograms = std::make_unique<SpectrogramAnalyser> (fftSizeLog2, lengthInSamples, spectrogramWidths);
+   #endif
+
+    // the single pass through the file
+    AudioSampleBuffer buffer (numChannels, readBlockSize);
+    HeapBlock<float> mono ((size_t) readBlockSize);
+
+    for (int64 position = 0; position < lengthInSamples; position += readBlockSize)
+    {
+        const int numThisTime = (int) jmin ((int64) readBlockSize, lengthInSamples - position);
+        reader.read (&buffer, 0, numThisTime, position, true, true);
+
+        if (levels != nullptr)
+            levels->process (buffer, numThisTime);
+
+       #if DROWAUDIO_USE_FFTREAL
+        if (spectrograms != nullptr)
+        {
+            FloatVectorOperations::copy (mono, buffer.getReadPointer (0), numThisTime);
+
+            if (numChannels > 1)
+            {
+                FloatVectorOperations::add (mono, buffer.getReadPointer (1), numThisTime);
+                FloatVectorOperations::multiply (mono, 0.5f, numThisTime);
+            }
+
+            spectrograms->process (mono, numThisTime);
+        }
+       #endif
+    }
+
+    if (levels != nullptr)
+        levels->finish();
+
+    int spectrogramIndex = 0;
+
+    for (auto& spec : imageSpecs)
+    {
+        if (spec.type == waveform)
+        {
+            images.add (levels->createImage (spec.width, spec.height, backgroundColour));
+        }
+        else
+        {
+           #if DROWAUDIO_USE_FFTREAL
+            images.add (spectrograms->createImage (spectrogramIndex++, spec.height, logFrequency));
+           #else
+            images.add (Image());
+           #endif
+        }
+    }
+
+    ignoreUnused (spectrogramIndex);
+
+    return images;
+}
+
+size_t BatchImageRenderer::estimateMemoryUsage (const AudioFormatReader& reader) const
+{
+    using namespace BatchImageRendererHelpers;
+
+    const int numChannels = jlimit (1, 2, (int) reader.numChannels);
+    size_t bytes = sizeof (float) * (size_t) (numChannels + 1) * readBlockSize;
+    int maxWaveformWidth = 0;
+    Array<int> spectrogramWidths;
+
+    // the finished images are all held until they have been written
+    for (auto& spec : imageSpecs)
+    {
+        bytes += (size_t) spec.width * (size_t) spec.height * 4;
+
+        if (spec.type == waveform)
+            maxWaveformWidth = jmax (maxWaveformWidth, spec.width);
+        else
+            spectrogramWidths.add (spec.width);
+    }
+
+    if (maxWaveformWidth > 0)
+        bytes += LevelAnalyser::getMemoryUsage (numChannels, reader.lengthInSamples, maxWaveformWidth);
+
+   #if DROWAUDIO_USE_FFTREAL
+    if (! spectrogramWidths.isEmpty())
+        bytes += SpectrogramAnalyser::getMemoryUsage (fftSizeLog2, spectrogramWidths);
+   #endif
+
+    return bytes;
+}
+
+String BatchImageRenderer::getImageFileName (const String& outputName, const ImageSpec& spec)
+{
+    return outputName
+            + (spec.type == waveform ? "_waveform_" : "_spectrogram_")
+            + String (spec.width) + "x" + String (spec.height) + ".png";
+}
@@ -0,0 +1,169 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_BATCHIMAGERENDERER_H
+#define DROWAUDIO_BATCHIMAGERENDERER_H
+
+//==============================================================================
+/**
+    Renders waveform and spectrogram images of many audio files without any GUI.
+
+    Each file is streamed through once: the waveform levels and colours (using
+    the same bands as ColouredAudioThumbnail) and the spectrogram columns are
+    all gathered in a single pass, then each requested image is rendered straight
+    into a bitmap and written as a PNG.
+
+    Files are processed concurrently on a ThreadPool. Each job estimates how much
+    memory it will need from the file length and requested image sizes and waits
+    until that fits in the memory budget, so large batches of long files can't
+    exhaust the machine.
+
+    @code
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        BatchImageRenderer renderer (formatManager);
+        renderer.addImage (BatchImageRenderer::waveform, 1800, 140);
+        renderer.addImage (BatchImageRenderer::spectrogram, 1800, 256);
+
+        const BatchImageRenderer::Statistics stats (renderer.renderFiles (files, outputDirectory));
+        DBG (stats.getFilesPerSecond());
+    @endcode
+
+    @see WaveformRenderer, Spectrograph, ColouredAudioThumbnail
+*/
+class BatchImageRenderer
+{
+public:
+    //==============================================================================
+    /** The types of image that can be rendered. */
+    enum ImageType
+    {
+        waveform,       /**< A coloured waveform with one strip per channel. */
+        spectrogram     /**< A greyscale spectrogram of the mono mix, requires DROWAUDIO_USE_FFTREAL. */
+    };
+
+    /** Holds the totals for a call to renderFiles(). */
+    struct Statistics
+    {
+        int numFilesRendered = 0, numFilesFailed = 0, numImagesWritten = 0;
+        double secondsElapsed = 0.0;
+        StringArray errors;
+
+        /** Returns the number of files rendered per second of wall time. */
+        double getFilesPerSecond() const noexcept
+        {
+            return secondsElapsed > 0.0 ? numFilesRendered / secondsElapsed : 0.0;
+        }
+    };
+
+    //==============================================================================
+    /** Creates a BatchImageRenderer that will open files with a given AudioFormatManager. */
+    BatchImageRenderer (AudioFormatManager& formatManagerToUse);
+
+    /** Destructor. */
+    ~BatchImageRenderer();
+
+    //==============================================================================
+    /** Adds an image to be created for each file.
+
+        The PNGs are named after the source file followed by the type and size,
+        e.g. "track_waveform_1800x140.png". If several files in a batch have the same
+        name the later ones are numbered, e.g. "track_2_waveform_1800x140.png".
+
+        Spectrograms need DROWAUDIO_USE_FFTREAL, without it they are reported as errors.
+    */
+    void addImage (ImageType type, int width, int height);
+
+    /** Removes all the images that have been added. */
+    void clearImages();
+
+    /** Sets the background colour of the waveform images, the default is black.
+        The waveform itself is drawn in the same frequency colours as ColouredAudioThumbnail.
+    */
+    void setBackgroundColour (Colour newBackgroundColour) noexcept  { backgroundColour = newBackgroundColour; }
+
+    /** Sets the log2 of the FFT size used for spectrograms, the default is 11. */
+    void setFFTSizeLog2 (int newFFTSizeLog2) noexcept               { fftSizeLog2 = newFFTSizeLog2; }
+
+    /** Sets whether spectrograms use a log frequency axis, the default is true. */
+    void setLogFrequency (bool shouldUseLogFrequency) noexcept      { logFrequency = shouldUseLogFrequency; }
+
+    /** Sets the number of files to process at once, the default is the number of CPU cores. */
+    void setNumThreads (int newNumThreads) noexcept                 { numThreads = jmax (1, newNumThreads); }
+
+    /** Sets the memory budget in bytes shared by all the concurrent jobs, the default is 256MB.
+        A file that needs more than the whole budget is still rendered, but only when
+        nothing else is running.
+    */
+    void setMemoryBudget (size_t newBudgetInBytes) noexcept         { memoryBudget = jmax ((size_t) 1, newBudgetInBytes); }
+
+    //==============================================================================
+    /** Renders the images for a number of files into a directory.
+        This blocks until all the files have been processed.
+    */
+    Statistics renderFiles (const Array<File>& files, const File& outputDirectory);
+
+    /** Renders the images for a single reader, returned in the order they were added.
+        This does the single streaming pass of the reader and can be called from any thread.
+    */
+    Array<Image> renderImages (AudioFormatReader& reader) const;
+
+    /** Returns an estimate of the memory needed to render a reader's images. */
+    size_t estimateMemoryUsage (const AudioFormatReader& reader) const;
+
+private:
+    //==============================================================================
+    struct ImageSpec
+    {
+        ImageType type;
+        int width, height;
+    };
+
+    class LevelAnalyser;
+    class SpectrogramAnalyser;
+    class MemoryBudget;
+    class RenderJob;
+
+    AudioFormatManager& formatManager;
+    Array<ImageSpec> imageSpecs;
+    Colour backgroundColour;
+    int fftSizeLog2, numThreads;
+    size_t memoryBudget;
+    bool logFrequency;
+
+    static String getImageFileName (const String& outputName, const ImageSpec& spec);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (BatchImageRenderer)
+};
+
+#endif  // DROWAUDIO_BATCHIMAGERENDERER_H
@@ -68,6 +68,7 @@ void GraphicalComponent::copySamples (const float *values, int numSamples_)
     }
 
     // lock whilst copying
+    DROWAUDIO_CHECK_REALTIME_LOCK ("GraphicalComponent::copySamples");
     ScopedLock sl (lock);
     std::memcpy (samples, values, size_t (numSamples) * sizeof (float));
 
@@ -84,6 +85,7 @@ void GraphicalComponent::copySamples (float **values, int numSamples_, int numCh
     }
 
     // lock whilst copying
+    DROWAUDIO_CHECK_REALTIME_LOCK ("GraphicalComponent::copySamples");
     ScopedLock sl (lock);
 
     if (numChannels == 1)
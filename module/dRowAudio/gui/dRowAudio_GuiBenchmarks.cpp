@@ -0,0 +1,373 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#if DROWAUDIO_BENCHMARKS
+
+//==============================================================================
+namespace GuiBenchmarkHelpers
+{
+    inline void createSyntheticFile (MemoryBlock& destData, double sampleRate, int numSamples, int bitDepth)
+    {
+        AudioSampleBuffer buffer (2, numSamples);
+        Random random (0x1234);
+
+        for (int c = 0; c < 2; ++c)
+        {
+            float* data = buffer.getWritePointer (c);
+
+            for (int i = 0; i < numSamples; ++i)
+            {
+                const double t = i / sampleRate;
+                data[i] = 0.4f * (float) std::sin (2.0 * MathConstants<double>::pi * 60.0 * t)
+                            + 0.2f * (float) std::sin (2.0 * MathConstants<double>::pi * 3000.0 * t)
+                            + 0.1f * (random.nextFloat() * 2.0f - 1.0f);
+            }
+        }
+
+        WavAudioFormat wavFormat;
+        std::unique_ptr<AudioFormatWriter> writer (wavFormat.createWriterFor (new MemoryOutputStream (destData, false),
+                                                                              sampleRate, 2, bitDepth, {}, 0));
+
+        if (writer != nullptr)
+            writer->writeFromAudioSampleBuffer (buffer, 0, numSamples);
+    }
+}
+
+//==============================================================================
+class ColouredAudioThumbnailBenchmark  : public PerformanceBenchmark
+{
+public:
+    ColouredAudioThumbnailBenchmark() : PerformanceBenchmark ("ColouredAudioThumbnail", "gui") {}
+
+    void runBenchmark() override
+    {
+        const double sampleRate = 44100.0;
+        const int numSamples = (int) (sampleRate * 60.0);
+
+        MemoryBlock floatFile, intFile;
+        GuiBenchmarkHelpers::createSyntheticFile (floatFile, sampleRate, numSamples, 32);
+        GuiBenchmarkHelpers::createSyntheticFile (intFile, sampleRate, numSamples, 16);
+
+        const int samplesPerThumbSample[] = { 64, 512 };
+
+        for (auto spts : samplesPerThumbSample)
+        {
+            measureLevelGeneration ("16-bit " + String (spts) + " per thumb sample", intFile, spts, numSamples, sampleRate);
+            measureLevelGeneration ("32-bit float " + String (spts) + " per thumb sample", floatFile, spts, numSamples, sampleRate);
+            measureProgressiveGeneration ("16-bit progressive " + String (spts) + " per thumb sample", intFile, spts, numSamples, sampleRate);
+        }
+    }
+
+private:
+    void measureLevelGeneration (const String& caseName, const MemoryBlock& fileData,
+                                 int samplesPerThumbSample, int numSamples, double sampleRate)
+    {
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        AudioThumbnailCache cache (1);
+        int64 hash = 0;
+
+        measure (caseName, numSamples, sampleRate, [&]
+        {
+            WavAudioFormat wavFormat;
+            AudioFormatReader* reader = wavFormat.createReaderFor (new MemoryInputStream (fileData, false), true);
+
+            ColouredAudioThumbnail thumbnail (samplesPerThumbSample, formatManager, cache);
+            thumbnail.setReader (reader, ++hash);
+
+            while (! thumbnail.isFullyLoaded())
+                Thread::yield();
+
+            cache.clear();
+        });
+    }
+
+    /** Measures how long the approximate overview takes to cover the whole file and
+        checks the finished levels against a normal sequential scan.
+    */
+    void measureProgressiveGeneration (const String& caseName, const MemoryBlock& fileData,
+                                       int samplesPerThumbSample, int numSamples, double sampleRate)
+    {
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        AudioThumbnailCache cache (1);
+        WavAudioFormat wavFormat;
+        int64 hash = 0;
+        double overviewMs = 0.0;
+
+        measure (caseName, numSamples, sampleRate, [&]
+        {
+            ColouredAudioThumbnail thumbnail (samplesPerThumbSample, formatManager, cache);
+            thumbnail.setProgressive (true);
+
+            const double startMs = Time::getMillisecondCounterHiRes();
+            thumbnail.setReader (wavFormat.createReaderFor (new MemoryInputStream (fileData, false), true), ++hash);
+
+            while (! thumbnail.isOverviewComplete())
+                Thread::yield();
+
+            overviewMs = Time::getMillisecondCounterHiRes() - startMs;
+
+            while (! thumbnail.isFullyLoaded())
+                Thread::yield();
+
+            cache.clear();
+        });
+
+        logValue (caseName, "msToOverview", overviewMs);
+
+        ColouredAudioThumbnail sequential (samplesPerThumbSample, formatManager, cache);
+        ColouredAudioThumbnail progressive (samplesPerThumbSample, formatManager, cache);
+        progressive.setProgressive (true);
+
+        sequential.setReader (wavFormat.createReaderFor (new MemoryInputStream (fileData, false), true), ++hash);
+        progressive.setReader (wavFormat.createReaderFor (new MemoryInputStream (fileData, false), true), ++hash);
+
+        while (! (sequential.isFullyLoaded() && progressive.isFullyLoaded()))
+            Thread::yield();
+
+        const double thumbSampleLength = samplesPerThumbSample / sampleRate;
+        const int numThumbSamples = numSamples / samplesPerThumbSample;
+        int numMismatches = 0;
+
+        for (int i = 0; i < numThumbSamples; ++i)
+        {
+            for (int channel = 0; channel < 2; ++channel)
+            {
+                float minA, maxA, minB, maxB;
+                Colour colourA, colourB;
+                sequential.getApproximateMinMaxColour (i * thumbSampleLength, (i + 1) * thumbSampleLength, channel, minA, maxA, colourA);
+                progressive.getApproximateMinMaxColour (i * thumbSampleLength, (i + 1) * thumbSampleLength, channel, minB, maxB, colourB);
+
+                if (minA != minB || maxA != maxB || colourA != colourB)
+                    ++numMismatches;
+            }
+        }
+
+        logValue (caseName, "mismatchesWithSequentialScan", numMismatches);
+        cache.clear();
+    }
+};
+
+static ColouredAudioThumbnailBenchmark colouredAudioThumbnailBenchmark;
+
+//==============================================================================
+/** Compares drawing a full track's waveform strip through a Graphics context at
+    the old 3x oversampled resolution against the WaveformRenderer used by
+    AudioThumbnailImage.
+ */
+class WaveformRendererBenchmark  : public PerformanceBenchmark
+{
+public:
+    WaveformRendererBenchmark() : PerformanceBenchmark ("WaveformRenderer", "gui") {}
+
+    void runBenchmark() override
+    {
+        const double sampleRate = 44100.0;
+        const int numSamples = (int) (sampleRate * 60.0);
+        const int samplesPerThumbSample = 512;
+
+        MemoryBlock fileData;
+        GuiBenchmarkHelpers::createSyntheticFile (fileData, sampleRate, numSamples, 16);
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+        AudioThumbnailCache cache (1);
+
+        WavAudioFormat wavFormat;
+        ColouredAudioThumbnail thumbnail (samplesPerThumbSample, formatManager, cache);
+        thumbnail.setReader (wavFormat.createReaderFor (new MemoryInputStream (fileData, false), true), 1);
+
+        while (! thumbnail.isFullyLoaded())
+            Thread::yield();
+
+        const double length = numSamples / sampleRate;
+        const int width = numSamples / samplesPerThumbSample;
+        const int height = 100;
+        const int resolution = 3;
+
+        Image waveformImage (Image::RGB, width, height, true);
+        Image tempImage (Image::RGB, width * resolution, height, false);
+
+        measure ("Graphics drawChannel oversampled x" + String (resolution), numSamples, sampleRate, [&]
+        {
+            tempImage.clear (tempImage.getBounds(), Colours::black);
+
+            {
+                Graphics gTemp (tempImage);
+                gTemp.setColour (Colours::green);
+                thumbnail.drawChannel (gTemp, tempImage.getBounds(), 0.0, length, 0, 1.0f);
+            }
+
+            Graphics g (waveformImage);
+            g.drawImage (tempImage, 0, 0, width, height, 0, 0, tempImage.getWidth(), height);
+        });
+
+        WaveformRenderer renderer;
+
+        for (auto antialias : { true, false })
+        {
+            renderer.setAntialiasing (antialias);
+
+            measure (String ("WaveformRenderer direct bitmap") + (antialias ? " anti-aliased" : ""),
+                     numSamples, sampleRate, [&]
+            {
+                renderer.readColumns (thumbnail, 0, 0.0, length / width, width);
+
+                const Image::BitmapData destData (waveformImage, Image::BitmapData::writeOnly);
+                renderer.render (destData, 0, Colours::green, Colours::black);
+            });
+        }
+
+        cache.clear();
+    }
+};
+
+static WaveformRendererBenchmark waveformRendererBenchmark;
+
+//==============================================================================
+/** Renders a batch of one minute files to PNGs and reports the throughput. */
+class BatchImageRendererBenchmark  : public PerformanceBenchmark
+{
+public:
+    BatchImageRendererBenchmark() : PerformanceBenchmark ("BatchImageRenderer", "gui") {}
+
+    void runBenchmark() override
+    {
+        const double sampleRate = 44100.0;
+        const int numSamples = (int) (sampleRate * 60.0);
+        const int numFiles = 16;
+
+        MemoryBlock fileData;
+        GuiBenchmarkHelpers::createSyntheticFile (fileData, sampleRate, numSamples, 16);
+
+        const TemporaryFile tempDirectory;
+        const File sourceDirectory (tempDirectory.getFile().getChildFile ("source"));
+        const File outputDirectory (tempDirectory.getFile().getChildFile ("output"));
+        sourceDirectory.createDirectory();
+
+        Array<File> files;
+
+        for (int i = 0; i < numFiles; ++i)
+        {
+            const File file (sourceDirectory.getChildFile ("track" + String (i) + ".wav"));
+            file.replaceWithData (fileData.getData(), fileData.getSize());
+            files.add (file);
+        }
+
+        AudioFormatManager formatManager;
+        formatManager.registerBasicFormats();
+
+        BatchImageRenderer renderer (formatManager);
+        renderer.addImage (BatchImageRenderer::waveform, 1800, 140);
+        renderer.addImage (BatchImageRenderer::waveform, 600, 60);
+       #if DROWAUDIO_USE_FFTREAL
+        renderer.addImage (BatchImageRenderer::spectrogram, 1800, 256);
+       #endif
+
+        for (auto threads : { 1, SystemStats::getNumCpus() })
+        {
+            const String caseName (String (numFiles) + " files " + String (threads) + " threads");
+            BatchImageRenderer::Statistics stats;
+            renderer.setNumThreads (threads);
+
+            measure (caseName, (int64) numSamples * numFiles, sampleRate, [&]
+            {
+                stats = renderer.renderFiles (files, outputDirectory);
+            });
+
+            logValue (caseName, "filesPerSecond", stats.getFilesPerSecond());
+            logValue (caseName, "numFilesFailed", stats.numFilesFailed);
+        }
+
+        tempDirectory.getFile().deleteRecursively();
+    }
+};
+
+static BatchImageRendererBenchmark batchImageRendererBenchmark;
+
+#if DROWAUDIO_USE_FFTREAL
+//==============================================================================
+/** Streams an hour of audio into a Spectrograph at 4096 points and renders tiles
+    from the quantised storage.
+ */
+class SpectrographBenchmark  : public PerformanceBenchmark
+{
+public:
+    SpectrographBenchmark() : PerformanceBenchmark ("Spectrograph", "gui") {}
+
+    void runBenchmark() override
+    {
+        const double sampleRate = 44100.0;
+        const int blockSize = (int) sampleRate * 10;
+        const int64 numSamples = (int64) sampleRate * 3600;
+        const int fftSizeLog2 = 12;
+
+        AudioSampleBuffer block (1, blockSize);
+        Random random (0x1234);
+        float* data = block.getWritePointer (0);
+
+        for (int i = 0; i < blockSize; ++i)
+            data[i] = 0.4f * (float) std::sin (2.0 * MathConstants<double>::pi * 440.0 * i / sampleRate)
+                        + 0.1f * (random.nextFloat() * 2.0f - 1.0f);
+
+        for (auto bitsPerValue : { 8, 16 })
+        {
+            const String caseName ("streaming 1 hour " + String (bitsPerValue) + "-bit");
+            Spectrograph spectrograph (fftSizeLog2);
+            spectrograph.setStreamingMode (4096, bitsPerValue);
+            spectrograph.setLogFrequencyDisplay (true);
+
+            measure (caseName, numSamples, sampleRate, [&]
+            {
+                spectrograph.reset();
+
+                for (int64 done = 0; done < numSamples; done += blockSize)
+                    spectrograph.processSamples (data, (int) jmin ((int64) blockSize, numSamples - done));
+            });
+
+            // every frame kept as floats would need this much
+            const double floatBytes = (double) (numSamples >> fftSizeLog2) * (1 << (fftSizeLog2 - 1)) * sizeof (float);
+            logValue (caseName, "storageBytes", (double) spectrograph.getStorageSize());
+            logValue (caseName, "floatStorageBytes", floatBytes);
+
+            measure ("tile 1024x256 " + String (bitsPerValue) + "-bit", 1024 * 256, 0.0, [&]
+            {
+                spectrograph.createTile (Range<int64> (numSamples / 4, numSamples / 2), Range<float> (0.0f, 1.0f), 1024, 256);
+            });
+        }
+    }
+};
+
+static SpectrographBenchmark spectrographBenchmark;
+#endif // DROWAUDIO_USE_FFTREAL
+
+#endif // DROWAUDIO_BENCHMARKS
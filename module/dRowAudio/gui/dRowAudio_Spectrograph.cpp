@@ -31,13 +31,206 @@
 
 #if DROWAUDIO_USE_FFTREAL
 
+namespace SpectrographHelpers
+{
+    /** The range of levels kept by the streaming mode. */
+    static const float minDecibels = -120.0f;
+    static const float maxDecibels = 0.0f;
+
+    /** Converts a level to the grey level used by createImage(). */
+    inline uint8 decibelsToGrey (float decibels) noexcept
+    {
+        return (uint8) roundToInt (jlimit (0.0f, 1.0f, 1.0f + decibels / 100.0f) * 255.0f);
+    }
+
+    /** Converts a magnitude to decibels clipped to the range of the streaming mode. */
+    inline float magnitudeToDecibels (float magnitude) noexcept
+    {
+        return jlimit (minDecibels, maxDecibels, (float) toDecibels (magnitude));
+    }
+
+    /** Finds the largest quantised value of each bin over a number of columns. */
+    template <typename ValueType>
+    static void findColumnMaximums (const uint8* const* columns, int numColumns, int numBins, ValueType* maximums) noexcept
+    {
+        for (int c = 0; c < numColumns; ++c)
+        {
+            const ValueType* const values = reinterpret_cast<const ValueType*> (columns[c]);
+
+            for (int i = 0; i < numBins; ++i)
+                maximums[i] = jmax (maximums[i], values[i]);
+        }
+    }
+}
+
+//==============================================================================
+/*  Stores the magnitudes as log quantised columns in fixed size chunks.
+
+    Each column holds the maximum of framesPerColumn frames. When maxColumns has been
+    reached each pair of columns is merged in place and framesPerColumn doubles, so the
+    chunks never grow beyond maxColumns however long the input is.
+ */
+class Spectrograph::ColumnStore
+{
+public:
+    ColumnStore (int numBins_, int maxColumns_, int bitsPerValue)
+        : numBins (numBins_),
+          maxColumns (jmax (2, maxColumns_ + (maxColumns_ & 1))),
+          bytesPerValue (bitsPerValue > 8 ? 2 : 1),
+          maxValue (bitsPerValue > 8 ? 65535 : 255),
+          pending ((size_t) numBins_),
+          columnPointers ((size_t) maxColumns),
+          maximums ((size_t) numBins_ * 2)
+    {
+        jassert (bitsPerValue == 8 || bitsPerValue == 16);
+        reset();
+    }
+
+    enum { columnsPerChunk = 64 };
+
+    void reset()
+    {
+        chunks.clear();
+        numColumns = 0;
+        framesPerColumn = 1;
+        numPendingFrames = 0;
+    }
+
+    void addFrame (const float* magnitudes)
+    {
+        if (numPendingFrames == 0)
+            FloatVectorOperations::copy (pending, magnitudes, numBins);
+        else
+            FloatVectorOperations::max (pending, pending, magnitudes, numBins);
+
+        if (++numPendingFrames == framesPerColumn)
+        {
+            appendPendingColumn();
+            numPendingFrames = 0;
+        }
+    }
+
+    /** Returns the number of columns including a partially filled last one. */
+    int getNumColumns() const noexcept          { return numColumns + (numPendingFrames > 0 ? 1 : 0); }
+
+    int getFramesPerColumn() const noexcept     { return framesPerColumn; }
+
+    size_t getStorageSize() const noexcept
+    {
+        return (size_t) chunks.size() * columnsPerChunk * (size_t) (numBins * bytesPerValue)
+                + sizeof (float) * (size_t) numBins;
+    }
+
+    /** Finds the maximum level in decibels of each bin over a range of columns. */
+    void getDecibels (int firstColumn, int numColumnsToRead, float* decibels) const
+    {
+        using namespace SpectrographHelpers;
+
+        const int numStored = jlimit (0, jmax (0, numColumns - firstColumn), numColumnsToRead);
+        const bool includePending = numPendingFrames > 0 && firstColumn + numColumnsToRead > numColumns;
+
+        for (int c = 0; c < numStored; ++c)
+            columnPointers[c] = getColumn (firstColumn + c);
+
+        zeromem (maximums, (size_t) (numBins * bytesPerValue));
+
+        if (bytesPerValue == 1)
+            findColumnMaximums (columnPointers.getData(), numStored, numBins, reinterpret_cast<uint8*> (maximums.getData()));
+        else
+            findColumnMaximums (columnPointers.getData(), numStored, numBins, reinterpret_cast<uint16*> (maximums.getData()));
+
+        const float decibelsPerStep = (maxDecibels - minDecibels) / maxValue;
+
+        for (int i = 0; i < numBins; ++i)
+        {
+            const int value = bytesPerValue == 1 ? (int) reinterpret_cast<const uint8*> (maximums.getData())[i]
+                                                 : (int) reinterpret_cast<const uint16*> (maximums.getData())[i];
+            decibels[i] = numStored > 0 ? minDecibels + value * decibelsPerStep : minDecibels;
+
+            if (includePending)
+                decibels[i] = jmax (decibels[i], magnitudeToDecibels (pending[i]));
+        }
+    }
+
+private:
+    const int numBins, maxColumns, bytesPerValue, maxValue;
+    OwnedArray<HeapBlock<uint8>> chunks;
+    HeapBlock<float> pending;
+    mutable HeapBlock<const uint8*> columnPointers;
+    mutable HeapBlock<uint8> maximums;
+    int numColumns, framesPerColumn, numPendingFrames;
+
+    uint8* getColumn (int index) const noexcept
+    {
+        jassert (isPositiveAndBelow (index, chunks.size() * (int) columnsPerChunk));
+        return chunks.getUnchecked (index / columnsPerChunk)->getData()
+                + (index % columnsPerChunk) * numBins * bytesPerValue;
+    }
+
+    void appendPendingColumn()
+    {
+        using namespace SpectrographHelpers;
+
+        if (numColumns >= chunks.size() * columnsPerChunk)
+            chunks.add (new HeapBlock<uint8> ((size_t) (columnsPerChunk * numBins * bytesPerValue)));
+
+        uint8* const column = getColumn (numColumns++);
+        const float stepsPerDecibel = maxValue / (maxDecibels - minDecibels);
+
+        for (int i = 0; i < numBins; ++i)
+        {
+            const int value = roundToInt ((magnitudeToDecibels (pending[i]) - minDecibels) * stepsPerDecibel);
+
+            if (bytesPerValue == 1)
+                column[i] = (uint8) value;
+            else
+                reinterpret_cast<uint16*> (column)[i] = (uint16) value;
+        }
+
+        if (numColumns == maxColumns)
+            mergeColumnPairs();
+    }
+
+    void mergeColumnPairs()
+    {
+        const int numBytes = numBins * bytesPerValue;
+
+        // column i is only written after columns 2i and 2i + 1 have been read
+        for (int i = 0; i < numColumns / 2; ++i)
+        {
+            uint8* const dest = getColumn (i);
+            const uint8* const a = getColumn (2 * i);
+            const uint8* const b = getColumn (2 * i + 1);
+
+            if (bytesPerValue == 1)
+            {
+                for (int j = 0; j < numBytes; ++j)
+                    dest[j] = jmax (a[j], b[j]);
+            }
+            else
+            {
+                for (int j = 0; j < numBins; ++j)
+                    reinterpret_cast<uint16*> (dest)[j] = jmax (reinterpret_cast<const uint16*> (a)[j],
+                                                                reinterpret_cast<const uint16*> (b)[j]);
+            }
+        }
+
+        numColumns /= 2;
+        framesPerColumn *= 2;
+    }
+
+    JUCE_DECLARE_NON_COPYABLE (ColumnStore)
+};
+
+//==============================================================================
 Spectrograph::Spectrograph (int fftSizeLog2)
-    : fftEngine         (fftSizeLog2),
-      circularBuffer    (fftEngine.getFFTSize() + 1),
-      fftMagnitudesData (128),
-      tempBlock         (fftEngine.getFFTSize()),
-      logFrequency      (false),
-      binSize           (0.0f, 0.0f, 1.0f, 1.0f)
+    : fftEngine             (fftSizeLog2),
+      circularBuffer        (fftEngine.getFFTSize() + 1),
+      fftMagnitudesData     (128),
+      tempBlock             (fftEngine.getFFTSize()),
+      numSamplesProcessed   (0),
+      logFrequency          (false),
+      binSize               (0.0f, 0.0f, 1.0f, 1.0f)
 {
     fftEngine.setWindowType (Window::Hann);
     numBins = fftEngine.getFFTProperties().fftSizeHalved;
@@ -45,6 +238,10 @@ Spectrograph::Spectrograph (int fftSizeLog2)
     reset();
 }
 
+Spectrograph::~Spectrograph()
+{
+}
+
 //==============================================================================
 Image Spectrograph::generateImage (const float* samples, int numSamples)
 {
@@ -60,10 +257,18 @@ void Spectrograph::reset() noexcept
     circularBuffer.reset();
     fftMagnitudesData.reset();
     fftMagnitudesBlocks.clear();
+    numSamplesProcessed = 0;
+
+    if (columnStore != nullptr)
+        columnStore->reset();
 }
 
 void Spectrograph::ensureStorageAllocated (int numSamples)
 {
+    // the streaming mode has a fixed maximum size
+    if (columnStore != nullptr)
+        return;
+
     const int numBlocks = numSamples / fftEngine.getFFTSize();
     const int totalNumBins = numBlocks * numBins;
 
@@ -75,6 +280,7 @@ void Spectrograph::processSamples (const float* samples, int numSamples)
 {
     int numLeft = numSamples;
     const float* data = samples;
+    numSamplesProcessed += numSamples;
 
     while (numLeft > 0)
     {
@@ -99,7 +305,7 @@ void Spectrograph::processSamples (const float* samples, int numSamples)
 
 Image Spectrograph::createImage() const
 {
-    if (fftMagnitudesBlocks.size() == 0 || numBins == 0)
+    if (getNumColumns() == 0 || numBins == 0)
     {
         jassertfalse;
         return {};
@@ -107,6 +313,14 @@ Image Spectrograph::createImage() const
 
     const float bW = binSize.getWidth();
     const float bH = binSize.getHeight();
+
+    if (columnStore != nullptr)
+    {
+        const int64 numSamplesStored = getNumColumns() * (int64) getFramesPerColumn() * fftEngine.getFFTSize();
+
+        return createTile (Range<int64> (0, numSamplesStored), Range<float> (0.0f, 1.0f),
+                           (int) std::ceil (bW * getNumColumns()), (int) std::ceil (bH * numBins));
+    }
     const int w = (int) std::ceil (bW * fftMagnitudesBlocks.size());
     const int h = (int) std::ceil (bH * numBins);
 
@@ -158,6 +372,81 @@ Image Spectrograph::createImage() const
     return image;
 }
 
+//==============================================================================
+void Spectrograph::setStreamingMode (int maxColumns, int bitsPerValue)
+{
+    if (maxColumns > 0)
+        columnStore = std::make_unique<ColumnStore> (numBins, maxColumns, bitsPerValue);
+    else
+        columnStore = nullptr;
+
+    reset();
+}
+
+size_t Spectrograph::getStorageSize() const noexcept
+{
+    if (columnStore != nullptr)
+        return columnStore->getStorageSize();
+
+    return sizeof (float) * (size_t) fftMagnitudesData.getSize();
+}
+
+Image Spectrograph::createTile (Range<int64> sampleRange, Range<float> displayRange, int width, int height) const
+{
+    using namespace SpectrographHelpers;
+
+    const int numColumns = getNumColumns();
+
+    if (numColumns == 0 || width <= 0 || height <= 0 || sampleRange.isEmpty() || displayRange.isEmpty())
+        return {};
+
+    Image image (Image::RGB, width, height, false);
+    const Image::BitmapData destData (image, Image::BitmapData::writeOnly);
+
+    // the range of bins covered by each row, using the same log scale as createImage()
+    HeapBlock<int> rowStart ((size_t) height), rowEnd ((size_t) height);
+
+    for (int y = 0; y < height; ++y)
+    {
+        double bottom = displayRange.getStart() + displayRange.getLength() * (height - 1 - y) / (double) height;
+        double top = displayRange.getStart() + displayRange.getLength() * (height - y) / (double) height;
+
+        if (logFrequency)
+        {
+            bottom = (std::pow (40.0, bottom) - 1.0) / 39.0;
+            top = (std::pow (40.0, top) - 1.0) / 39.0;
+        }
+
+        rowStart[y] = jlimit (0, numBins - 1, (int) std::floor (bottom * numBins));
+        rowEnd[y] = jlimit (rowStart[y] + 1, numBins, (int) std::ceil (top * numBins));
+    }
+
+    const double samplesPerColumn = (double) fftEngine.getFFTSize() * getFramesPerColumn();
+    HeapBlock<float> decibels ((size_t) numBins);
+
+    for (int x = 0; x < width; ++x)
+    {
+        const int64 startSample = sampleRange.getStart() + (x * sampleRange.getLength()) / width;
+        const int64 endSample = sampleRange.getStart() + ((x + 1) * sampleRange.getLength()) / width;
+        const int firstColumn = (int) (startSample / samplesPerColumn);
+        const int endColumn = jmin (numColumns, jmax (firstColumn + 1, (int) std::ceil (endSample / samplesPerColumn)));
+        const bool hasData = startSample >= 0 && firstColumn < numColumns;
+
+        if (hasData)
+            getColumnDecibels (firstColumn, endColumn - firstColumn, decibels);
+
+        for (int y = 0; y < height; ++y)
+        {
+            const uint8 grey = hasData ? decibelsToGrey (FloatVectorOperations::findMaximum (decibels + rowStart[y], rowEnd[y] - rowStart[y]))
+                                       : 0;
+
+            reinterpret_cast<PixelRGB*> (destData.getPixelPointer (x, y))->setARGB (255, grey, grey, grey);
+        }
+    }
+
+    return image;
+}
+
 //==============================================================================
 void Spectrograph::setLogFrequencyDisplay (bool shouldDisplayLog)
 {
@@ -173,8 +462,21 @@ void Spectrograph::setBinSize (const Rectangle<float>& size) noexcept
 
 void Spectrograph::addMagnitudesBlock (const float* data, int size)
 {
+    if (columnStore != nullptr)
+    {
+        columnStore->addFrame (data);
+        return;
+    }
+
     if (fftMagnitudesData.getNumFree() < size)
-        fftMagnitudesData.setSizeKeepingExisting (fftMagnitudesData.getSize() - size);
+    {
+        // growing the storage moves it so the block pointers need to follow
+        const float* const oldData = fftMagnitudesData.getData();
+        fftMagnitudesData.setSizeKeepingExisting (jmax (fftMagnitudesData.getSize() * 2, fftMagnitudesData.getSize() + size + 1));
+
+        for (auto& block : fftMagnitudesBlocks)
+            block = fftMagnitudesData.getData() + (block - oldData);
+    }
 
     float* startOfData = fftMagnitudesData.getData() + fftMagnitudesData.getNumAvailable();
     fftMagnitudesBlocks.add (startOfData);
@@ -182,9 +484,197 @@ void Spectrograph::addMagnitudesBlock (const float* data, int size)
     fftMagnitudesData.writeSamples (data, size);
 }
 
+int Spectrograph::getNumColumns() const noexcept
+{
+    return columnStore != nullptr ? columnStore->getNumColumns() : fftMagnitudesBlocks.size();
+}
+
+int Spectrograph::getFramesPerColumn() const noexcept
+{
+    return columnStore != nullptr ? columnStore->getFramesPerColumn() : 1;
+}
+
+void Spectrograph::getColumnDecibels (int firstColumn, int numColumns, float* decibels) const
+{
+    using namespace SpectrographHelpers;
+
+    if (columnStore != nullptr)
+    {
+        columnStore->getDecibels (firstColumn, numColumns, decibels);
+        return;
+    }
+
+    FloatVectorOperations::copy (decibels, fftMagnitudesBlocks.getUnchecked (firstColumn), numBins);
+
+    for (int c = 1; c < numColumns; ++c)
+        FloatVectorOperations::max (decibels, decibels, fftMagnitudesBlocks.getUnchecked (firstColumn + c), numBins);
+
+    for (int i = 0; i < numBins; ++i)
+        decibels[i] = magnitudeToDecibels (decibels[i]);
+}
+
 void Spectrograph::renderScopeLine()
 {
 
 }
 
+//==============================================================================
+#if DROWAUDIO_UNIT_TESTS
+
+class SpectrographTests  : public UnitTest
+{
+public:
+    SpectrographTests() : UnitTest ("Spectrograph") {}
+
+    void runTest()
+    {
+        beginTest ("ColumnStore merged column count");
+        {
+            Spectrograph::ColumnStore store (numBins, 8, 8);
+            HeapBlock<float> frame ((size_t) numBins);
+
+            for (int i = 0; i < 7; ++i)
+                addFrame (store, frame, -100.0f + i);
+
+            expectEquals (store.getNumColumns(), 7);
+            expectEquals (store.getFramesPerColumn(), 1);
+
+            // reaching the maximum merges the pairs down to half
+            addFrame (store, frame, -93.0f);
+            expectEquals (store.getNumColumns(), 4);
+            expectEquals (store.getFramesPerColumn(), 2);
+
+            // a partially filled column is counted
+            addFrame (store, frame, -92.0f);
+            expectEquals (store.getNumColumns(), 5);
+
+            // each merged column holds the louder of its pair
+            HeapBlock<float> decibels ((size_t) numBins);
+
+            for (int c = 0; c < 4; ++c)
+            {
+                store.getDecibels (c, 1, decibels);
+                expectWithinAbsoluteError (decibels[0], -99.0f + 2 * c, getMaxError (8));
+            }
+
+            // an odd maximum is rounded up so pairs can always be merged
+            Spectrograph::ColumnStore oddStore (numBins, 5, 8);
+
+            for (int i = 0; i < 6; ++i)
+                addFrame (oddStore, frame, -60.0f);
+
+            expectEquals (oddStore.getNumColumns(), 3);
+            expectEquals (oddStore.getFramesPerColumn(), 2);
+        }
+
+        beginTest ("ColumnStore framesPerColumn doubling");
+        {
+            const int maxColumns = 8;
+            Spectrograph::ColumnStore store (numBins, maxColumns, 8);
+            HeapBlock<float> frame ((size_t) numBins);
+            const size_t storageSize = store.getStorageSize();
+
+            for (int numFrames = 1; numFrames <= 1000; ++numFrames)
+            {
+                addFrame (store, frame, -60.0f);
+
+                const int framesPerColumn = store.getFramesPerColumn();
+                expect (isPowerOfTwo (framesPerColumn));
+                expect (store.getNumColumns() <= maxColumns);
+                expectEquals (store.getNumColumns(), (numFrames + framesPerColumn - 1) / framesPerColumn);
+            }
+
+            expectEquals (store.getFramesPerColumn(), 128);
+            expect (store.getStorageSize() > storageSize);
+            expectEquals ((int) store.getStorageSize(),
+                          (int) (Spectrograph::ColumnStore::columnsPerChunk * numBins + sizeof (float) * numBins));
+        }
+
+        beginTest ("ColumnStore dB round trip");
+        {
+            checkRoundTrip (8);
+            checkRoundTrip (16);
+        }
+
+        beginTest ("Tiles match createImage()");
+        {
+            Spectrograph spectrograph (fftSizeLog2);
+            spectrograph.setStreamingMode (16);
+
+            const int fftSize = 1 << fftSizeLog2;
+            const int numSamples = fftSize * 40;
+            HeapBlock<float> samples ((size_t) numSamples);
+            Random random (0x1234);
+
+            for (int i = 0; i < numSamples; ++i)
+                samples[i] = 0.5f * std::sin (i * (0.01f + i * 0.00001f)) + 0.1f * (random.nextFloat() - 0.5f);
+
+            spectrograph.processSamples (samples, numSamples);
+
+            const Image image (spectrograph.createImage());
+            const int numColumns = spectrograph.getNumColumns();
+            const int bins = spectrograph.numBins;
+            expectEquals (image.getWidth(), numColumns);
+            expectEquals (image.getHeight(), bins);
+
+            // the upper half of the frequency range over the middle columns
+            const int firstColumn = 3, lastColumn = 9;
+            const int64 samplesPerColumn = (int64) fftSize * spectrograph.getFramesPerColumn();
+            const Image tile (spectrograph.createTile (Range<int64> (firstColumn * samplesPerColumn, lastColumn * samplesPerColumn),
+                                                      Range<float> (0.5f, 1.0f), lastColumn - firstColumn, bins / 2));
+
+            bool allMatch = true;
+
+            for (int y = 0; y < tile.getHeight(); ++y)
+                for (int x = 0; x < tile.getWidth(); ++x)
+                    allMatch = allMatch && tile.getPixelAt (x, y) == image.getPixelAt (firstColumn + x, y);
+
+            expect (allMatch);
+        }
+    }
+
+private:
+    enum { numBins = 16, fftSizeLog2 = 7 };
+
+    /** Returns half a quantisation step of the -120 to 0dB range. */
+    static float getMaxError (int bitsPerValue) noexcept
+    {
+        return 120.0f / ((1 << bitsPerValue) - 1) / 2.0f + 0.0001f;
+    }
+
+    static void addFrame (Spectrograph::ColumnStore& store, float* frame, float decibels)
+    {
+        FloatVectorOperations::fill (frame, (float) decibelsToAbsolute (decibels), numBins);
+        store.addFrame (frame);
+    }
+
+    void checkRoundTrip (int bitsPerValue)
+    {
+        const int numLevels = 241;
+        const float maxError = getMaxError (bitsPerValue);
+        Spectrograph::ColumnStore store (numBins, 256, bitsPerValue);
+        HeapBlock<float> frame ((size_t) numBins), decibels ((size_t) numBins);
+
+        for (int i = 0; i < numLevels; ++i)
+            addFrame (store, frame, -120.0f + i * 0.5f);
+
+        expectEquals (store.getFramesPerColumn(), 1);
+
+        for (int i = 0; i < numLevels; ++i)
+        {
+            store.getDecibels (i, 1, decibels);
+            expectWithinAbsoluteError (decibels[numBins - 1], -120.0f + i * 0.5f, maxError);
+        }
+
+        // levels outside the range are clipped to it
+        addFrame (store, frame, 12.0f);
+        store.getDecibels (numLevels, 1, decibels);
+        expectWithinAbsoluteError (decibels[0], 0.0f, maxError);
+    }
+};
+
+static SpectrographTests spectrographTests;
+
+#endif // DROWAUDIO_UNIT_TESTS
+
 #endif // JUCE_MAC || JUCE_IOS || DROWAUDIO_USE_FFTREAL
@@ -34,7 +34,15 @@
 
 #if DROWAUDIO_USE_FFTREAL || defined (DOXYGEN)
 
-/** Creates a standard right-left greyscale Spectrograph. */
+/** Creates a standard right-left greyscale Spectrograph.
+
+    By default every FFT frame is kept as floats which is fine for short buffers
+    but for long inputs use setStreamingMode(). This keeps the magnitudes as log
+    quantised 8 or 16-bit values in fixed size chunks of columns, halving the time
+    resolution whenever the maximum number of columns is reached so that memory
+    depends on the output resolution rather than the length of the input. Sections
+    of the graph can then be rendered with createTile().
+ */
 class Spectrograph
 {
 public:
@@ -45,6 +53,9 @@ public:
      */
     Spectrograph (int fftSizeLog2);
 
+    /** Destructor. */
+    ~Spectrograph();
+
     //==============================================================================
     /** Creates a Spetrograph based on the whole set of samples provided.
 
@@ -77,6 +88,40 @@ public:
     */
     Image createImage() const;
 
+    //==============================================================================
+    /** Switches to storing the magnitudes as quantised columns.
+
+        At most maxColumns columns will be stored, each one holding the maximum of one
+        or more FFT frames. Once this is reached neighbouring columns are merged so
+        each covers twice as many frames. bitsPerValue can be 8 or 16, the values are
+        stored on a decibel scale from -120 to 0dB.
+
+        Pass 0 as maxColumns to go back to keeping every frame as floats.
+        This will reset the Spectrograph.
+    */
+    void setStreamingMode (int maxColumns, int bitsPerValue = 8);
+
+    /** Returns true if the streaming mode is being used. */
+    bool isStreaming() const noexcept                   { return columnStore != nullptr; }
+
+    /** Returns the number of samples that have been added to the graph. */
+    int64 getNumSamplesProcessed() const noexcept       { return numSamplesProcessed; }
+
+    /** Returns the number of bytes being used to store the magnitudes. */
+    size_t getStorageSize() const noexcept;
+
+    /** Renders a section of the graph into an image of a given size.
+
+        sampleRange is the range of input samples to show along the x axis and
+        displayRange is the proportion of the frequency axis to show from the bottom,
+        0 to 1. If the log frequency display is used this is a proportion of the log
+        scale so tiles always line up with the image createImage() would return.
+
+        Only the stored columns covering the tile are read so this works in either
+        mode, but is intended for use with the streaming mode.
+    */
+    Image createTile (Range<int64> sampleRange, Range<float> displayRange, int width, int height) const;
+
     //==============================================================================
     /** Sets the scope to display in log or normal mode. */
     void setLogFrequencyDisplay (bool shouldDisplayLog);
@@ -95,16 +140,24 @@ public:
 
 private:
     //==============================================================================
+    class ColumnStore;
+    friend class SpectrographTests;
+
     FFTEngine fftEngine;
     int numBins;
     FifoBuffer<float> circularBuffer, fftMagnitudesData;
     HeapBlock<float> tempBlock;
     Array<float*> fftMagnitudesBlocks;
+    std::unique_ptr<ColumnStore> columnStore;
+    int64 numSamplesProcessed;
     bool logFrequency;
     Rectangle<float> binSize;
 
     //==============================================================================
     void addMagnitudesBlock (const float* data, int size);
+    int getNumColumns() const noexcept;
+    int getFramesPerColumn() const noexcept;
+    void getColumnDecibels (int firstColumn, int numColumns, float* decibels) const;
     void renderScopeLine();
 
     //==============================================================================
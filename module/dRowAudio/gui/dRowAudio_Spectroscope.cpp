@@ -36,7 +36,9 @@ Spectroscope::Spectroscope (int fftSizeLog2)
     needsRepaint    (true),
     tempBlock       (fftEngine.getFFTSize()),
     circularBuffer  (int (fftEngine.getMagnitudesBuffer().getSize() * 4)),
-    logFrequency    (false)
+    logFrequency    (false),
+    numColumnsMapped (0),
+    columnsMappedLog (false)
 {
     setColour (lineColourId, Colours::white);
     setColour (backgroundColourId, Colours::transparentBlack);
@@ -84,8 +86,7 @@ void Spectroscope::timerCallback()
     renderScopeImage();
 
     // fall levels here
-    for (int i = 0; i < magnitudeBufferSize; ++i)
-        magnitudeBuffer[i] *= 0.707f;
+    FloatVectorOperations::multiply (magnitudeBuffer, 0.707f, magnitudeBufferSize);
 }
 
 void Spectroscope::process()
@@ -109,12 +110,41 @@ void Spectroscope::flagForRepaint()
 }
 
 //==============================================================================
+float Spectroscope::getBinX (int binIndex, int numBinsX, int width) const noexcept
+{
+    if (logFrequency)
+        return log10 (1 + 39 * ((binIndex + 1.0f) / numBinsX)) / log10 (40.0f) * width;
+
+    return (binIndex + 1) * ((float) width / (numBinsX + 1));
+}
+
+void Spectroscope::updateColumnMap (int width, int numBinsX)
+{
+    // each column c draws the bins from columnStartBins[c] up to columnStartBins[c + 1]
+    columnStartBins.malloc ((size_t) width + 1);
+
+    int bin = 0;
+
+    for (int c = 0; c < width; ++c)
+    {
+        columnStartBins[c] = bin;
+
+        while (bin < numBinsX && getBinX (bin, numBinsX, width) < c + 1)
+            ++bin;
+    }
+
+    columnStartBins[width] = numBinsX;
+
+    numColumnsMapped = width;
+    columnsMappedLog = logFrequency;
+}
+
 void Spectroscope::renderScopeImage()
 {
     if (needsRepaint)
     {
         scopeImage.clear (scopeImage.getBounds(), Colours::transparentBlack);
-        
+
         Graphics g (scopeImage);
 
         const int w = getWidth();
@@ -123,41 +153,32 @@ void Spectroscope::renderScopeImage()
         g.setColour (findColour (traceColourId));
 
         const int numBinsX = int (fftEngine.getMagnitudesBuffer().getSize() - 1);
-        const float xScale = (float)w / (numBinsX + 1);
         const float* data = fftEngine.getMagnitudesBuffer().getData();
 
-        float y2, y1 = jlimit (0.0f, 1.0f, float (1 + (toDecibels (data[0]) / 100.0f)));
-        float x2, x1 = 0;
-
-        if (logFrequency)
-        {
-            for (int i = 0; i < numBinsX; ++i)
-            {
-                y2 = jlimit (0.0f, 1.0f, float (1 + (toDecibels (data[i]) / 100.0f)));
-                x2 = log10 (1 + 39 * ((i + 1.0f) / numBinsX)) / log10 (40.0f) * w;
+        if (w != numColumnsMapped || logFrequency != columnsMappedLog)
+            updateColumnMap (w, numBinsX);
 
-                g.drawLine (x1, h - h * y1,
-                            x2, h - h * y2);
+        // reduce the bins to the loudest in each pixel column so the cost of drawing
+        // only depends on the width, columns that have no bins are joined across
+        Path path;
+        path.startNewSubPath (0.0f, h - h * jlimit (0.0f, 1.0f, float (1 + (toDecibels (data[0]) / 100.0f))));
 
-                y1 = y2;
-                x1 = x2;
-            }
-        }
-        else
+        for (int c = 0; c < w; ++c)
         {
-            for (int i = 0; i < numBinsX; ++i)
-            {
-                y2 = jlimit (0.0f, 1.0f, float (1 + (toDecibels (data[i]) / 100.0f)));
-                x2 = (i + 1) * xScale;
+            const int startBin = columnStartBins[c];
+            const int numBinsInColumn = columnStartBins[c + 1] - startBin;
 
-                g.drawLine (x1, h - h * y1,
-                            x2, h - h * y2);
+            if (numBinsInColumn > 0)
+            {
+                const float level = FloatVectorOperations::findMaximum (data + startBin, numBinsInColumn);
+                const float y = jlimit (0.0f, 1.0f, float (1 + (toDecibels (level) / 100.0f)));
 
-                y1 = y2;
-                x1 = x2;
+                path.lineTo (c + 0.5f, h - h * y);
             }
         }
 
+        g.strokePath (path, PathStrokeType (1.0f));
+
         needsRepaint = false;
 
         repaint();
@@ -101,6 +101,12 @@ private:
     bool logFrequency;
     Image scopeImage;
 
+    HeapBlock<int> columnStartBins;
+    int numColumnsMapped;
+    bool columnsMappedLog;
+
+    float getBinX (int binIndex, int numBinsX, int width) const noexcept;
+    void updateColumnMap (int width, int numBinsX);
     void renderScopeImage();
 
     //==============================================================================
@@ -176,6 +176,160 @@ public:
 
 static PitchTests pitchTests;
 
+//==============================================================================
+class XmlIndexTests  : public UnitTest
+{
+public:
+    XmlIndexTests() : UnitTest ("XmlIndex") {}
+
+    void runTest()
+    {
+        beginTest ("Lookups");
+        {
+            std::unique_ptr<XmlElement> library (XmlDocument::parse ("<LIBRARY>"
+                                                                       "<TRACK TrackID=\"1\" Name=\"One\" Kind=\"MP3\">Hello</TRACK>"
+                                                                       "<TRACK TrackID=\"2\" Name=\"Two\">He<B>llo</B></TRACK>"
+                                                                       "<PLAYLIST Name=\"List\"><TRACK TrackID=\"1\"/></PLAYLIST>"
+                                                                     "</LIBRARY>"));
+            expect (library != nullptr);
+
+            XmlElement* const track1 = library->getChildElement (0);
+            XmlElement* const track2 = library->getChildElement (1);
+            XmlElement* const playlist = library->getChildElement (2);
+            XmlElement* const playlistTrack = playlist->getChildElement (0);
+
+            XmlIndex index (library.get());
+            expectEquals (index.getNumElements(), 6);
+
+            const Array<XmlElement*>& tracks = index.getElementsWithTagName ("TRACK");
+            expectEquals (tracks.size(), 3);
+            expect (tracks[0] == track1 && tracks[1] == track2 && tracks[2] == playlistTrack);
+            expect (index.getElementsWithTagName ("FOLDER").isEmpty());
+
+            const Array<XmlElement*>& named = index.getElementsWithAttribute ("Name");
+            expectEquals (named.size(), 3);
+            expect (named[0] == track1 && named[1] == track2 && named[2] == playlist);
+            expect (index.findElementWithAttribute ("Kind") == track1);
+            expect (index.findElementWithAttribute ("Genre") == nullptr);
+
+            // values are compared ignoring case but names aren't
+            expect (index.findElementWithAttributeWithValue ("Name", "tWO") == track2);
+            expect (index.findElementWithAttributeWithValue ("name", "Two") == nullptr);
+            expect (index.findElementWithAttributeWithValue ("Name", "Three") == nullptr);
+
+            const Array<XmlElement*>& firstTracks = index.getElementsWithAttributeValue ("TrackID", "1");
+            expectEquals (firstTracks.size(), 2);
+            expect (firstTracks[0] == track1 && firstTracks[1] == playlistTrack);
+
+            // text split over several children hashes the same as a single text element
+            const Array<XmlElement*> hellos (index.getElementsWithSubText ("Hello"));
+            expectEquals (hellos.size(), 2);
+            expect (hellos[0] == track1 && hellos[1] == track2);
+            expect (index.findElementWithSubText ("llo") == track2->getChildByName ("B"));
+            expect (index.findElementWithSubText ("HelloHello") == library.get());
+            expect (index.findElementWithSubText ("") == playlist);
+            expect (index.findElementWithSubText ("olleH") == nullptr);
+
+            index.clear();
+            expectEquals (index.getNumElements(), 0);
+            expect (index.findElementWithAttribute ("Kind") == nullptr);
+            expect (index.findElementWithSubText ("Hello") == nullptr);
+
+            index.build (playlist);
+            expectEquals (index.getNumElements(), 2);
+            expect (index.findElementWithAttributeWithValue ("TrackID", "1") == playlistTrack);
+        }
+
+        beginTest ("Rolling subtext hash");
+        {
+            Random random (0x2f6e);
+
+            for (int i = 0; i < 20; ++i)
+            {
+                XmlElement root ("ROOT");
+                addRandomChildren (random, root, 4);
+
+                Array<XmlElement*> elements;
+                addElementsInDocumentOrder (&root, elements);
+
+                XmlIndex index (&root);
+                expectEquals (index.getNumElements(), elements.size());
+
+                bool allFound = true;
+
+                for (int e = 0; e < elements.size(); ++e)
+                {
+                    const String subtext (elements.getUnchecked (e)->getAllSubText());
+                    Array<XmlElement*> expected;
+
+                    for (int j = 0; j < elements.size(); ++j)
+                        if (elements.getUnchecked (j)->getAllSubText() == subtext)
+                            expected.add (elements.getUnchecked (j));
+
+                    allFound = allFound && index.getElementsWithSubText (subtext) == expected
+                                        && index.findElementWithSubText (subtext) == expected.getFirst();
+                }
+
+                expect (allFound);
+
+                for (int tag = 0; tag < numTags; ++tag)
+                {
+                    Array<XmlElement*> expected;
+
+                    for (int j = 0; j < elements.size(); ++j)
+                        if (elements.getUnchecked (j)->hasTagName (getTagName (tag)))
+                            expected.add (elements.getUnchecked (j));
+
+                    expect (index.getElementsWithTagName (getTagName (tag)) == expected);
+                }
+            }
+        }
+    }
+
+private:
+    enum { numTags = 3 };
+
+    static String getTagName (int tag)
+    {
+        return "E" + String (tag);
+    }
+
+    /** Adds text and elements with short overlapping pieces of text so the same
+        subtext turns up split over children in different ways.
+    */
+    static void addRandomChildren (Random& random, XmlElement& parent, int depth)
+    {
+        static const char* const pieces[] = { "a", "b", "ab", "ba", "\xc3\xa9", "\xf0\x9d\x84\x9e" };
+        const int numChildren = random.nextInt (4);
+
+        for (int i = 0; i < numChildren; ++i)
+        {
+            if (depth == 0 || random.nextBool())
+            {
+                parent.addChildElement (XmlElement::createTextElement (String::fromUTF8 (pieces[random.nextInt (numElementsInArray (pieces))])));
+            }
+            else
+            {
+                XmlElement* const child = parent.createNewChildElement (getTagName (random.nextInt ((int) numTags)));
+                addRandomChildren (random, *child, depth - 1);
+            }
+        }
+    }
+
+    static void addElementsInDocumentOrder (XmlElement* element, Array<XmlElement*>& elements)
+    {
+        if (element->isTextElement())
+            return;
+
+        elements.add (element);
+
+        for (XmlElement* child = element->getFirstChildElement(); child != nullptr; child = child->getNextElement())
+            addElementsInDocumentOrder (child, elements);
+    }
+};
+
+static XmlIndexTests xmlIndexTests;
+
 //==============================================================================
 
 #endif // DROWAUDIO_UNIT_TESTS
@@ -343,6 +343,16 @@ inline FloatingPointType melScale (const FloatingPointType frequencyInHerts) noe
     return 2595 * std::log10 (1 + (frequencyInHerts / 700.0));
 }
 
+/** Converts a value on the Mel scale back to a frequency in hertz.
+
+    This is the inverse of melScale.
+*/
+template<typename FloatingPointType>
+inline FloatingPointType melScaleToFrequency (const FloatingPointType mel) noexcept
+{
+    return (FloatingPointType) (700.0 * (std::pow (10.0, mel / 2595.0) - 1.0));
+}
+
 //==============================================================================
 /** Checks to see if a number is NaN eg. sqrt (-1). */
 template<typename Type>
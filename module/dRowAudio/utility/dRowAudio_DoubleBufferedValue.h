@@ -0,0 +1,164 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_DOUBLEBUFFEREDVALUE_H
+#define DROWAUDIO_DOUBLEBUFFEREDVALUE_H
+
+//==============================================================================
+/** Passes a value, e.g. a set of filter coefficients, from a control thread to
+    the audio thread without either of them taking a lock.
+
+    There are two copies of the value. The audio thread only ever reads the
+    active one and the writer only ever fills in the other, then marks it as
+    pending. At the start of each block the audio thread calls update() which
+    makes a pending value active with a single compare-and-swap, so the value
+    only ever changes between blocks and is never seen half written.
+
+    update() and get() never wait. If a write is in progress update() just keeps
+    the current value for this block and picks up the new one at the next.
+
+    set() and getLatest() can be called from several threads but each takes a write
+    flag and spins until any other set() or getLatest() has finished with it. So the
+    audio thread should only call them if it is the only thread that does, e.g.
+    when it sets up filters from values it has just picked up with update().
+
+    The Type must be trivially copyable, e.g. a struct of floats.
+
+    @see BiquadFilter, OnePoleFilter, LoopingAudioSource
+ */
+template <typename Type>
+class DoubleBufferedValue
+{
+public:
+    //==============================================================================
+    /** Creates the two copies with an initial value. */
+    explicit DoubleBufferedValue (const Type& initialValue = Type()) noexcept
+        : state (0), readIndex (0)
+    {
+        static_assert (std::is_trivially_copyable<Type>::value,
+                       "DoubleBufferedValue copies its values with plain assignment");
+
+        values[0] = values[1] = initialValue;
+    }
+
+    //==============================================================================
+    /** Publishes a new value.
+        The audio thread will start using it at its next call to update(). This
+        spins whilst another thread is in set() or getLatest().
+     */
+    void set (const Type& newValue) noexcept
+    {
+        // the reader can't swap while the write flag is set so the inactive copy is ours
+        const int activeIndex = claimWriteFlag() & activeIndexMask;
+        values[1 - activeIndex] = newValue;
+
+        state.store (activeIndex | pendingFlag, std::memory_order_release);
+    }
+
+    /** Returns the most recently published value.
+        This is for the control side, e.g. for a getter. It spins whilst another
+        thread is in set() or getLatest(), the audio thread should use get().
+     */
+    Type getLatest() const noexcept
+    {
+        const int current = claimWriteFlag();
+        const int activeIndex = current & activeIndexMask;
+        const Type value (values[(current & pendingFlag) != 0 ? 1 - activeIndex : activeIndex]);
+
+        state.store (current, std::memory_order_release);
+        return value;
+    }
+
+    //==============================================================================
+    /** Makes any pending value the active one.
+
+        Call this from the audio thread at the start of each block. Returns true if a
+        new value was swapped in.
+     */
+    bool update() noexcept
+    {
+        int current = state.load (std::memory_order_acquire);
+
+        if ((current & pendingFlag) == 0 || (current & writingFlag) != 0)
+            return false;
+
+        const int newIndex = 1 - (current & activeIndexMask);
+
+        if (! state.compare_exchange_strong (current, newIndex, std::memory_order_acq_rel))
+            return false;
+
+        readIndex = newIndex;
+        return true;
+    }
+
+    /** Returns the active value.
+        This should only be used by the audio thread, the one calling update().
+     */
+    const Type& get() const noexcept        { return values[readIndex]; }
+
+private:
+    //==============================================================================
+    enum
+    {
+        activeIndexMask = 1,
+        pendingFlag     = 2,
+        writingFlag     = 4
+    };
+
+    Type values[2];
+    mutable std::atomic<int> state;
+    int readIndex;
+
+    /** Sets the write flag, waiting for any other writer to finish first.
+        Returns the state before the flag was set.
+     */
+    int claimWriteFlag() const noexcept
+    {
+        int current = state.load (std::memory_order_relaxed);
+
+        for (;;)
+        {
+            if ((current & writingFlag) != 0)
+            {
+                current = state.load (std::memory_order_relaxed);
+                continue;
+            }
+
+            if (state.compare_exchange_weak (current, current | writingFlag, std::memory_order_acquire))
+                return current;
+        }
+    }
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE (DoubleBufferedValue)
+};
+
+#endif   // DROWAUDIO_DOUBLEBUFFEREDVALUE_H
@@ -49,8 +49,15 @@ ITunesLibraryParser::~ITunesLibraryParser()
 
 void ITunesLibraryParser::run()
 {
+    DROWAUDIO_TRACE_THREAD();
+    DROWAUDIO_TRACE_SCOPE ("ITunesLibraryParser::run")
+
     // parse the iTunes xml first
-    iTunesDatabase = XmlDocument::parse (iTunesLibraryFile);
+    {
+        DROWAUDIO_TRACE_SCOPE ("ITunesLibraryParser parse XML")
+        iTunesDatabase = XmlDocument::parse (iTunesLibraryFile);
+    }
+
     if (! iTunesDatabase->hasTagName ("plist")
         || iTunesDatabase->getStringAttribute ("version") != "1.0")
     {
@@ -213,6 +220,9 @@ void ITunesLibraryParser::run()
                 treeToFill.addChild (newElement, -1, nullptr);
             }
 
+            if (numAdded % 100 == 0)
+                DROWAUDIO_TRACE_COUNTER ("iTunes tracks added", numAdded);
+
             currentElement = currentElement->getNextElement(); // move to next track
         }
     }
@@ -0,0 +1,213 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#if DROWAUDIO_BENCHMARKS
+
+//==============================================================================
+PerformanceBenchmark::PerformanceBenchmark (const String& name_, const String& category_)
+    : name      (name_),
+      category  (category_),
+      runner    (nullptr)
+{
+    getAllBenchmarks().add (this);
+}
+
+PerformanceBenchmark::~PerformanceBenchmark()
+{
+    getAllBenchmarks().removeFirstMatchingValue (this);
+}
+
+Array<PerformanceBenchmark*>& PerformanceBenchmark::getAllBenchmarks()
+{
+    static Array<PerformanceBenchmark*> benchmarks;
+    return benchmarks;
+}
+
+void PerformanceBenchmark::measure (const String& caseName, int64 numSamplesPerCall, double sampleRate,
+                                    const std::function<void()>& functionToTime)
+{
+    jassert (runner != nullptr); // benchmarks must be run from a PerformanceBenchmarkRunner
+
+    if (runner != nullptr)
+        runner->addResult (caseName, numSamplesPerCall, sampleRate, functionToTime);
+}
+
+void PerformanceBenchmark::logValue (const String& caseName, const String& valueName, double value)
+{
+    jassert (runner != nullptr); // benchmarks must be run from a PerformanceBenchmarkRunner
+
+    if (runner != nullptr)
+        runner->addValue (caseName, valueName, value);
+}
+
+//==============================================================================
+PerformanceBenchmarkRunner::PerformanceBenchmarkRunner()
+    : minTimePerCase    (0.25),
+      currentBenchmark  (nullptr)
+{
+}
+
+PerformanceBenchmarkRunner::~PerformanceBenchmarkRunner()
+{
+}
+
+void PerformanceBenchmarkRunner::runAllBenchmarks (const String& categoryToRun)
+{
+    Array<PerformanceBenchmark*> benchmarksToRun;
+
+    for (auto* benchmark : PerformanceBenchmark::getAllBenchmarks())
+        if (categoryToRun.isEmpty() || benchmark->getCategory() == categoryToRun)
+            benchmarksToRun.add (benchmark);
+
+    runBenchmarks (benchmarksToRun);
+}
+
+void PerformanceBenchmarkRunner::runBenchmarks (const Array<PerformanceBenchmark*>& benchmarks)
+{
+    results.clearQuick();
+
+    for (auto* benchmark : benchmarks)
+    {
+        currentBenchmark = benchmark;
+        benchmark->runner = this;
+
+        logMessage ("Running: " + benchmark->getName());
+        benchmark->runBenchmark();
+
+        benchmark->runner = nullptr;
+        currentBenchmark = nullptr;
+    }
+}
+
+String PerformanceBenchmarkRunner::toJSON() const
+{
+    Array<var> resultsArray;
+
+    for (const auto& result : results)
+    {
+        DynamicObject::Ptr object (new DynamicObject());
+        object->setProperty ("benchmark", result.benchmarkName);
+        object->setProperty ("case", result.caseName);
+        object->setProperty ("calls", result.numCalls);
+        object->setProperty ("samples", result.numSamples);
+        object->setProperty ("seconds", result.totalSeconds);
+        object->setProperty ("ns_per_sample", result.nanosecondsPerSample);
+
+        if (result.realTimeFactor > 0.0)
+            object->setProperty ("realtime_factor", result.realTimeFactor);
+
+        for (const auto& value : result.values)
+            object->setProperty (value.name, value.value);
+
+        resultsArray.add (var (object.get()));
+    }
+
+    DynamicObject::Ptr root (new DynamicObject());
+    root->setProperty ("module", "dRowAudio");
+    root->setProperty ("platform", SystemStats::getOperatingSystemName());
+    root->setProperty ("cpu", SystemStats::getCpuModel());
+    root->setProperty ("results", resultsArray);
+
+    return JSON::toString (var (root.get()));
+}
+
+void PerformanceBenchmarkRunner::logMessage (const String& message)
+{
+    Logger::writeToLog (message);
+}
+
+//==============================================================================
+void PerformanceBenchmarkRunner::addResult (const String& caseName, int64 numSamplesPerCall, double sampleRate,
+                                            const std::function<void()>& functionToTime)
+{
+    jassert (currentBenchmark != nullptr);
+
+    // warm up caches and any lazily allocated state before timing
+    functionToTime();
+
+    const int64 minTicks = Time::secondsToHighResolutionTicks (minTimePerCase);
+    const int64 startTicks = Time::getHighResolutionTicks();
+    int64 elapsedTicks = 0;
+    int64 numCalls = 0;
+
+    do
+    {
+        functionToTime();
+        ++numCalls;
+        elapsedTicks = Time::getHighResolutionTicks() - startTicks;
+    }
+    while (elapsedTicks < minTicks);
+
+    Result result;
+    result.benchmarkName = currentBenchmark->getName();
+    result.caseName = caseName;
+    result.numCalls = numCalls;
+    result.numSamples = numCalls * numSamplesPerCall;
+    result.totalSeconds = Time::highResolutionTicksToSeconds (elapsedTicks);
+    result.nanosecondsPerSample = result.numSamples > 0 ? (result.totalSeconds * 1.0e9) / result.numSamples : 0.0;
+    result.realTimeFactor = (sampleRate > 0.0 && result.totalSeconds > 0.0) ? (result.numSamples / sampleRate) / result.totalSeconds
+                                                                             : 0.0;
+    results.add (result);
+
+    String message;
+    message << "    " << caseName << ": " << String (result.nanosecondsPerSample, 3) << " ns/sample";
+
+    if (result.realTimeFactor > 0.0)
+        message << ", " << String (result.realTimeFactor, 1) << "x real-time";
+
+    logMessage (message);
+}
+
+void PerformanceBenchmarkRunner::addValue (const String& caseName, const String& valueName, double value)
+{
+    jassert (currentBenchmark != nullptr);
+
+    for (auto& result : results)
+    {
+        if (result.benchmarkName == currentBenchmark->getName() && result.caseName == caseName)
+        {
+            result.values.set (valueName, value);
+            return;
+        }
+    }
+
+    Result result;
+    result.benchmarkName = currentBenchmark->getName();
+    result.caseName = caseName;
+    result.numCalls = result.numSamples = 0;
+    result.totalSeconds = result.nanosecondsPerSample = result.realTimeFactor = 0.0;
+    result.values.set (valueName, value);
+    results.add (result);
+
+    logMessage ("    " + caseName + ": " + valueName + " = " + String (value, 4));
+}
+
+#endif // DROWAUDIO_BENCHMARKS
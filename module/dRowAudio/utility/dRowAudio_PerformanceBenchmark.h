@@ -0,0 +1,183 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_PERFORMANCEBENCHMARK_H
+#define DROWAUDIO_PERFORMANCEBENCHMARK_H
+
+#if DROWAUDIO_BENCHMARKS || DOXYGEN
+
+class PerformanceBenchmarkRunner;
+
+//==============================================================================
+/** Base class for a self-registering performance benchmark.
+
+    This works in a similar way to UnitTest. Create a subclass, implement
+    runBenchmark() and declare a static instance of it in a cpp file. Inside
+    runBenchmark() call measure() once for each case you want timed. The runner
+    will repeat each case until a minimum amount of time has elapsed and then
+    record the cost per sample and the real-time factor.
+
+    @see PerformanceBenchmarkRunner
+ */
+class PerformanceBenchmark
+{
+public:
+    //==============================================================================
+    /** Destructor. */
+    virtual ~PerformanceBenchmark();
+
+    /** Returns the name of the benchmark. */
+    const String& getName() const noexcept          { return name; }
+
+    /** Returns the category of the benchmark e.g. "audio" or "gui". */
+    const String& getCategory() const noexcept      { return category; }
+
+    /** Implement this to call measure() for each of your cases. */
+    virtual void runBenchmark() = 0;
+
+    /** Returns all the benchmarks that have been registered. */
+    static Array<PerformanceBenchmark*>& getAllBenchmarks();
+
+protected:
+    //==============================================================================
+    /** Creates a benchmark with a given name and category. */
+    PerformanceBenchmark (const String& name, const String& category);
+
+    /** Times a processing function.
+
+        The function will be called once to warm up and then repeatedly until the
+        runner's minimum time per case has elapsed.
+
+        @param caseName             a name for this case, unique within the benchmark
+        @param numSamplesPerCall    the number of audio samples (or items) processed
+                                    by each call of the function
+        @param sampleRate           the sample rate the samples represent. This is used
+                                    to calculate the real-time factor, pass 0 if the
+                                    case isn't audio rate.
+        @param functionToTime       the work to measure
+     */
+    void measure (const String& caseName, int64 numSamplesPerCall, double sampleRate,
+                  const std::function<void()>& functionToTime);
+
+    /** Records a value that has been measured by the benchmark itself.
+
+        This can be used for quality figures such as aliasing rejection or error
+        against a reference which should be tracked alongside the timings.
+     */
+    void logValue (const String& caseName, const String& valueName, double value);
+
+private:
+    //==============================================================================
+    friend class PerformanceBenchmarkRunner;
+
+    const String name, category;
+    PerformanceBenchmarkRunner* runner;
+
+    JUCE_DECLARE_NON_COPYABLE (PerformanceBenchmark)
+};
+
+//==============================================================================
+/** Runs a set of PerformanceBenchmarks and collects the results.
+
+    The results can be retrieved as JSON so that they can be stored and diffed
+    between builds.
+
+    @code
+        PerformanceBenchmarkRunner runner;
+        runner.runAllBenchmarks();
+        std::cout << runner.toJSON() << std::endl;
+    @endcode
+ */
+class PerformanceBenchmarkRunner
+{
+public:
+    //==============================================================================
+    /** Holds the result of a single benchmark case. */
+    struct Result
+    {
+        String benchmarkName, caseName;
+        int64 numCalls, numSamples;
+        double totalSeconds, nanosecondsPerSample, realTimeFactor;
+        NamedValueSet values;
+    };
+
+    //==============================================================================
+    /** Creates a runner. */
+    PerformanceBenchmarkRunner();
+
+    /** Destructor. */
+    virtual ~PerformanceBenchmarkRunner();
+
+    /** Sets the minimum time each case will be run for.
+
+        Longer times give more stable results. The default is 0.25 seconds.
+     */
+    void setMinimumTimePerCase (double seconds) noexcept     { minTimePerCase = seconds; }
+
+    /** Runs all the registered benchmarks.
+
+        If a category is given only benchmarks with that category will be run.
+     */
+    void runAllBenchmarks (const String& categoryToRun = {});
+
+    /** Runs a specific set of benchmarks. */
+    void runBenchmarks (const Array<PerformanceBenchmark*>& benchmarks);
+
+    /** Returns the results collected so far. */
+    const Array<Result>& getResults() const noexcept        { return results; }
+
+    /** Returns the results as a JSON string. */
+    String toJSON() const;
+
+    //==============================================================================
+    /** Called as each case is finished.
+
+        By default this logs a line to the console. Override to change this.
+     */
+    virtual void logMessage (const String& message);
+
+private:
+    //==============================================================================
+    friend class PerformanceBenchmark;
+
+    double minTimePerCase;
+    PerformanceBenchmark* currentBenchmark;
+    Array<Result> results;
+
+    void addResult (const String& caseName, int64 numSamplesPerCall, double sampleRate,
+                    const std::function<void()>& functionToTime);
+    void addValue (const String& caseName, const String& valueName, double value);
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PerformanceBenchmarkRunner)
+};
+
+#endif // DROWAUDIO_BENCHMARKS
+#endif // DROWAUDIO_PERFORMANCEBENCHMARK_H
@@ -0,0 +1,472 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+namespace PriorityTimeSliceThreadHelpers
+{
+    /** Returns the signed number of milliseconds from one millisecond counter value to
+        another, allowing for the counter wrapping around.
+    */
+    static inline int getMillisecondsBetween (uint32 start, uint32 end) noexcept
+    {
+        return (int) (end - start);
+    }
+
+    /** Returns the class a client is competing as, once it has been promoted for
+        every hold time it has been kept waiting.
+    */
+    static inline int getEffectiveClass (int clientClass, int millisecondsOverdue, int holdTime) noexcept
+    {
+        return jmax (0, clientClass - jmax (0, millisecondsOverdue) / holdTime);
+    }
+
+    /** The Thread priorities of the TimeSliceThreads used for each class. */
+    static const int classThreadPriorities[] = { 8, 5, 2 };
+
+    static const char* const classThreadNames[] = { "Real-time Feeding", "Interactive", "Bulk" };
+}
+
+//==============================================================================
+PriorityTimeSliceThread::PriorityTimeSliceThread (const String& name)
+    : Thread (name),
+      clientBeingCalled (nullptr),
+      feedingGuardTime (10),
+      maximumHoldTime (100)
+{
+    for (auto& count : numMissedDeadlines)
+        count.store (0);
+}
+
+PriorityTimeSliceThread::~PriorityTimeSliceThread()
+{
+    stopThread (2000);
+
+    for (auto& thread : classThreads)
+        if (thread != nullptr)
+            thread->stopThread (2000);
+}
+
+//==============================================================================
+void PriorityTimeSliceThread::addTimeSliceClient (TimeSliceClient* const clientToAdd, int millisecondsBeforeStarting)
+{
+    addTimeSliceClient (clientToAdd, interactive, -1, millisecondsBeforeStarting);
+}
+
+void PriorityTimeSliceThread::addTimeSliceClient (TimeSliceClient* const clientToAdd, ClientClass clientClass,
+                                                  int deadlineMilliseconds, int millisecondsBeforeStarting)
+{
+    if (clientToAdd == nullptr)
+        return;
+
+    jassert (clientClass >= realtimeFeeding && clientClass < numClientClasses);
+
+    {
+        const ScopedLock sl (listLock);
+        const uint32 now = Time::getMillisecondCounter();
+
+        ClientInfo info;
+        info.client = clientToAdd;
+        info.clientClass = clientClass;
+        info.deadline = deadlineMilliseconds;
+        info.nextCallTime = now + (uint32) jmax (0, millisecondsBeforeStarting);
+        info.lastCallTime = now;
+
+        const int index = indexOfClient (clientToAdd);
+
+        if (index >= 0)
+            clients.setUnchecked (index, info);
+        else
+            clients.add (info);
+    }
+
+    notify();
+}
+
+void PriorityTimeSliceThread::removeTimeSliceClient (TimeSliceClient* const clientToRemove)
+{
+    const ScopedLock sl1 (listLock);
+
+    // if there's a chance we're in the middle of calling this client, we need to
+    // also lock the outer lock..
+    if (clientBeingCalled == clientToRemove)
+    {
+        const ScopedUnlock ul (listLock); // unlock first to get the order right..
+
+        const ScopedLock sl2 (callbackLock);
+        const ScopedLock sl3 (listLock);
+
+        clients.remove (indexOfClient (clientToRemove));
+    }
+    else
+    {
+        clients.remove (indexOfClient (clientToRemove));
+    }
+}
+
+void PriorityTimeSliceThread::removeAllClients()
+{
+    for (;;)
+    {
+        TimeSliceClient* client = nullptr;
+
+        {
+            const ScopedLock sl (listLock);
+
+            if (clients.size() == 0)
+                break;
+
+            client = clients.getReference (0).client;
+        }
+
+        removeTimeSliceClient (client);
+    }
+}
+
+void PriorityTimeSliceThread::moveToFrontOfQueue (TimeSliceClient* const client)
+{
+    {
+        const ScopedLock sl (listLock);
+        const int index = indexOfClient (client);
+
+        if (index < 0)
+            return;
+
+        ClientInfo& info = clients.getReference (index);
+        info.nextCallTime = Time::getMillisecondCounter();
+        info.lastCallTime = info.nextCallTime - (uint32) 0x40000000;
+    }
+
+    notify();
+}
+
+int PriorityTimeSliceThread::getNumClients() const
+{
+    const ScopedLock sl (listLock);
+    return clients.size();
+}
+
+TimeSliceClient* PriorityTimeSliceThread::getClient (const int index) const
+{
+    const ScopedLock sl (listLock);
+    return isPositiveAndBelow (index, clients.size()) ? clients.getReference (index).client : nullptr;
+}
+
+int PriorityTimeSliceThread::getNumMissedDeadlines (ClientClass clientClass) const noexcept
+{
+    jassert (clientClass >= realtimeFeeding && clientClass < numClientClasses);
+    return numMissedDeadlines[clientClass].load();
+}
+
+//==============================================================================
+TimeSliceThread& PriorityTimeSliceThread::getTimeSliceThread (ClientClass clientClass)
+{
+    using namespace PriorityTimeSliceThreadHelpers;
+
+    jassert (clientClass >= realtimeFeeding && clientClass < numClientClasses);
+
+    const ScopedLock sl (classThreadLock);
+    std::unique_ptr<TimeSliceThread>& thread = classThreads[clientClass];
+
+    if (thread == nullptr)
+    {
+        thread = std::make_unique<TimeSliceThread> (getThreadName() + " " + classThreadNames[clientClass]);
+        thread->startThread (classThreadPriorities[clientClass]);
+    }
+
+    return *thread;
+}
+
+//==============================================================================
+void PriorityTimeSliceThread::run()
+{
+    while (! threadShouldExit())
+    {
+        int timeToWait = 500;
+
+        {
+            const ScopedLock sl (callbackLock);
+
+            {
+                const ScopedLock sl2 (listLock);
+                const uint32 now = Time::getMillisecondCounter();
+                const int index = getNextClientIndex (now, timeToWait);
+
+                if (index >= 0)
+                {
+                    const ClientInfo& info = clients.getReference (index);
+
+                    if (info.deadline >= 0
+                        && PriorityTimeSliceThreadHelpers::getMillisecondsBetween (info.nextCallTime, now) > info.deadline)
+                        numMissedDeadlines[info.clientClass].fetch_add (1);
+
+                    clientBeingCalled = info.client;
+                }
+            }
+
+            if (clientBeingCalled != nullptr)
+            {
+                const int msUntilNextCall = clientBeingCalled->useTimeSlice();
+
+                const ScopedLock sl2 (listLock);
+
+                // the client may have removed itself during the callback
+                const int index = indexOfClient (clientBeingCalled);
+
+                if (index >= 0)
+                {
+                    if (msUntilNextCall >= 0)
+                    {
+                        ClientInfo& info = clients.getReference (index);
+                        info.lastCallTime = Time::getMillisecondCounter();
+                        info.nextCallTime = info.lastCallTime + (uint32) msUntilNextCall;
+                    }
+                    else
+                    {
+                        clients.remove (index);
+                    }
+                }
+
+                clientBeingCalled = nullptr;
+                timeToWait = 0;
+            }
+        }
+
+        if (timeToWait > 0)
+            wait (timeToWait);
+    }
+}
+
+//==============================================================================
+int PriorityTimeSliceThread::indexOfClient (const TimeSliceClient* const client) const noexcept
+{
+    for (int i = 0; i < clients.size(); ++i)
+        if (clients.getReference (i).client == client)
+            return i;
+
+    return -1;
+}
+
+int PriorityTimeSliceThread::getNextClientIndex (uint32 now, int& millisecondsToWait) const noexcept
+{
+    using namespace PriorityTimeSliceThreadHelpers;
+
+    const int holdTime = maximumHoldTime.load();
+    int bestIndex = -1, bestClass = numClientClasses;
+    int feedingDueIn = std::numeric_limits<int>::max();
+
+    for (int i = 0; i < clients.size(); ++i)
+    {
+        const ClientInfo& info = clients.getReference (i);
+        const int dueIn = getMillisecondsBetween (now, info.nextCallTime);
+
+        if (info.clientClass == realtimeFeeding)
+            feedingDueIn = jmin (feedingDueIn, dueIn);
+
+        if (dueIn > 0)
+        {
+            millisecondsToWait = jmin (millisecondsToWait, dueIn);
+            continue;
+        }
+
+        const int effectiveClass = getEffectiveClass (info.clientClass, -dueIn, holdTime);
+
+        if (bestIndex < 0)
+        {
+            bestIndex = i;
+            bestClass = effectiveClass;
+            continue;
+        }
+
+        // most urgent class first, then whichever must be called soonest, then least
+        // recently called. A client without a deadline is given the hold time as one so
+        // that a promoted client isn't always beaten by one that has a deadline
+        const ClientInfo& best = clients.getReference (bestIndex);
+        const int callBy = getMillisecondsBetween (now, info.nextCallTime + (uint32) (info.deadline >= 0 ? info.deadline : holdTime));
+        const int bestCallBy = getMillisecondsBetween (now, best.nextCallTime + (uint32) (best.deadline >= 0 ? best.deadline : holdTime));
+        bool isBetter = false;
+
+        if (effectiveClass != bestClass)
+            isBetter = effectiveClass < bestClass;
+        else if (callBy != bestCallBy)
+            isBetter = callBy < bestCallBy;
+        else
+            isBetter = getMillisecondsBetween (best.lastCallTime, info.lastCallTime) < 0;
+
+        if (isBetter)
+        {
+            bestIndex = i;
+            bestClass = effectiveClass;
+        }
+    }
+
+    // hold back bulk work if a feeding client will need calling soon, unless it's
+    // already been held back for so long it has been promoted
+    if (bestIndex >= 0
+        && bestClass == bulk
+        && feedingDueIn > 0 && feedingDueIn <= feedingGuardTime.load())
+    {
+        millisecondsToWait = jmin (millisecondsToWait, feedingDueIn);
+        return -1;
+    }
+
+    return bestIndex;
+}
+
+//==============================================================================
+#if DROWAUDIO_UNIT_TESTS
+
+class PriorityTimeSliceThreadTests  : public UnitTest
+{
+public:
+    PriorityTimeSliceThreadTests() : UnitTest ("PriorityTimeSliceThread") {}
+
+    void runTest()
+    {
+        beginTest ("Feeding clients first");
+        {
+            PriorityTimeSliceThread thread ("PriorityTimeSliceThread test");
+            Array<int> order;
+            CriticalSection orderLock;
+
+            TestClient bulkClient (0, -1, &order, &orderLock);
+            TestClient feedingClient (1, -1, &order, &orderLock);
+
+            // add them before starting so that both are due at the same time
+            thread.addTimeSliceClient (&bulkClient, PriorityTimeSliceThread::bulk);
+            thread.addTimeSliceClient (&feedingClient, PriorityTimeSliceThread::realtimeFeeding);
+            thread.startThread();
+
+            waitFor ([&] { return thread.getNumClients() == 0; });
+
+            const ScopedLock sl (orderLock);
+            expectEquals (order.size(), 2);
+            expectEquals (order[0], 1);
+            expectEquals (order[1], 0);
+        }
+
+        beginTest ("Bulk clients aren't starved");
+        {
+            PriorityTimeSliceThread thread ("PriorityTimeSliceThread test");
+            thread.setFeedingGuardTime (10);
+            thread.setMaximumHoldTime (50);
+
+            // this is always due again within the guard time so would hold bulk work back forever
+            TestClient feedingClient (0, 1);
+            TestClient bulkClient (1, 0);
+
+            thread.addTimeSliceClient (&feedingClient, PriorityTimeSliceThread::realtimeFeeding);
+            thread.addTimeSliceClient (&bulkClient, PriorityTimeSliceThread::bulk);
+            thread.startThread();
+
+            waitFor ([&] { return bulkClient.numCalls.load() > 0; });
+
+            expect (bulkClient.numCalls.load() > 0);
+            expect (feedingClient.numCalls.load() > 0);
+
+            thread.stopThread (2000);
+        }
+
+        beginTest ("Promoted clients aren't beaten by deadlines");
+        {
+            PriorityTimeSliceThread thread ("PriorityTimeSliceThread test");
+            thread.setFeedingGuardTime (0);
+            thread.setMaximumHoldTime (20);
+
+            // always due with a deadline so would win every tie with a promoted bulk client
+            TestClient feedingClient (0, 0);
+            TestClient bulkClient (1, 0);
+
+            thread.addTimeSliceClient (&feedingClient, PriorityTimeSliceThread::realtimeFeeding, 5);
+            thread.addTimeSliceClient (&bulkClient, PriorityTimeSliceThread::bulk);
+            thread.startThread();
+
+            waitFor ([&] { return bulkClient.numCalls.load() > 1; });
+
+            expect (bulkClient.numCalls.load() > 1);
+            expect (feedingClient.numCalls.load() > 0);
+
+            thread.stopThread (2000);
+        }
+
+        beginTest ("TimeSliceThreads for each class");
+        {
+            PriorityTimeSliceThread thread ("PriorityTimeSliceThread test");
+            TestClient client (0, -1);
+
+            TimeSliceThread& bulkThread = thread.getTimeSliceThread (PriorityTimeSliceThread::bulk);
+            expect (&bulkThread == &thread.getTimeSliceThread (PriorityTimeSliceThread::bulk));
+            expect (&bulkThread != &thread.getTimeSliceThread (PriorityTimeSliceThread::realtimeFeeding));
+
+            bulkThread.addTimeSliceClient (&client);
+            waitFor ([&] { return bulkThread.getNumClients() == 0; });
+
+            expectEquals (client.numCalls.load(), 1);
+        }
+    }
+
+private:
+    struct TestClient  : public TimeSliceClient
+    {
+        TestClient (int clientId, int interval, Array<int>* order = nullptr, CriticalSection* orderLock = nullptr)
+            : id (clientId), millisecondsBetweenCalls (interval), callOrder (order), callOrderLock (orderLock), numCalls (0)
+        {
+        }
+
+        int useTimeSlice() override
+        {
+            if (callOrder != nullptr)
+            {
+                const ScopedLock sl (*callOrderLock);
+                callOrder->add (id);
+            }
+
+            ++numCalls;
+            return millisecondsBetweenCalls;
+        }
+
+        const int id, millisecondsBetweenCalls;
+        Array<int>* callOrder;
+        CriticalSection* callOrderLock;
+        std::atomic<int> numCalls;
+    };
+
+    template <typename Condition>
+    static void waitFor (Condition condition)
+    {
+        const uint32 start = Time::getMillisecondCounter();
+
+        while (! condition() && Time::getMillisecondCounter() - start < 2000)
+            Thread::sleep (1);
+    }
+};
+
+static PriorityTimeSliceThreadTests priorityTimeSliceThreadTests;
+
+#endif // DROWAUDIO_UNIT_TESTS
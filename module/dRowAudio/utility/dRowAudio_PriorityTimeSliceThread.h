@@ -0,0 +1,187 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_PRIORITYTIMESLICETHREAD_H
+#define DROWAUDIO_PRIORITYTIMESLICETHREAD_H
+
+//==============================================================================
+/**
+    A thread that calls TimeSliceClients in order of urgency.
+
+    A TimeSliceThread calls its clients in turn with no idea of which ones are
+    urgent, so a long running task like a thumbnail scan can hold up a client
+    that is feeding the audio thread. This has the same interface for adding
+    and removing clients but each client also has a ClientClass and an optional
+    deadline.
+
+    Whenever more than one client is due to be called the one in the most urgent
+    class is called first, and within a class the one with the earliest deadline,
+    where a client without a deadline counts as having the maximum hold time.
+    A bulk client won't be called if a real-time feeding client is due within
+    the feeding guard time, as the bulk slice may take long enough to make the
+    feeding client late.
+
+    So that a busy client can't starve the others, a client that has been kept
+    waiting for longer than the maximum hold time is treated as being one class
+    more urgent for every hold time it waits, and is no longer held back by the
+    feeding guard.
+
+    As with a TimeSliceThread, the value returned from a client's useTimeSlice()
+    method is the number of milliseconds to wait before calling it again, or a
+    negative value to remove it.
+
+    Note that this isn't a TimeSliceThread, as the TimeSliceThread scheduling
+    can't be overridden. Classes that require one, such as BufferingAudioSource
+    and AudioThumbnailCache, can be given one of the TimeSliceThreads returned by
+    getTimeSliceThread() instead, which run at a thread priority to match their
+    class.
+
+    @see TimeSliceThread, TimeSliceClient
+*/
+class PriorityTimeSliceThread : public Thread
+{
+public:
+    //==============================================================================
+    /** The classes of client, in order of decreasing urgency. */
+    enum ClientClass
+    {
+        realtimeFeeding = 0,    /**< Keeps a buffer read by the audio thread full. */
+        interactive,            /**< Updates something the user is looking at. */
+        bulk,                   /**< Long running work that can be delayed. */
+        numClientClasses
+    };
+
+    //==============================================================================
+    /** Creates a PriorityTimeSliceThread.
+        When first created the thread is not running, use startThread() to start it.
+    */
+    explicit PriorityTimeSliceThread (const String& threadName);
+
+    /** Destructor.
+        Deleting this will stop the thread but won't delete any clients.
+    */
+    ~PriorityTimeSliceThread() override;
+
+    //==============================================================================
+    /** Adds an interactive client with no deadline.
+        This is the same as TimeSliceThread::addTimeSliceClient().
+    */
+    void addTimeSliceClient (TimeSliceClient* clientToAdd, int millisecondsBeforeStarting = 0);
+
+    /** Adds a client with a given class.
+
+        The deadline is the number of milliseconds after a client asks to be called
+        by which it must have been called. If it is called later than this it is
+        counted as missed and is returned by getNumMissedDeadlines(). A negative
+        deadline means the client doesn't have one.
+
+        If the client has already been added this will update its class and deadline.
+    */
+    void addTimeSliceClient (TimeSliceClient* clientToAdd, ClientClass clientClass,
+                             int deadlineMilliseconds = -1, int millisecondsBeforeStarting = 0);
+
+    /** Removes a client from the list.
+        This method will make sure that if the client is currently being called, it
+        waits for the callback to finish before returning.
+    */
+    void removeTimeSliceClient (TimeSliceClient* clientToRemove);
+
+    /** Removes all the active and pending clients from the list. */
+    void removeAllClients();
+
+    /** If the given client is waiting in the queue, it will be moved to the front
+        and given a time-slice as soon as possible. The client's class still
+        takes precedence.
+    */
+    void moveToFrontOfQueue (TimeSliceClient* client);
+
+    /** Returns the number of registered clients. */
+    int getNumClients() const;
+
+    /** Returns one of the registered clients. */
+    TimeSliceClient* getClient (int index) const;
+
+    //==============================================================================
+    /** Sets how close a real-time feeding client must be to being due before bulk
+        clients are held back. The default is 10ms.
+    */
+    void setFeedingGuardTime (int milliseconds) noexcept        { feedingGuardTime = jmax (0, milliseconds); }
+
+    /** Sets how long a due client can be kept waiting by more urgent ones before
+        it is promoted to the next class up. The default is 100ms.
+    */
+    void setMaximumHoldTime (int milliseconds) noexcept         { maximumHoldTime = jmax (1, milliseconds); }
+
+    /** Returns the number of times clients of a class have been called after their deadline. */
+    int getNumMissedDeadlines (ClientClass clientClass) const noexcept;
+
+    //==============================================================================
+    /** Returns a TimeSliceThread for clients of a class that can only be given one.
+
+        A TimeSliceThread's clients can't be called from this thread, so each class
+        gets its own TimeSliceThread instead, started the first time it's asked for.
+        The more urgent the class the higher the thread priority, so giving the
+        realtimeFeeding one to a BufferingAudioSource and the bulk one to an
+        AudioThumbnailCache stops a thumbnail scan holding up the read-ahead.
+
+        The threads are stopped when this is deleted, so remove their clients first.
+    */
+    TimeSliceThread& getTimeSliceThread (ClientClass clientClass);
+
+    //==============================================================================
+    /** @internal */
+    void run() override;
+
+private:
+    //==============================================================================
+    struct ClientInfo
+    {
+        TimeSliceClient* client;
+        ClientClass clientClass;
+        int deadline;
+        uint32 nextCallTime, lastCallTime;
+    };
+
+    Array<ClientInfo> clients;
+    CriticalSection callbackLock, listLock;
+    TimeSliceClient* clientBeingCalled;
+    std::atomic<int> feedingGuardTime, maximumHoldTime;
+    std::atomic<int> numMissedDeadlines[numClientClasses];
+    std::unique_ptr<TimeSliceThread> classThreads[numClientClasses];
+    CriticalSection classThreadLock;
+
+    int indexOfClient (const TimeSliceClient*) const noexcept;
+    int getNextClientIndex (uint32 now, int& millisecondsToWait) const noexcept;
+
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (PriorityTimeSliceThread)
+};
+
+#endif // DROWAUDIO_PRIORITYTIMESLICETHREAD_H
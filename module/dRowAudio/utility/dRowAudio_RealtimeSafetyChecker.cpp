@@ -0,0 +1,178 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#if DROWAUDIO_REALTIME_SAFETY_CHECKS
+
+namespace RealtimeSafetyCheckerHelpers
+{
+   #if JUCE_LINUX
+    // initial-exec TLS is set up when the thread starts so reading it from inside
+    // malloc can't cause a recursive allocation
+    #define DROWAUDIO_REALTIME_TLS __attribute__ ((tls_model ("initial-exec")))
+   #else
+    #define DROWAUDIO_REALTIME_TLS
+   #endif
+
+    static thread_local const char* currentScopeName DROWAUDIO_REALTIME_TLS = nullptr;
+    static thread_local int ignoreDepth DROWAUDIO_REALTIME_TLS = 0;
+
+    #undef DROWAUDIO_REALTIME_TLS
+
+    static std::atomic<int> violationCounts[RealtimeSafetyChecker::numViolationTypes];
+
+    struct LoggedViolation
+    {
+        RealtimeSafetyChecker::ViolationType type;
+        const char* scopeName;
+        const char* tag;
+    };
+
+    enum { maxNumLoggedViolations = 128 };
+    static LoggedViolation loggedViolations[maxNumLoggedViolations];
+    static int numLoggedViolations = 0;
+    static SpinLock loggedViolationsLock;
+
+    static const char* getViolationName (RealtimeSafetyChecker::ViolationType type) noexcept
+    {
+        switch (type)
+        {
+            case RealtimeSafetyChecker::allocation:         return "allocation";
+            case RealtimeSafetyChecker::deallocation:       return "deallocation";
+            case RealtimeSafetyChecker::lockAcquisition:    return "lock acquisition";
+            default:                                        return "unknown";
+        }
+    }
+
+    /** Returns true if this is the first time the violation has been seen. */
+    static bool addLoggedViolation (RealtimeSafetyChecker::ViolationType type,
+                                    const char* scopeName, const char* tag) noexcept
+    {
+        const SpinLock::ScopedLockType sl (loggedViolationsLock);
+
+        for (int i = 0; i < numLoggedViolations; ++i)
+        {
+            const LoggedViolation& v = loggedViolations[i];
+
+            if (v.type == type && std::strcmp (v.scopeName, scopeName) == 0 && std::strcmp (v.tag, tag) == 0)
+                return false;
+        }
+
+        if (numLoggedViolations >= maxNumLoggedViolations)
+            return false;
+
+        LoggedViolation& v = loggedViolations[numLoggedViolations++];
+        v.type = type;
+        v.scopeName = scopeName;
+        v.tag = tag;
+
+        return true;
+    }
+}
+
+//==============================================================================
+RealtimeSafetyChecker::ScopedRealtimeScope::ScopedRealtimeScope (const char* scopeName) noexcept
+    : previousScopeName (RealtimeSafetyCheckerHelpers::currentScopeName)
+{
+    jassert (scopeName != nullptr);
+    RealtimeSafetyCheckerHelpers::currentScopeName = scopeName;
+}
+
+RealtimeSafetyChecker::ScopedRealtimeScope::~ScopedRealtimeScope() noexcept
+{
+    RealtimeSafetyCheckerHelpers::currentScopeName = previousScopeName;
+}
+
+RealtimeSafetyChecker::ScopedIgnoreViolations::ScopedIgnoreViolations() noexcept
+{
+    ++RealtimeSafetyCheckerHelpers::ignoreDepth;
+}
+
+RealtimeSafetyChecker::ScopedIgnoreViolations::~ScopedIgnoreViolations() noexcept
+{
+    --RealtimeSafetyCheckerHelpers::ignoreDepth;
+}
+
+//==============================================================================
+bool RealtimeSafetyChecker::isRealtimeThread() noexcept
+{
+    return RealtimeSafetyCheckerHelpers::currentScopeName != nullptr;
+}
+
+void RealtimeSafetyChecker::checkViolation (ViolationType type, const char* tag) noexcept
+{
+    if (RealtimeSafetyCheckerHelpers::currentScopeName != nullptr
+        && RealtimeSafetyCheckerHelpers::ignoreDepth == 0)
+        reportViolation (type, tag);
+}
+
+int RealtimeSafetyChecker::getNumViolations() noexcept
+{
+    int total = 0;
+
+    for (int i = 0; i < numViolationTypes; ++i)
+        total += getNumViolations ((ViolationType) i);
+
+    return total;
+}
+
+int RealtimeSafetyChecker::getNumViolations (ViolationType type) noexcept
+{
+    jassert (type >= 0 && type < numViolationTypes);
+    return RealtimeSafetyCheckerHelpers::violationCounts[type].load();
+}
+
+void RealtimeSafetyChecker::resetViolations() noexcept
+{
+    using namespace RealtimeSafetyCheckerHelpers;
+
+    for (auto& count : violationCounts)
+        count.store (0);
+
+    const SpinLock::ScopedLockType sl (loggedViolationsLock);
+    numLoggedViolations = 0;
+}
+
+void RealtimeSafetyChecker::reportViolation (ViolationType type, const char* tag) noexcept
+{
+    using namespace RealtimeSafetyCheckerHelpers;
+
+    violationCounts[type].fetch_add (1);
+
+    // logging allocates so make sure that doesn't get reported as well
+    const ScopedIgnoreViolations ignoreViolations;
+    const char* const scopeName = currentScopeName;
+
+    if (addLoggedViolation (type, scopeName, tag))
+        Logger::writeToLog (String ("Real-time ") + getViolationName (type) + " (" + tag + ") in "
+                             + scopeName + newLine + SystemStats::getStackBacktrace());
+}
+
+#endif // DROWAUDIO_REALTIME_SAFETY_CHECKS
@@ -0,0 +1,148 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_REALTIMESAFETYCHECKER_H
+#define DROWAUDIO_REALTIMESAFETYCHECKER_H
+
+#if DROWAUDIO_REALTIME_SAFETY_CHECKS || DOXYGEN
+
+//==============================================================================
+/**
+    Detects memory allocations and lock acquisitions on real-time threads.
+
+    Wrap your audio callback in a ScopedRealtimeScope (or use the
+    DROWAUDIO_REALTIME_SCOPE macro) and any call to operator new or delete made
+    whilst the scope is active will be reported as a violation. On Linux calls to
+    malloc, calloc, realloc and free are also intercepted.
+
+    On Linux pthread_mutex_lock is intercepted too, which catches CriticalSection
+    and any other blocking lock, including those taken inside JUCE. Elsewhere
+    locks can't be intercepted automatically so the module's classes mark the
+    places where they take a blocking lock with DROWAUDIO_CHECK_REALTIME_LOCK. You
+    can do the same in your own code. On Linux a marked lock will be counted twice.
+
+    The first time each type of violation happens in each scope a message is
+    logged along with the stack backtrace. Every violation is counted and the
+    total can be retrieved with getNumViolations(), which is useful in tests.
+
+    This is only compiled in when DROWAUDIO_REALTIME_SAFETY_CHECKS is enabled. As
+    it replaces the global operator new and delete it can't be used in a project
+    that also replaces them.
+*/
+class RealtimeSafetyChecker
+{
+public:
+    //==============================================================================
+    /** The types of violation that can be detected. */
+    enum ViolationType
+    {
+        allocation = 0,
+        deallocation,
+        lockAcquisition,
+        numViolationTypes
+    };
+
+    //==============================================================================
+    /** Marks the current thread as real-time for the lifetime of this object.
+
+        These can be nested, the name of the innermost scope is used when
+        logging a violation. The name must be a string literal or otherwise live
+        for the duration of the program.
+    */
+    class ScopedRealtimeScope
+    {
+    public:
+        explicit ScopedRealtimeScope (const char* scopeName = "audio callback") noexcept;
+        ~ScopedRealtimeScope() noexcept;
+
+    private:
+        const char* const previousScopeName;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedRealtimeScope)
+    };
+
+    /** Temporarily stops violations being reported on the current thread.
+
+        Use this around code that you know allocates but is acceptable, such as
+        some logging in a debug build.
+    */
+    class ScopedIgnoreViolations
+    {
+    public:
+        ScopedIgnoreViolations() noexcept;
+        ~ScopedIgnoreViolations() noexcept;
+
+    private:
+        JUCE_DECLARE_NON_COPYABLE (ScopedIgnoreViolations)
+    };
+
+    //==============================================================================
+    /** Returns true if the calling thread is inside a ScopedRealtimeScope. */
+    static bool isRealtimeThread() noexcept;
+
+    /** Reports a violation if the calling thread is inside a ScopedRealtimeScope.
+        The tag should be a string literal describing where it happened.
+    */
+    static void checkViolation (ViolationType type, const char* tag) noexcept;
+
+    /** Returns the number of violations of any type that have happened since the
+        last call to resetViolations().
+    */
+    static int getNumViolations() noexcept;
+
+    /** Returns the number of violations of a specific type that have happened
+        since the last call to resetViolations().
+    */
+    static int getNumViolations (ViolationType type) noexcept;
+
+    /** Resets the violation counts and the record of which have been logged. */
+    static void resetViolations() noexcept;
+
+private:
+    //==============================================================================
+    static void reportViolation (ViolationType, const char* tag) noexcept;
+
+    RealtimeSafetyChecker() = delete;
+};
+
+//==============================================================================
+/** Marks the rest of the enclosing scope as real-time. */
+#define DROWAUDIO_REALTIME_SCOPE(scopeName)    const drow::RealtimeSafetyChecker::ScopedRealtimeScope JUCE_JOIN_MACRO (realtimeScope_, __LINE__) (scopeName);
+
+/** Reports a violation if a blocking lock is about to be taken on a real-time thread. */
+#define DROWAUDIO_CHECK_REALTIME_LOCK(tag)     drow::RealtimeSafetyChecker::checkViolation (drow::RealtimeSafetyChecker::lockAcquisition, tag)
+
+#else
+ #define DROWAUDIO_REALTIME_SCOPE(scopeName)
+ #define DROWAUDIO_CHECK_REALTIME_LOCK(tag)     ((void) 0)
+#endif
+
+#endif // DROWAUDIO_REALTIMESAFETYCHECKER_H
@@ -0,0 +1,176 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#if DROWAUDIO_REALTIME_SAFETY_CHECKS
+
+//==============================================================================
+// These replace the global allocation functions for the whole program so they
+// have to be compiled outside the drow namespace.
+#if JUCE_LINUX
+#include <dlfcn.h>
+
+extern "C"
+{
+    void* __libc_malloc (size_t);
+    void* __libc_calloc (size_t, size_t);
+    void* __libc_realloc (void*, size_t);
+    void __libc_free (void*);
+}
+#endif
+
+namespace drow
+{
+namespace RealtimeSafetyCheckerHelpers
+{
+    static inline void* rawMalloc (size_t size) noexcept
+    {
+       #if JUCE_LINUX
+        return __libc_malloc (size);
+       #else
+        return std::malloc (size);
+       #endif
+    }
+
+    static inline void rawFree (void* ptr) noexcept
+    {
+       #if JUCE_LINUX
+        __libc_free (ptr);
+       #else
+        std::free (ptr);
+       #endif
+    }
+
+   #if JUCE_LINUX
+    typedef int (*MutexLockFunction) (pthread_mutex_t*);
+    static std::atomic<MutexLockFunction> realMutexLock (nullptr);
+
+    /** Finds the next pthread_mutex_lock along from ours, which will be glibc's. */
+    static MutexLockFunction getRealMutexLock() noexcept
+    {
+        MutexLockFunction function = realMutexLock.load (std::memory_order_acquire);
+
+        if (function == nullptr)
+        {
+            // dlsym may allocate
+            const RealtimeSafetyChecker::ScopedIgnoreViolations ignoreViolations;
+            function = (MutexLockFunction) dlsym (RTLD_NEXT, "pthread_mutex_lock");
+            realMutexLock.store (function, std::memory_order_release);
+        }
+
+        return function;
+    }
+
+    // look it up at start-up rather than in the first real-time scope that locks
+    static const MutexLockFunction initialRealMutexLock = getRealMutexLock();
+   #endif
+
+    static void* checkedNew (size_t size, const char* tag)
+    {
+        RealtimeSafetyChecker::checkViolation (RealtimeSafetyChecker::allocation, tag);
+
+        if (void* ptr = rawMalloc (size == 0 ? 1 : size))
+            return ptr;
+
+        throw std::bad_alloc();
+    }
+
+    static void checkedDelete (void* ptr, const char* tag) noexcept
+    {
+        if (ptr != nullptr)
+        {
+            RealtimeSafetyChecker::checkViolation (RealtimeSafetyChecker::deallocation, tag);
+            rawFree (ptr);
+        }
+    }
+}
+}
+
+void* operator new (std::size_t size)                                   { return drow::RealtimeSafetyCheckerHelpers::checkedNew (size, "operator new"); }
+void* operator new[] (std::size_t size)                                 { return drow::RealtimeSafetyCheckerHelpers::checkedNew (size, "operator new[]"); }
+void operator delete (void* ptr) noexcept                               { drow::RealtimeSafetyCheckerHelpers::checkedDelete (ptr, "operator delete"); }
+void operator delete[] (void* ptr) noexcept                             { drow::RealtimeSafetyCheckerHelpers::checkedDelete (ptr, "operator delete[]"); }
+void operator delete (void* ptr, std::size_t) noexcept                  { drow::RealtimeSafetyCheckerHelpers::checkedDelete (ptr, "operator delete"); }
+void operator delete[] (void* ptr, std::size_t) noexcept                { drow::RealtimeSafetyCheckerHelpers::checkedDelete (ptr, "operator delete[]"); }
+
+void* operator new (std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return drow::RealtimeSafetyCheckerHelpers::checkedNew (size, "operator new"); }
+    catch (...) { return nullptr; }
+}
+
+void* operator new[] (std::size_t size, const std::nothrow_t&) noexcept
+{
+    try { return drow::RealtimeSafetyCheckerHelpers::checkedNew (size, "operator new[]"); }
+    catch (...) { return nullptr; }
+}
+
+#if JUCE_LINUX
+extern "C"
+{
+    // glibc lets a program provide its own malloc family which is then used
+    // everywhere, including by other libraries
+    void* malloc (size_t size) noexcept
+    {
+        drow::RealtimeSafetyChecker::checkViolation (drow::RealtimeSafetyChecker::allocation, "malloc");
+        return __libc_malloc (size);
+    }
+
+    void* calloc (size_t numElements, size_t elementSize) noexcept
+    {
+        drow::RealtimeSafetyChecker::checkViolation (drow::RealtimeSafetyChecker::allocation, "calloc");
+        return __libc_calloc (numElements, elementSize);
+    }
+
+    void* realloc (void* ptr, size_t size) noexcept
+    {
+        drow::RealtimeSafetyChecker::checkViolation (drow::RealtimeSafetyChecker::allocation, "realloc");
+        return __libc_realloc (ptr, size);
+    }
+
+    void free (void* ptr) noexcept
+    {
+        if (ptr != nullptr)
+            drow::RealtimeSafetyChecker::checkViolation (drow::RealtimeSafetyChecker::deallocation, "free");
+
+        __libc_free (ptr);
+    }
+
+    // CriticalSection and most other blocking locks end up here. Try-locks
+    // don't block so they aren't checked
+    int pthread_mutex_lock (pthread_mutex_t* mutex) noexcept
+    {
+        drow::RealtimeSafetyChecker::checkViolation (drow::RealtimeSafetyChecker::lockAcquisition, "pthread_mutex_lock");
+        return drow::RealtimeSafetyCheckerHelpers::getRealMutexLock() (mutex);
+    }
+}
+#endif
+
+#endif // DROWAUDIO_REALTIME_SAFETY_CHECKS
@@ -0,0 +1,362 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+namespace TraceRecorderHelpers
+{
+    struct Event
+    {
+        const char* name;
+        int64 ticks;
+        double value;
+        char phase;
+    };
+
+    /** The events recorded by a single thread. Only the owning thread writes to this. */
+    struct ThreadBuffer
+    {
+        explicit ThreadBuffer (int index)
+            : threadIndex (index),
+              events ((size_t) TraceRecorder::numEventsPerThread),
+              writeIndex (0), clearIndex (0),
+              isClaimed (false), hasName (false)
+        {
+        }
+
+        const int threadIndex;
+        String threadName; // guarded by the registry's lock
+        HeapBlock<Event> events;
+        std::atomic<uint64> writeIndex, clearIndex;
+        std::atomic<bool> isClaimed, hasName;
+
+        JUCE_DECLARE_NON_COPYABLE (ThreadBuffer)
+    };
+
+    enum
+    {
+        maxNumThreadBuffers = 64,
+        numSpareThreadBuffers = 4
+    };
+
+    /** Holds all the thread buffers. These are never deleted, so a thread can keep
+        a pointer to its own buffer, but when a registered thread exits its buffer is
+        handed on to the next new thread.
+    */
+    struct Registry
+    {
+        Registry() : numBuffers (0), startTicks (Time::getHighResolutionTicks()) {}
+
+        ~Registry()
+        {
+            for (int i = 0; i < numBuffers.load(); ++i)
+                delete buffers[i];
+        }
+
+        SpinLock lock;
+        ThreadBuffer* buffers[maxNumThreadBuffers];
+        std::atomic<int> numBuffers;
+        const int64 startTicks;
+    };
+
+    static Registry& getRegistry()
+    {
+        static Registry registry;
+        return registry;
+    }
+
+    static thread_local ThreadBuffer* currentThreadBuffer = nullptr;
+
+    /** Hands a registered thread's buffer back when the thread exits. */
+    struct ThreadExitReleaser
+    {
+        ~ThreadExitReleaser()
+        {
+            if (isActive && currentThreadBuffer != nullptr)
+                currentThreadBuffer->isClaimed.store (false, std::memory_order_release);
+
+            currentThreadBuffer = nullptr;
+        }
+
+        bool isActive = false;
+    };
+
+    static thread_local ThreadExitReleaser threadExitReleaser;
+
+    static String getCurrentThreadName (int threadIndex)
+    {
+        if (Thread* thread = Thread::getCurrentThread())
+            return thread->getThreadName();
+
+        if (MessageManager::existsAndIsCurrentThread())
+            return "Message Thread";
+
+        return "Thread " + String (threadIndex);
+    }
+
+    /** Makes sure there are a few unclaimed buffers for new threads to take. */
+    static void topUpSpareBuffers()
+    {
+        Registry& registry = getRegistry();
+        const SpinLock::ScopedLockType sl (registry.lock);
+
+        const int numBuffers = registry.numBuffers.load();
+        int numSpare = 0;
+
+        for (int i = 0; i < numBuffers; ++i)
+            if (! registry.buffers[i]->isClaimed.load())
+                ++numSpare;
+
+        for (int i = numBuffers; numSpare < numSpareThreadBuffers && i < maxNumThreadBuffers; ++i, ++numSpare)
+        {
+            registry.buffers[i] = new ThreadBuffer (i);
+            registry.numBuffers.store (i + 1, std::memory_order_release);
+        }
+    }
+
+    /** Takes an unclaimed buffer for the calling thread without locking or allocating. */
+    static ThreadBuffer* claimBuffer() noexcept
+    {
+        Registry& registry = getRegistry();
+        const int numBuffers = registry.numBuffers.load (std::memory_order_acquire);
+
+        for (int i = 0; i < numBuffers; ++i)
+        {
+            ThreadBuffer* const buffer = registry.buffers[i];
+            bool wasClaimed = false;
+
+            if (! buffer->isClaimed.load (std::memory_order_relaxed)
+                && buffer->isClaimed.compare_exchange_strong (wasClaimed, true, std::memory_order_acquire))
+            {
+                // the events of an exited thread are kept until its buffer is taken
+                buffer->hasName = false;
+                buffer->clearIndex.store (buffer->writeIndex.load (std::memory_order_relaxed));
+                return buffer;
+            }
+        }
+
+        return nullptr;
+    }
+
+    static ThreadBuffer* getCurrentThreadBuffer() noexcept
+    {
+        if (currentThreadBuffer == nullptr)
+            currentThreadBuffer = claimBuffer();
+
+        return currentThreadBuffer;
+    }
+
+    static void addEvents (const ThreadBuffer& buffer, int64 startTicks, Array<var>& traceEvents)
+    {
+        const uint64 numEvents = (uint64) TraceRecorder::numEventsPerThread;
+        const uint64 end = buffer.writeIndex.load (std::memory_order_acquire);
+        const uint64 start = jmax (buffer.clearIndex.load (std::memory_order_relaxed),
+                                   end > numEvents ? end - numEvents : (uint64) 0);
+
+        if (start >= end)
+            return;
+
+        Array<Event> events;
+        events.ensureStorageAllocated ((int) (end - start));
+
+        for (uint64 i = start; i < end; ++i)
+            events.add (buffer.events[(size_t) (i % numEvents)]);
+
+        // the owning thread may have carried on and overwritten the oldest events whilst
+        // they were being copied, including the one it is in the middle of writing
+        const uint64 endAfterCopy = buffer.writeIndex.load (std::memory_order_acquire);
+        const uint64 firstValid = endAfterCopy + 1 > numEvents ? endAfterCopy + 1 - numEvents : (uint64) 0;
+        const int numToSkip = (int) jmin ((uint64) events.size(), firstValid > start ? firstValid - start : (uint64) 0);
+
+        for (int i = numToSkip; i < events.size(); ++i)
+        {
+            const Event& e = events.getReference (i);
+
+            DynamicObject::Ptr event (new DynamicObject());
+            event->setProperty ("name", e.name);
+            event->setProperty ("cat", "dRowAudio");
+            event->setProperty ("ph", String::charToString ((juce_wchar) e.phase));
+            event->setProperty ("ts", Time::highResolutionTicksToSeconds (e.ticks - startTicks) * 1.0e6);
+            event->setProperty ("pid", 0);
+            event->setProperty ("tid", buffer.threadIndex);
+
+            if (e.phase == 'C')
+            {
+                DynamicObject::Ptr args (new DynamicObject());
+                args->setProperty (e.name, e.value);
+                event->setProperty ("args", var (args.get()));
+            }
+
+            traceEvents.add (var (event.get()));
+        }
+    }
+}
+
+//==============================================================================
+std::atomic<bool> TraceRecorder::enabled (false);
+
+void TraceRecorder::setEnabled (bool shouldBeEnabled)
+{
+    if (shouldBeEnabled)
+        TraceRecorderHelpers::topUpSpareBuffers();
+
+    enabled.store (shouldBeEnabled);
+}
+
+void TraceRecorder::registerThread (const String& name)
+{
+    using namespace TraceRecorderHelpers;
+
+    // this is called on every time slice by some clients so make that cheap
+    if (threadExitReleaser.isActive && currentThreadBuffer != nullptr && name.isEmpty())
+        return;
+
+    topUpSpareBuffers();
+
+    ThreadBuffer* const buffer = getCurrentThreadBuffer();
+
+    // all the buffers are in use
+    if (buffer == nullptr)
+        return;
+
+    threadExitReleaser.isActive = true;
+
+    const String threadName (name.isNotEmpty() ? name : getCurrentThreadName (buffer->threadIndex));
+
+    {
+        const SpinLock::ScopedLockType sl (getRegistry().lock);
+        buffer->threadName = threadName;
+    }
+
+    buffer->hasName = true;
+
+    // replace the spare this thread may have just taken
+    topUpSpareBuffers();
+}
+
+void TraceRecorder::beginEvent (const char* name) noexcept
+{
+    addEvent ('B', name, 0.0);
+}
+
+void TraceRecorder::endEvent (const char* name) noexcept
+{
+    addEvent ('E', name, 0.0);
+}
+
+void TraceRecorder::counterEvent (const char* name, double value) noexcept
+{
+    addEvent ('C', name, value);
+}
+
+void TraceRecorder::addEvent (char phase, const char* name, double value) noexcept
+{
+    using namespace TraceRecorderHelpers;
+
+    ThreadBuffer* const buffer = getCurrentThreadBuffer();
+
+    // no spare buffers were left for this thread
+    if (buffer == nullptr)
+        return;
+
+    const uint64 index = buffer->writeIndex.load (std::memory_order_relaxed);
+
+    Event& e = buffer->events[(size_t) (index % (uint64) numEventsPerThread)];
+    e.name = name;
+    e.ticks = Time::getHighResolutionTicks();
+    e.value = value;
+    e.phase = phase;
+
+    buffer->writeIndex.store (index + 1, std::memory_order_release);
+}
+
+//==============================================================================
+void TraceRecorder::clear()
+{
+    using namespace TraceRecorderHelpers;
+
+    Registry& registry = getRegistry();
+    const int numBuffers = registry.numBuffers.load (std::memory_order_acquire);
+
+    for (int i = 0; i < numBuffers; ++i)
+        registry.buffers[i]->clearIndex.store (registry.buffers[i]->writeIndex.load (std::memory_order_acquire));
+
+    topUpSpareBuffers();
+}
+
+String TraceRecorder::toChromeTraceJSON()
+{
+    using namespace TraceRecorderHelpers;
+
+    Registry& registry = getRegistry();
+    const int numBuffers = registry.numBuffers.load (std::memory_order_acquire);
+
+    Array<var> traceEvents;
+
+    for (int i = 0; i < numBuffers; ++i)
+    {
+        ThreadBuffer* const buffer = registry.buffers[i];
+
+        // skip buffers that have never been written to
+        if (buffer->writeIndex.load() == 0)
+            continue;
+
+        String threadName ("Thread " + String (buffer->threadIndex));
+
+        if (buffer->hasName.load())
+        {
+            const SpinLock::ScopedLockType sl (registry.lock);
+            threadName = buffer->threadName;
+        }
+
+        DynamicObject::Ptr args (new DynamicObject());
+        args->setProperty ("name", threadName);
+
+        DynamicObject::Ptr metadata (new DynamicObject());
+        metadata->setProperty ("name", "thread_name");
+        metadata->setProperty ("ph", "M");
+        metadata->setProperty ("pid", 0);
+        metadata->setProperty ("tid", buffer->threadIndex);
+        metadata->setProperty ("args", var (args.get()));
+        traceEvents.add (var (metadata.get()));
+
+        addEvents (*buffer, registry.startTicks, traceEvents);
+    }
+
+    DynamicObject::Ptr root (new DynamicObject());
+    root->setProperty ("traceEvents", traceEvents);
+    root->setProperty ("displayTimeUnit", "ms");
+
+    return JSON::toString (var (root.get()));
+}
+
+bool TraceRecorder::writeChromeTrace (const File& file)
+{
+    return file.replaceWithText (toChromeTraceJSON());
+}
@@ -0,0 +1,159 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_TRACERECORDER_H
+#define DROWAUDIO_TRACERECORDER_H
+
+//==============================================================================
+/**
+    Records timed events from any thread so you can see how background work
+    interleaves.
+
+    Each thread that records an event gets its own fixed size ring buffer, so
+    recording is lock-free. When the buffer is full the oldest events are
+    overwritten.
+
+    The buffers are only ever allocated by setEnabled(), registerThread() and
+    clear(), which keep a few spare ones ready. A thread that records without
+    registering takes a spare without locking or allocating, so the audio thread
+    can just start recording, but if there are none left its events are dropped.
+    Background threads should call registerThread(), or use DROWAUDIO_TRACE_THREAD,
+    so that they are named in the trace and their buffer is handed on to the next
+    new thread when they exit.
+
+    Use DROWAUDIO_TRACE_SCOPE to record the duration of a block of code and
+    DROWAUDIO_TRACE_COUNTER to record a changing value. Then call
+    writeChromeTrace() and open the file in chrome://tracing or Perfetto.
+
+    Recording is off by default. When it is off the macros only cost a single
+    relaxed atomic load and a branch.
+
+    Event names are stored as pointers so must be string literals or otherwise
+    live for as long as the recorder.
+*/
+class TraceRecorder
+{
+public:
+    //==============================================================================
+    /** The number of events each thread can hold before old ones are overwritten. */
+    enum { numEventsPerThread = 16384 };
+
+    //==============================================================================
+    /** Turns recording on or off.
+        Turning it on allocates some spare buffers so shouldn't be done on the audio thread.
+    */
+    static void setEnabled (bool shouldBeEnabled);
+
+    /** Gets a buffer ready for the calling thread and gives it a name in the trace.
+
+        Call this at the start of a thread that records events, but not on the audio
+        thread as it may allocate. Once registered the thread's buffer is given back
+        when it exits. If the name is empty the thread's own name is used, and calling
+        it again on a registered thread does nothing.
+    */
+    static void registerThread (const String& name = String());
+
+    /** Returns true if events are being recorded. */
+    static bool isEnabled() noexcept            { return enabled.load (std::memory_order_relaxed); }
+
+    //==============================================================================
+    /** Records the start of a duration event on the calling thread. */
+    static void beginEvent (const char* name) noexcept;
+
+    /** Records the end of a duration event on the calling thread. */
+    static void endEvent (const char* name) noexcept;
+
+    /** Records the value of a counter. */
+    static void counterEvent (const char* name, double value) noexcept;
+
+    //==============================================================================
+    /** Discards all the events recorded so far.
+        This is safe to call whilst other threads are recording. It also tops up the
+        spare buffers so shouldn't be called on the audio thread.
+    */
+    static void clear();
+
+    /** Returns the recorded events in the Chrome trace event format.
+        This can be called whilst other threads are recording, any events that are
+        overwritten whilst they are being read will be left out.
+    */
+    static String toChromeTraceJSON();
+
+    /** Writes the recorded events to a file in the Chrome trace event format. */
+    static bool writeChromeTrace (const File& file);
+
+    //==============================================================================
+    /** Records a duration event for the lifetime of this object. */
+    class ScopedTrace
+    {
+    public:
+        explicit ScopedTrace (const char* eventName) noexcept
+            : name (isEnabled() ? eventName : nullptr)
+        {
+            if (name != nullptr)
+                beginEvent (name);
+        }
+
+        ~ScopedTrace() noexcept
+        {
+            // always end a started event so they stay balanced if recording is turned off
+            if (name != nullptr)
+                endEvent (name);
+        }
+
+    private:
+        const char* const name;
+
+        JUCE_DECLARE_NON_COPYABLE (ScopedTrace)
+    };
+
+private:
+    //==============================================================================
+    static std::atomic<bool> enabled;
+
+    static void addEvent (char phase, const char* name, double value) noexcept;
+
+    TraceRecorder() = delete;
+};
+
+//==============================================================================
+/** Records the duration of the rest of the enclosing scope. */
+#define DROWAUDIO_TRACE_SCOPE(name)             const drow::TraceRecorder::ScopedTrace JUCE_JOIN_MACRO (traceScope_, __LINE__) (name);
+
+/** Registers the calling thread under its own name if tracing is enabled.
+    This is cheap once the thread is registered so can go at the top of a time slice.
+*/
+#define DROWAUDIO_TRACE_THREAD()                do { if (drow::TraceRecorder::isEnabled()) drow::TraceRecorder::registerThread(); } while (false)
+
+/** Records the value of a counter if tracing is enabled. */
+#define DROWAUDIO_TRACE_COUNTER(name, value)    do { if (drow::TraceRecorder::isEnabled()) drow::TraceRecorder::counterEvent (name, (double) (value)); } while (false)
+
+#endif // DROWAUDIO_TRACERECORDER_H
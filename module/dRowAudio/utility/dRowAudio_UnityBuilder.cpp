@@ -29,82 +29,191 @@
   ==============================================================================
 */
 
+
 //==============================================================================
-UnityBuilder::UnityBuilder()
+namespace UnityBuilderHelpers
 {
-}
+    namespace ManifestIds
+    {
+        static const Identifier manifest    = "UNITYMANIFEST";
+        static const Identifier input       = "INPUT";
+        static const Identifier unity       = "UNITY";
+        static const Identifier source      = "SOURCE";
+        static const Identifier dependency  = "DEPENDENCY";
+        static const Identifier path        = "path";
+        static const Identifier size        = "size";
+        static const Identifier modified    = "modified";
+        static const Identifier hash        = "hash";
+    }
 
-bool UnityBuilder::processDirectory (const File& sourceDirectory)
-{
-    if (sourceDirectory.isDirectory())
+    static String hashText (const String& text)
+    {
+        return MD5 (text.toUTF8()).toHexString();
+    }
+
+    static String hashFile (const File& file)
     {
-        Array<File> files;
-        sourceDirectory.findChildFiles (files, File::findFiles + File::ignoreHiddenFiles, true);
+        return MD5 (file).toHexString();
+    }
+
+    /** Writes a file only if its contents would change. */
+    static void replaceIfDifferent (const File& file, const String& text, bool onlyIfChanged)
+    {
+        if (onlyIfChanged && file.existsAsFile() && hashFile (file) == hashText (text))
+            return;
+
+        file.replaceWithText (text);
+    }
+
+    //==============================================================================
+    /** Finds the local headers a file depends on by following its quoted includes.
+        Each file is only read once so shared headers aren't re-parsed for every source.
+    */
+    class DependencyScanner
+    {
+    public:
+        DependencyScanner() {}
+
+        StringArray getDependencies (const File& file)
+        {
+            StringArray dependencies;
+            SortedSet<String> visited;
+            addDependencies (file, dependencies, visited);
+
+            return dependencies;
+        }
 
-        String includeString, sourceString;
+    private:
+        HashMap<String, StringArray> includeCache;
 
-        for (int i = 0; i < files.size(); ++i)
+        const StringArray& getDirectIncludes (const File& file)
         {
-            bool includeFile = true;
-            const File& currentFile = files.getReference (i);
+            const String path (file.getFullPathName());
 
-            // first check files
-            if (! filesToIgnore.contains (currentFile))
+            if (! includeCache.contains (path))
             {
-                // now check for directories
-                for (int f = 0; f < filesToIgnore.size(); ++f)
+                StringArray includes, lines;
+                file.readLines (lines);
+
+                for (int i = 0; i < lines.size(); ++i)
                 {
-                    const File& currentDir = filesToIgnore.getReference (f);
+                    const String line (lines[i].trimStart());
 
-                    if (currentDir.isDirectory()
-                        && currentFile.isAChildOf (currentDir))
+                    if (line.startsWithChar ('#') && line.substring (1).trimStart().startsWith ("include"))
                     {
-                        includeFile = false;
-                        break;
+                        const String name (line.fromFirstOccurrenceOf ("\"", false, false)
+                                               .upToFirstOccurrenceOf ("\"", false, false));
+
+                        if (name.isNotEmpty())
+                        {
+                            const File header (file.getSiblingFile (name));
+
+                            if (header.existsAsFile())
+                                includes.add (header.getFullPathName());
+                        }
                     }
                 }
 
-                if (includeFile)
-                {
-                    const String relativePath (currentFile.getRelativePathFrom (sourceDirectory));
+                includeCache.set (path, includes);
+            }
 
-                    if (currentFile.hasFileExtension (".h"))
-                        includeString << "#include \"" << relativePath << "\"" << newLine;
-                    else if (currentFile.hasFileExtension (".cpp"))
-                        sourceString << "#include \"" << relativePath << "\"" << newLine;
+            return includeCache.getReference (path);
+        }
+
+        void addDependencies (const File& file, StringArray& dependencies, SortedSet<String>& visited)
+        {
+            const StringArray includes (getDirectIncludes (file));
+
+            for (int i = 0; i < includes.size(); ++i)
+            {
+                if (! visited.contains (includes[i]))
+                {
+                    visited.add (includes[i]);
+                    dependencies.add (includes[i]);
+                    addDependencies (File (includes[i]), dependencies, visited);
                 }
             }
         }
 
-        // now write the output files
-        File outputFile (destinationFile == File() ? sourceDirectory : destinationFile);
+        JUCE_DECLARE_NON_COPYABLE (DependencyScanner)
+    };
 
-        if (outputFile.hasWriteAccess())
+    //==============================================================================
+    /** Checks manifest inputs against the file system, caching the result for
+        each path so headers shared between many sources are only checked once.
+    */
+    class InputChecker
+    {
+    public:
+        InputChecker (const ValueTree& manifestTree)
         {
-            File headerFile, cppFile;
-
-            if (outputFile.isDirectory())
+            for (int i = 0; i < manifestTree.getNumChildren(); ++i)
             {
-                const String baseName ("UnityBuild");
+                const ValueTree child (manifestTree.getChild (i));
 
-                headerFile = outputFile.getNonexistentChildFile (baseName, ".h");
-                cppFile = outputFile.getNonexistentChildFile (baseName, ".cpp");
-            }
-            else
-            {
-                headerFile = outputFile.getNonexistentSibling().withFileExtension (".h");
-                cppFile = outputFile.getNonexistentSibling().withFileExtension (".cpp");
+                if (child.hasType (ManifestIds::input))
+                    inputs.set (child[ManifestIds::path].toString(), child);
             }
+        }
+
+        bool hasChanged (const String& path)
+        {
+            if (! results.contains (path))
+                results.set (path, checkInput (path));
+
+            return results[path];
+        }
+
+    private:
+        HashMap<String, ValueTree> inputs;
+        HashMap<String, bool> results;
+
+        bool checkInput (const String& path) const
+        {
+            if (! inputs.contains (path))
+                return true;
+
+            const ValueTree input (inputs[path]);
+            const File file (path);
+
+            if (! file.existsAsFile())
+                return true;
+
+            // only hash the contents if the cheap checks disagree
+            if (file.getSize() == (int64) input[ManifestIds::size]
+                 && file.getLastModificationTime().toMilliseconds() == (int64) input[ManifestIds::modified])
+                return false;
+
+            return hashFile (file) != input[ManifestIds::hash].toString();
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (InputChecker)
+    };
+}
+
+//==============================================================================
+UnityBuilder::UnityBuilder()
+    : incremental (false)
+{
+}
+
+bool UnityBuilder::processDirectory (const File& sourceDirectory)
+{
+    if (sourceDirectory.isDirectory())
+    {
+        Array<File> headers, sources;
+        findSourceFiles (sourceDirectory, headers, sources);
 
-            String headerOutput (preInclusionString);
-            String sourceOutput (preInclusionString);
+        // now write the output files
+        File headerFile, cppFile;
 
-            headerOutput << includeString << postInclusionString;
-            sourceOutput << "#include \"" << headerFile.getFileName() << "\"" << newLine << newLine
-                << sourceString << postInclusionString;
+        if (getOutputFiles (sourceDirectory, headerFile, cppFile, incremental))
+        {
+            UnityBuilderHelpers::replaceIfDifferent (headerFile, createHeaderText (sourceDirectory, headers), incremental);
+            UnityBuilderHelpers::replaceIfDifferent (cppFile, createSourceText (sourceDirectory, sources, headerFile), incremental);
 
-            headerFile.replaceWithText (headerOutput);
-            cppFile.replaceWithText (sourceOutput);
+            if (manifestFile != File())
+                writeManifest (headerFile, headers, cppFile, sources);
 
             return true;
         }
@@ -129,3 +238,234 @@ void UnityBuilder::setPreAndPostString (const String& preInclusionString_,
     preInclusionString = preInclusionString_;
     postInclusionString = postInclusionString_;
 }
+
+void UnityBuilder::setIncremental (bool shouldOnlyWriteChangedFiles)
+{
+    incremental = shouldOnlyWriteChangedFiles;
+}
+
+void UnityBuilder::setDependencyManifestFile (const File& newManifestFile)
+{
+    manifestFile = newManifestFile;
+}
+
+Array<File> UnityBuilder::getUnityFilesNeedingRebuild (const File& sourceDirectory)
+{
+    using namespace UnityBuilderHelpers;
+
+    Array<File> filesNeedingRebuild;
+    File headerFile, cppFile;
+
+    if (! (sourceDirectory.isDirectory() && getOutputFiles (sourceDirectory, headerFile, cppFile, true)))
+        return filesNeedingRebuild;
+
+    Array<File> headers, sources;
+    findSourceFiles (sourceDirectory, headers, sources);
+
+    // first see if the set of files being included has changed
+    if (! headerFile.existsAsFile() || hashFile (headerFile) != hashText (createHeaderText (sourceDirectory, headers)))
+        filesNeedingRebuild.add (headerFile);
+
+    if (! cppFile.existsAsFile() || hashFile (cppFile) != hashText (createSourceText (sourceDirectory, sources, headerFile)))
+        filesNeedingRebuild.add (cppFile);
+
+    // then if any of the inputs have changed
+    const ValueTree manifestTree (manifestFile.existsAsFile() ? readValueTreeFromFile (manifestFile) : ValueTree());
+
+    if (! manifestTree.hasType (ManifestIds::manifest))
+    {
+        filesNeedingRebuild.addIfNotAlreadyThere (headerFile);
+        filesNeedingRebuild.addIfNotAlreadyThere (cppFile);
+
+        return filesNeedingRebuild;
+    }
+
+    InputChecker checker (manifestTree);
+
+    for (int i = 0; i < manifestTree.getNumChildren(); ++i)
+    {
+        const ValueTree unityTree (manifestTree.getChild (i));
+        const File unityFile (unityTree[ManifestIds::path].toString());
+
+        if (! unityTree.hasType (ManifestIds::unity)
+             || ! (unityFile == headerFile || unityFile == cppFile)
+             || filesNeedingRebuild.contains (unityFile))
+            continue;
+
+        bool changed = false;
+
+        for (int s = 0; s < unityTree.getNumChildren() && ! changed; ++s)
+        {
+            const ValueTree sourceTree (unityTree.getChild (s));
+            changed = checker.hasChanged (sourceTree[ManifestIds::path].toString());
+
+            for (int d = 0; d < sourceTree.getNumChildren() && ! changed; ++d)
+                changed = checker.hasChanged (sourceTree.getChild (d)[ManifestIds::path].toString());
+        }
+
+        if (changed)
+            filesNeedingRebuild.add (unityFile);
+    }
+
+    return filesNeedingRebuild;
+}
+
+//==============================================================================
+bool UnityBuilder::shouldIgnore (const File& file, const Array<File>& generatedFiles) const
+{
+    // first check files, never picking up our own output or manifest
+    if (filesToIgnore.contains (file) || generatedFiles.contains (file))
+        return true;
+
+    // now check for directories
+    for (int f = 0; f < filesToIgnore.size(); ++f)
+    {
+        const File& currentDir = filesToIgnore.getReference (f);
+
+        if (currentDir.isDirectory()
+            && file.isAChildOf (currentDir))
+            return true;
+    }
+
+    return false;
+}
+
+void UnityBuilder::findSourceFiles (const File& sourceDirectory, Array<File>& headers, Array<File>& sources) const
+{
+    Array<File> files;
+    sourceDirectory.findChildFiles (files, File::findFiles + File::ignoreHiddenFiles, true);
+
+    // the fixed names an incremental build writes to, which may be in sourceDirectory
+    Array<File> generatedFiles;
+    File headerFile, cppFile;
+
+    if (getOutputFiles (sourceDirectory, headerFile, cppFile, true))
+    {
+        generatedFiles.add (headerFile);
+        generatedFiles.add (cppFile);
+    }
+
+    if (manifestFile != File())
+        generatedFiles.add (manifestFile);
+
+    for (int i = 0; i < files.size(); ++i)
+    {
+        const File& currentFile = files.getReference (i);
+
+        if (! shouldIgnore (currentFile, generatedFiles))
+        {
+            if (currentFile.hasFileExtension (".h"))
+                headers.add (currentFile);
+            else if (currentFile.hasFileExtension (".cpp"))
+                sources.add (currentFile);
+        }
+    }
+}
+
+bool UnityBuilder::getOutputFiles (const File& sourceDirectory, File& headerFile, File& cppFile, bool useExistingNames) const
+{
+    const File outputFile (destinationFile == File() ? sourceDirectory : destinationFile);
+
+    if (! outputFile.hasWriteAccess())
+        return false;
+
+    if (outputFile.isDirectory())
+    {
+        const String baseName ("UnityBuild");
+
+        headerFile = useExistingNames ? outputFile.getChildFile (baseName + ".h")
+                                      : outputFile.getNonexistentChildFile (baseName, ".h");
+        cppFile = useExistingNames ? outputFile.getChildFile (baseName + ".cpp")
+                                   : outputFile.getNonexistentChildFile (baseName, ".cpp");
+    }
+    else
+    {
+        const File baseFile (useExistingNames ? outputFile : outputFile.getNonexistentSibling());
+
+        headerFile = baseFile.withFileExtension (".h");
+        cppFile = baseFile.withFileExtension (".cpp");
+    }
+
+    return true;
+}
+
+String UnityBuilder::createHeaderText (const File& sourceDirectory, const Array<File>& headers) const
+{
+    String headerOutput (preInclusionString);
+
+    for (int i = 0; i < headers.size(); ++i)
+        headerOutput << "#include \"" << headers.getReference (i).getRelativePathFrom (sourceDirectory) << "\"" << newLine;
+
+    headerOutput << postInclusionString;
+
+    return headerOutput;
+}
+
+String UnityBuilder::createSourceText (const File& sourceDirectory, const Array<File>& sources, const File& headerFile) const
+{
+    String sourceOutput (preInclusionString);
+    sourceOutput << "#include \"" << headerFile.getFileName() << "\"" << newLine << newLine;
+
+    for (int i = 0; i < sources.size(); ++i)
+        sourceOutput << "#include \"" << sources.getReference (i).getRelativePathFrom (sourceDirectory) << "\"" << newLine;
+
+    sourceOutput << postInclusionString;
+
+    return sourceOutput;
+}
+
+void UnityBuilder::writeManifest (const File& headerFile, const Array<File>& headers,
+                                  const File& cppFile, const Array<File>& sources) const
+{
+    using namespace UnityBuilderHelpers;
+
+    ValueTree manifestTree (ManifestIds::manifest);
+    DependencyScanner scanner;
+    SortedSet<String> inputPaths;
+
+    const File* unityFiles[] = { &headerFile, &cppFile };
+    const Array<File>* unitySources[] = { &headers, &sources };
+
+    for (int u = 0; u < 2; ++u)
+    {
+        ValueTree unityTree (ManifestIds::unity);
+        unityTree.setProperty (ManifestIds::path, unityFiles[u]->getFullPathName(), nullptr);
+        unityTree.setProperty (ManifestIds::hash, hashFile (*unityFiles[u]), nullptr);
+
+        for (int i = 0; i < unitySources[u]->size(); ++i)
+        {
+            const File& source = unitySources[u]->getReference (i);
+            const StringArray dependencies (scanner.getDependencies (source));
+
+            ValueTree sourceTree (ManifestIds::source);
+            sourceTree.setProperty (ManifestIds::path, source.getFullPathName(), nullptr);
+            inputPaths.add (source.getFullPathName());
+
+            for (int d = 0; d < dependencies.size(); ++d)
+            {
+                ValueTree dependencyTree (ManifestIds::dependency);
+                dependencyTree.setProperty (ManifestIds::path, dependencies[d], nullptr);
+                sourceTree.addChild (dependencyTree, -1, nullptr);
+                inputPaths.add (dependencies[d]);
+            }
+
+            unityTree.addChild (sourceTree, -1, nullptr);
+        }
+
+        manifestTree.addChild (unityTree, -1, nullptr);
+    }
+
+    for (int i = 0; i < inputPaths.size(); ++i)
+    {
+        const File input (inputPaths.getReference (i));
+
+        ValueTree inputTree (ManifestIds::input);
+        inputTree.setProperty (ManifestIds::path, input.getFullPathName(), nullptr);
+        inputTree.setProperty (ManifestIds::size, input.getSize(), nullptr);
+        inputTree.setProperty (ManifestIds::modified, input.getLastModificationTime().toMilliseconds(), nullptr);
+        inputTree.setProperty (ManifestIds::hash, hashFile (input), nullptr);
+        manifestTree.addChild (inputTree, -1, nullptr);
+    }
+
+    writeValueTreeToFile (manifestTree, manifestFile);
+}
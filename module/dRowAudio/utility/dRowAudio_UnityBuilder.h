@@ -42,6 +42,11 @@
     speed up build times.
 
     If you need to set custom defines or pragmas use the setPreAndPostString method.
+
+    For repeated builds use setIncremental so the unity files are only rewritten
+    when their contents change, and setDependencyManifestFile to record the
+    headers each source depends on. getUnityFilesNeedingRebuild can then tell you
+    which unity files are out of date without regenerating anything.
 */
 class UnityBuilder
 {
@@ -94,11 +99,51 @@ public:
     void setPreAndPostString (const String& preInclusionString,
                               const String& postInclusionString);
 
+    //==============================================================================
+    /** Enables incremental mode.
+
+        When this is on the output files always use the destination name rather
+        than creating new numbered files, and they are only written if their
+        contents would change. This means unchanged unity files keep their
+        timestamps and won't trigger a rebuild.
+    */
+    void setIncremental (bool shouldOnlyWriteChangedFiles);
+
+    /** Sets a file to write a dependency manifest to.
+
+        Each time processDirectory is called this will record every source in the
+        unity files, the local headers each one includes and the size, modification
+        time and hash of all of them. Set this to File() to stop writing a manifest.
+    */
+    void setDependencyManifestFile (const File& manifestFile);
+
+    /** Returns the unity files that would need rebuilding for a source directory.
+
+        A file is returned if it doesn't exist, if the set of sources it would
+        include has changed, or if any source or header recorded in the dependency
+        manifest has changed since the manifest was written. Inputs are only
+        re-hashed if their size or modification time differ so this is quick even
+        for large trees. If there is no manifest all the unity files are returned.
+
+        This always uses the same output names as incremental mode.
+    */
+    Array<File> getUnityFilesNeedingRebuild (const File& sourceDirectory);
+
 private:
     //==============================================================================
     String preInclusionString, postInclusionString;
     Array<File> filesToIgnore;
-    File destinationFile;
+    File destinationFile, manifestFile;
+    bool incremental;
+
+    //==============================================================================
+    bool shouldIgnore (const File& file, const Array<File>& generatedFiles) const;
+    void findSourceFiles (const File& sourceDirectory, Array<File>& headers, Array<File>& sources) const;
+    bool getOutputFiles (const File& sourceDirectory, File& headerFile, File& cppFile, bool useExistingNames) const;
+    String createHeaderText (const File& sourceDirectory, const Array<File>& headers) const;
+    String createSourceText (const File& sourceDirectory, const Array<File>& sources, const File& headerFile) const;
+    void writeManifest (const File& headerFile, const Array<File>& headers,
+                        const File& cppFile, const Array<File>& sources) const;
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (UnityBuilder)
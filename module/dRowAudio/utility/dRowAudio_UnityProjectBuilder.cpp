@@ -45,11 +45,156 @@ namespace Ids
     static const Identifier targetFolderProp    = "targetFolder";
 }
 
+//==============================================================================
+namespace UnityProjectBuilderHelpers
+{
+    /** Estimates the cost of compiling a file as its size plus the size of every
+        local header it pulls in. Each file is only read once so shared headers
+        don't get re-parsed for every source file.
+    */
+    class IncludeScanner
+    {
+    public:
+        IncludeScanner() {}
+
+        int64 getTotalNumBytes (const File& file)
+        {
+            SortedSet<String> visited;
+            return addNumBytes (file, visited);
+        }
+
+    private:
+        struct FileInfo
+        {
+            int64 numBytes;
+            StringArray includes;
+        };
+
+        OwnedArray<FileInfo> infos;
+        HashMap<String, int> infoIndexes;
+
+        const FileInfo& getInfo (const File& file)
+        {
+            const String path (file.getFullPathName());
+
+            if (infoIndexes.contains (path))
+                return *infos.getUnchecked (infoIndexes[path]);
+
+            FileInfo* info = new FileInfo();
+            info->numBytes = file.getSize();
+
+            StringArray lines;
+            file.readLines (lines);
+
+            for (int i = 0; i < lines.size(); ++i)
+            {
+                const String line (lines[i].trimStart());
+
+                if (line.startsWithChar ('#') && line.substring (1).trimStart().startsWith ("include"))
+                {
+                    const String name (line.fromFirstOccurrenceOf ("\"", false, false)
+                                           .upToFirstOccurrenceOf ("\"", false, false));
+
+                    if (name.isNotEmpty())
+                    {
+                        const File header (file.getSiblingFile (name));
+
+                        if (header.existsAsFile())
+                            info->includes.add (header.getFullPathName());
+                    }
+                }
+            }
+
+            infoIndexes.set (path, infos.size());
+            infos.add (info);
+
+            return *info;
+        }
+
+        int64 addNumBytes (const File& file, SortedSet<String>& visited)
+        {
+            const String path (file.getFullPathName());
+
+            if (visited.contains (path))
+                return 0;
+
+            visited.add (path);
+
+            const FileInfo& info = getInfo (file);
+            int64 total = info.numBytes;
+
+            for (int i = 0; i < info.includes.size(); ++i)
+                total += addNumBytes (File (info.includes[i]), visited);
+
+            return total;
+        }
+
+        JUCE_DECLARE_NON_COPYABLE (IncludeScanner)
+    };
+
+    static String normalisePath (const String& path)
+    {
+        return path.trim().replaceCharacter ('\\', '/');
+    }
+
+    /** Reads lines of "<seconds> <relative path>" into a map. */
+    static void readCompileTimes (const File& file, HashMap<String, double>& times)
+    {
+        StringArray lines;
+        file.readLines (lines);
+
+        for (int i = 0; i < lines.size(); ++i)
+        {
+            const String line (lines[i].trim());
+            const String secondsString (line.initialSectionNotContaining (" \t"));
+            const String path (normalisePath (line.substring (secondsString.length())));
+
+            if (secondsString.isNotEmpty() && path.isNotEmpty())
+                times.set (path, secondsString.getDoubleValue());
+        }
+    }
+
+    /** Adds each file, heaviest first, to the currently lightest partition. */
+    static void packLongestFirst (Array<int> fileIndices, const Array<double>& costs,
+                                  Array<Array<int> >& partitions, Array<double>& totals)
+    {
+        // ties are broken by index so the packing only depends on the costs
+        std::stable_sort (fileIndices.begin(), fileIndices.end(),
+                          [&costs] (int a, int b) { return costs.getUnchecked (a) > costs.getUnchecked (b); });
+
+        for (int i = 0; i < fileIndices.size(); ++i)
+        {
+            int lightest = 0;
+
+            for (int p = 1; p < totals.size(); ++p)
+                if (totals.getUnchecked (p) < totals.getUnchecked (lightest))
+                    lightest = p;
+
+            partitions.getReference (lightest).add (fileIndices.getUnchecked (i));
+            totals.getReference (lightest) += costs.getUnchecked (fileIndices.getUnchecked (i));
+        }
+    }
+
+    static double getLargest (const Array<double>& totals)
+    {
+        double largest = 0.0;
+
+        for (int i = 0; i < totals.size(); ++i)
+            largest = jmax (largest, totals.getUnchecked (i));
+
+        return largest;
+    }
+
+    /** How much heavier than a fresh packing the previous assignment can get before it is rebalanced. */
+    static const double rebalanceTolerance = 1.25;
+}
+
 //==============================================================================
 UnityProjectBuilder::UnityProjectBuilder (const File& sourceProject)
     : projectFile (sourceProject),
       numFiles (1),
       shouldLog (false),
+      incremental (false),
       unityName ("UnityBuild")
 {
 }
@@ -123,6 +268,16 @@ void UnityProjectBuilder::setNumFilesToSplitBetween (int numFiles_)
     numFiles = numFiles_;
 }
 
+void UnityProjectBuilder::setCompileTimesFile (const File& compileTimesFile_)
+{
+    compileTimesFile = compileTimesFile_;
+}
+
+void UnityProjectBuilder::setIncremental (bool shouldOnlyWriteChangedFiles)
+{
+    incremental = shouldOnlyWriteChangedFiles;
+}
+
 void UnityProjectBuilder::setLogOutput (bool shouldOutput)
 {
     shouldLog = shouldOutput;
@@ -167,35 +322,101 @@ Array<File> UnityProjectBuilder::buildUnityCpp (const File& destDir)
     if (filesToAdd.size() == 0)
         return files;
 
-    const int filesPerUnityFile = (int) std::ceil (filesToAdd.size() / (float) numFiles);
+    const int numPartitions = jlimit (1, filesToAdd.size(), numFiles);
+    const Array<double> costs (estimateCompileCosts (destDir));
+    const Array<Array<int> > partitions (partitionByCost (costs, numPartitions,
+                                                          findPreviousPartitions (destDir, numPartitions)));
 
-    for (int i = 0; i < numFiles; ++i)
+    for (int i = 0; i < partitions.size(); ++i)
     {
-        const int start = i * filesPerUnityFile;
-        const int end = jmin (filesToAdd.size(), start + filesPerUnityFile);
+        const Array<int>& fileIndices = partitions.getReference (i);
+        double totalCost = 0.0;
 
-        files.add (buildUnityCpp (destDir, i, Range<int> (start, end)));
+        for (int f = 0; f < fileIndices.size(); ++f)
+            totalCost += costs.getUnchecked (fileIndices.getUnchecked (f));
+
+        logOutput ("Unity file " + String (i) + ": " + String (fileIndices.size())
+                    + " files, estimated cost " + String (totalCost, 2));
+
+        files.add (buildUnityCpp (destDir, i, fileIndices));
     }
 
     return files;
 }
 
-File UnityProjectBuilder::buildUnityCpp (const File& destDir, int unityNum, const Range<int> fileRange)
+File UnityProjectBuilder::buildUnityCpp (const File& destDir, int unityNum, const Array<int>& fileIndices)
 {
     const File cppFile (destDir.getChildFile (unityName + String (unityNum)).withFileExtension (".cpp"));
+
+    MemoryOutputStream content;
+
+    for (int i = 0; i < fileIndices.size(); ++i)
+        content << "#include \"" << filesToAdd[fileIndices.getUnchecked (i)] << "\"" << newLine;
+
+    if (incremental && cppFile.existsAsFile()
+         && cppFile.loadFileAsString() == content.toString())
+    {
+        logOutput ("Unity cpp file \"" + cppFile.getFullPathName() + "\" unchanged, skipping...");
+        return cppFile;
+    }
+
     logOutput ("Building Unity cpp file \"" + cppFile.getFullPathName() + "\"...");
 
     if (cppFile.existsAsFile())
         cppFile.deleteFile();
 
     FileOutputStream s (cppFile);
-
-    for (int i = fileRange.getStart(); i < fileRange.getEnd(); ++i)
-        s << "#include \"" << filesToAdd[i] << "\"" << newLine;
+    s << content.toString();
 
     return cppFile;
 }
 
+Array<double> UnityProjectBuilder::estimateCompileCosts (const File& sourceDir)
+{
+    using namespace UnityProjectBuilderHelpers;
+
+    HashMap<String, double> recordedTimes;
+
+    if (compileTimesFile.existsAsFile())
+    {
+        logOutput ("Reading compile times from \"" + compileTimesFile.getFullPathName() + "\"...");
+        readCompileTimes (compileTimesFile, recordedTimes);
+    }
+
+    // estimate everything by size, then find a seconds-per-byte scale from any
+    // files with recorded times so the two kinds of cost can be mixed
+    IncludeScanner scanner;
+    Array<double> estimates, costs;
+    double recordedSeconds = 0.0, recordedBytes = 0.0;
+
+    for (int i = 0; i < filesToAdd.size(); ++i)
+    {
+        const double numBytes = (double) scanner.getTotalNumBytes (sourceDir.getChildFile (filesToAdd[i]));
+        const String path (normalisePath (filesToAdd[i]));
+
+        estimates.add (numBytes);
+
+        if (recordedTimes.contains (path))
+        {
+            recordedSeconds += recordedTimes[path];
+            recordedBytes += numBytes;
+        }
+    }
+
+    const double secondsPerByte = (recordedSeconds > 0.0 && recordedBytes > 0.0)
+                                    ? recordedSeconds / recordedBytes : 1.0;
+
+    for (int i = 0; i < filesToAdd.size(); ++i)
+    {
+        const String path (normalisePath (filesToAdd[i]));
+
+        costs.add (recordedTimes.contains (path) ? recordedTimes[path]
+                                                 : estimates.getUnchecked (i) * secondsPerByte);
+    }
+
+    return costs;
+}
+
 void UnityProjectBuilder::updateBuildDirectories()
 {
     if (buildDir.isEmpty())
@@ -295,3 +516,88 @@ String UnityProjectBuilder::createAlphaNumericUID()
 
     return uid;
 }
+
+Array<int> UnityProjectBuilder::findPreviousPartitions (const File& destDir, int numPartitions) const
+{
+    Array<int> previous;
+    previous.insertMultiple (0, -1, filesToAdd.size());
+
+    if (! incremental)
+        return previous;
+
+    // the existing unity files record where each file went last time
+    for (int p = 0; p < numPartitions; ++p)
+    {
+        const File cppFile (destDir.getChildFile (unityName + String (p)).withFileExtension (".cpp"));
+
+        if (! cppFile.existsAsFile())
+            continue;
+
+        StringArray lines;
+        cppFile.readLines (lines);
+
+        for (int i = 0; i < lines.size(); ++i)
+        {
+            const String line (lines[i].trim());
+
+            if (line.startsWith ("#include \""))
+            {
+                const int index = filesToAdd.indexOf (line.fromFirstOccurrenceOf ("\"", false, false)
+                                                          .upToLastOccurrenceOf ("\"", false, false));
+
+                if (index >= 0)
+                    previous.set (index, p);
+            }
+        }
+    }
+
+    return previous;
+}
+
+Array<Array<int> > UnityProjectBuilder::partitionByCost (const Array<double>& costs, int numPartitions,
+                                                         const Array<int>& previousPartitions)
+{
+    using namespace UnityProjectBuilderHelpers;
+
+    // files stay where they were last time and only new ones are packed around
+    // them, as costs shift with every edit and repacking from scratch would move
+    // files between the unity files and rebuild most of them
+    Array<Array<int> > packed, kept;
+    Array<double> packedTotals, keptTotals;
+    packed.insertMultiple (0, Array<int>(), numPartitions);
+    kept.insertMultiple (0, Array<int>(), numPartitions);
+    packedTotals.insertMultiple (0, 0.0, numPartitions);
+    keptTotals.insertMultiple (0, 0.0, numPartitions);
+
+    Array<int> allFiles, newFiles;
+
+    for (int i = 0; i < costs.size(); ++i)
+    {
+        const int p = previousPartitions[i];
+        allFiles.add (i);
+
+        if (isPositiveAndBelow (p, numPartitions))
+        {
+            kept.getReference (p).add (i);
+            keptTotals.getReference (p) += costs.getUnchecked (i);
+        }
+        else
+        {
+            newFiles.add (i);
+        }
+    }
+
+    packLongestFirst (allFiles, costs, packed, packedTotals);
+    packLongestFirst (newFiles, costs, kept, keptTotals);
+
+    // but once the edits have unbalanced them too far start again
+    const bool keepPrevious = newFiles.size() < costs.size()
+                               && getLargest (keptTotals) <= getLargest (packedTotals) * rebalanceTolerance;
+    Array<Array<int> >& partitions = keepPrevious ? kept : packed;
+
+    // keep the project's include order within each file
+    for (int p = 0; p < numPartitions; ++p)
+        partitions.getReference (p).sort();
+
+    return partitions;
+}
@@ -40,7 +40,10 @@
     building large projects over VM's where mapping files across the virtual
     memory space takes a long time.
 
-    If memory is a problem you can split the build between several files.
+    If memory is a problem you can split the build between several files. When
+    splitting, files are distributed between the unity files by their estimated
+    compile cost rather than by their order in the project so that each one takes
+    roughly the same time to build.
 
     To use it just create one of these with an existing Introjcuer project and
     call the run() method. It will create a unity cpp file in the project's source
@@ -66,6 +69,26 @@ public:
     */
     void setNumFilesToSplitBetween (int numFiles);
 
+    /** Sets a file of measured compile times used to balance the unity files.
+
+        Each line should contain a time in seconds followed by the path of the
+        source file relative to the project's Source directory, e.g.
+        "12.5 Audio/Engine.cpp". Files without a recorded time are estimated from
+        their size plus the size of every local header they include, scaled to
+        match the recorded times. If no file is set only the estimate is used.
+    */
+    void setCompileTimesFile (const File& compileTimesFile);
+
+    /** Enables incremental mode.
+
+        When this is on the unity files are only rewritten if their contents would
+        change so unchanged ones keep their timestamps and won't be rebuilt. Files
+        also stay in the unity file they were in last time, with only new ones
+        being distributed, until the costs drift more than 25% out of balance.
+        By default this is off and all the unity files are rewritten.
+    */
+    void setIncremental (bool shouldOnlyWriteChangedFiles);
+
     /** Sets whether the progress should be written to std::out or not.
 
         By default this is off but is useful in command line apps.
@@ -94,18 +117,20 @@ public:
 
 private:
     //==============================================================================
-    File projectFile, unityProjectFile;
+    File projectFile, unityProjectFile, compileTimesFile;
     ValueTree project;
     StringArray filesToAdd;
     int numFiles;
-    bool shouldLog;
+    bool shouldLog, incremental;
     String unityName, buildDir;
 
     //==============================================================================
     void recurseGroup (ValueTree group, const File& sourceDir);
     void parseFile (ValueTree file, const File& sourceDir);
     Array<File> buildUnityCpp (const File& destDir);
-    File buildUnityCpp (const File& destDir, int unityNum, const Range<int> fileRange);
+    File buildUnityCpp (const File& destDir, int unityNum, const Array<int>& fileIndices);
+    Array<double> estimateCompileCosts (const File& sourceDir);
+    Array<int> findPreviousPartitions (const File& destDir, int numPartitions) const;
     void updateBuildDirectories();
     void logOutput (const String& output);
 
@@ -114,6 +139,8 @@ private:
     static bool isValidSourceFile (const File& file);
     static File getExeFromApp (const File& app);
     static String createAlphaNumericUID();
+    static Array<Array<int> > partitionByCost (const Array<double>& costs, int numPartitions,
+                                               const Array<int>& previousPartitions);
 
     //==============================================================================
     JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (UnityProjectBuilder)
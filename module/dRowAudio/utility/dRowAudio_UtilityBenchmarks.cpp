@@ -0,0 +1,138 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#if DROWAUDIO_BENCHMARKS
+
+//==============================================================================
+namespace UtilityBenchmarkHelpers
+{
+    /** Creates a rekordbox style library document of at least the given size. */
+    inline String createSyntheticLibrary (size_t minNumBytes, int& numTracks)
+    {
+        MemoryOutputStream xml;
+        xml << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<DJ_PLAYLISTS Version=\"1.0.0\">\n<COLLECTION>\n";
+
+        numTracks = 0;
+
+        while (xml.getDataSize() < minNumBytes)
+        {
+            const String trackNum (numTracks);
+            const String artist ("Artist " + String (numTracks % 997));
+
+            xml << "<TRACK TrackID=\"" << trackNum << "\" Name=\"Track " << trackNum
+                << "\" Artist=\"" << artist << "\" Genre=\"Genre " << String (numTracks % 31)
+                << "\" Kind=\"MP3 File\" TotalTime=\"" << String (180 + numTracks % 240)
+                << "\" Location=\"file://localhost/Music/" << artist << "/Track " << trackNum << ".mp3\">\n"
+                << "  <TEMPO Inizio=\"0.025\" Bpm=\"" << String (90.0 + (numTracks % 80), 2) << "\" Metro=\"4/4\" Battito=\"1\"/>\n"
+                << "  <NAME>Track " << trackNum << "</NAME>\n"
+                << "</TRACK>\n";
+
+            ++numTracks;
+        }
+
+        xml << "</COLLECTION>\n</DJ_PLAYLISTS>\n";
+
+        return xml.toString();
+    }
+}
+
+//==============================================================================
+class XmlIndexBenchmark  : public PerformanceBenchmark
+{
+public:
+    XmlIndexBenchmark() : PerformanceBenchmark ("XmlIndex", "utility") {}
+
+    enum { documentSizeBytes = 100 * 1024 * 1024, numQueries = 1000 };
+
+    void runBenchmark() override
+    {
+        int numTracks = 0;
+        std::unique_ptr<XmlElement> library (XmlDocument::parse (UtilityBenchmarkHelpers::createSyntheticLibrary (documentSizeBytes, numTracks)));
+
+        if (library == nullptr)
+            return;
+
+        XmlIndex index;
+
+        measure ("build index", numTracks, 0.0, [&]
+        {
+            index.build (library.get());
+        });
+
+        logValue ("build index", "numElements", index.getNumElements());
+        logValue ("build index", "documentMegabytes", documentSizeBytes / (1024.0 * 1024.0));
+
+        // the linear searches are O(document) so only look for one track near the end
+        const String lastTrackId (numTracks - 1);
+        const String lastTrackName ("Track " + lastTrackId);
+
+        measure ("linear attribute lookup", 1, 0.0, [&]
+        {
+            XmlHelpers::findXmlElementWithAttributeWithValue (library.get(), "TrackID", lastTrackId);
+        });
+
+        measure ("linear subtext lookup", 1, 0.0, [&]
+        {
+            XmlHelpers::findXmlElementWithSubText (library.get(), lastTrackName);
+        });
+
+        Random random (0x1234);
+        StringArray trackIds, trackNames;
+
+        for (int i = 0; i < numQueries; ++i)
+        {
+            const String trackNum (random.nextInt (numTracks));
+            trackIds.add (trackNum);
+            trackNames.add ("Track " + trackNum);
+        }
+
+        measure ("indexed attribute lookup", numQueries, 0.0, [&]
+        {
+            for (int i = 0; i < numQueries; ++i)
+                index.findElementWithAttributeWithValue ("TrackID", trackIds[i]);
+        });
+
+        measure ("indexed subtext lookup", numQueries, 0.0, [&]
+        {
+            for (int i = 0; i < numQueries; ++i)
+                index.findElementWithSubText (trackNames[i]);
+        });
+
+        measure ("indexed tag lookup", 1, 0.0, [&]
+        {
+            index.getElementsWithTagName ("TRACK");
+        });
+    }
+};
+
+static XmlIndexBenchmark xmlIndexBenchmark;
+
+#endif // DROWAUDIO_BENCHMARKS
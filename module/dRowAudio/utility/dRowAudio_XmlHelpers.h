@@ -46,6 +46,9 @@ namespace XmlHelpers
     //==============================================================================
     /** Searches an XmlElement for an element with a given attribute name with
         the given attribute value.
+
+        This walks the whole tree so for repeated searches of large documents
+        use an XmlIndex instead.
     */
     static inline XmlElement* findXmlElementWithAttributeWithValue (XmlElement* element,
                                                                     const String& attributeName,
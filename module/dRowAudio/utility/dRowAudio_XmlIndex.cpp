@@ -0,0 +1,240 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+//==============================================================================
+namespace XmlIndexHelpers
+{
+    // an odd multiplier for the polynomial subtext hash
+    static const uint64 textHashBase = 1099511628211ULL;
+
+    static const Array<XmlElement*> emptyList;
+}
+
+//==============================================================================
+XmlIndex::XmlIndex()
+{
+}
+
+XmlIndex::XmlIndex (XmlElement* rootElement)
+{
+    build (rootElement);
+}
+
+XmlIndex::~XmlIndex()
+{
+}
+
+//==============================================================================
+void XmlIndex::build (XmlElement* rootElement)
+{
+    DROWAUDIO_TRACE_SCOPE ("XmlIndex::build")
+
+    clear();
+
+    if (rootElement == nullptr)
+        return;
+
+    // the subtext of an element is only known once its children have been
+    // visited so the keys are collected first and then added in document order
+    Array<int64> subTextKeys;
+    indexElement (rootElement, subTextKeys);
+
+    for (int i = 0; i < elements.size(); ++i)
+    {
+        const int64 key = subTextKeys.getUnchecked (i);
+
+        if (! subTextLists.contains (key))
+        {
+            subTextLists.set (key, lists.size());
+            lists.add (new Array<XmlElement*>());
+        }
+
+        lists.getUnchecked (subTextLists[key])->add (elements.getUnchecked (i));
+    }
+}
+
+void XmlIndex::clear()
+{
+    elements.clear();
+    lists.clear();
+    tagNameLists.clear();
+    attributeLists.clear();
+    attributeValueLists.clear();
+    subTextLists.clear();
+}
+
+//==============================================================================
+const Array<XmlElement*>& XmlIndex::getElementsWithTagName (const String& tagName) const
+{
+    return getList (tagNameLists, tagName);
+}
+
+const Array<XmlElement*>& XmlIndex::getElementsWithAttribute (const String& attributeName) const
+{
+    return getList (attributeLists, attributeName);
+}
+
+const Array<XmlElement*>& XmlIndex::getElementsWithAttributeValue (const String& attributeName,
+                                                                   const String& attributeValue) const
+{
+    return getList (attributeValueLists, getAttributeValueKey (attributeName, attributeValue));
+}
+
+Array<XmlElement*> XmlIndex::getElementsWithSubText (const String& subtext) const
+{
+    Array<XmlElement*> found;
+    const int64 key = getSubTextKey (hashText (subtext));
+
+    if (subTextLists.contains (key))
+    {
+        const Array<XmlElement*>& candidates = *lists.getUnchecked (subTextLists[key]);
+
+        for (int i = 0; i < candidates.size(); ++i)
+            if (candidates.getUnchecked (i)->getAllSubText() == subtext)
+                found.add (candidates.getUnchecked (i));
+    }
+
+    return found;
+}
+
+//==============================================================================
+XmlElement* XmlIndex::findElementWithAttributeWithValue (const String& attributeName, const String& attributeValue) const
+{
+    return getElementsWithAttributeValue (attributeName, attributeValue).getFirst();
+}
+
+XmlElement* XmlIndex::findElementWithAttribute (const String& attributeName) const
+{
+    return getElementsWithAttribute (attributeName).getFirst();
+}
+
+XmlElement* XmlIndex::findElementWithSubText (const String& subtext) const
+{
+    const int64 key = getSubTextKey (hashText (subtext));
+
+    if (subTextLists.contains (key))
+    {
+        const Array<XmlElement*>& candidates = *lists.getUnchecked (subTextLists[key]);
+
+        for (int i = 0; i < candidates.size(); ++i)
+            if (candidates.getUnchecked (i)->getAllSubText() == subtext)
+                return candidates.getUnchecked (i);
+    }
+
+    return nullptr;
+}
+
+//==============================================================================
+XmlIndex::TextHash XmlIndex::indexElement (XmlElement* element, Array<int64>& subTextKeys)
+{
+    if (element->isTextElement())
+        return hashText (element->getText());
+
+    const int elementIndex = elements.size();
+    elements.add (element);
+    subTextKeys.add (0);
+
+    addToList (tagNameLists, element->getTagName(), element);
+
+    const int numAttributes = element->getNumAttributes();
+
+    for (int i = 0; i < numAttributes; ++i)
+    {
+        const String& attributeName = element->getAttributeName (i);
+
+        addToList (attributeLists, attributeName, element);
+        addToList (attributeValueLists, getAttributeValueKey (attributeName, element->getAttributeValue (i)), element);
+    }
+
+    // combine the children's hashes as if their text had been concatenated
+    TextHash subText = { 0, 1, 0 };
+    XmlElement* child = element->getFirstChildElement();
+
+    while (child != nullptr)
+    {
+        const TextHash childText (indexElement (child, subTextKeys));
+
+        subText.hash = subText.hash * childText.power + childText.hash;
+        subText.power *= childText.power;
+        subText.length += childText.length;
+
+        child = child->getNextElement();
+    }
+
+    subTextKeys.set (elementIndex, getSubTextKey (subText));
+
+    return subText;
+}
+
+void XmlIndex::addToList (HashMap<String, int>& map, const String& key, XmlElement* element)
+{
+    if (! map.contains (key))
+    {
+        map.set (key, lists.size());
+        lists.add (new Array<XmlElement*>());
+    }
+
+    lists.getUnchecked (map[key])->add (element);
+}
+
+const Array<XmlElement*>& XmlIndex::getList (const HashMap<String, int>& map, const String& key) const
+{
+    if (map.contains (key))
+        return *lists.getUnchecked (map[key]);
+
+    return XmlIndexHelpers::emptyList;
+}
+
+//==============================================================================
+XmlIndex::TextHash XmlIndex::hashText (const String& text) noexcept
+{
+    TextHash textHash = { 0, 1, 0 };
+
+    for (String::CharPointerType t (text.getCharPointer()); ! t.isEmpty();)
+    {
+        textHash.hash = textHash.hash * XmlIndexHelpers::textHashBase + (uint64) t.getAndAdvance();
+        textHash.power *= XmlIndexHelpers::textHashBase;
+        ++textHash.length;
+    }
+
+    return textHash;
+}
+
+int64 XmlIndex::getSubTextKey (const TextHash& textHash) noexcept
+{
+    return (int64) (textHash.hash ^ ((uint64) textHash.length * 0x9e3779b97f4a7c15ULL));
+}
+
+String XmlIndex::getAttributeValueKey (const String& attributeName, const String& attributeValue)
+{
+    // '=' can't appear in an attribute name so the key is unambiguous
+    return attributeName + "=" + attributeValue.toLowerCase();
+}
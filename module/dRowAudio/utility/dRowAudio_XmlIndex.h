@@ -0,0 +1,140 @@
+/*
+  ==============================================================================
+
+  This file is part of the dRowAudio JUCE module
+  Copyright 2004-13 by dRowAudio.
+
+  ------------------------------------------------------------------------------
+
+  dRowAudio is provided under the terms of The MIT License (MIT):
+
+  Permission is hereby granted, free of charge, to any person obtaining a copy
+  of this software and associated documentation files (the "Software"), to deal
+  in the Software without restriction, including without limitation the rights
+  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+  copies of the Software, and to permit persons to whom the Software is
+  furnished to do so, subject to the following conditions:
+
+  The above copyright notice and this permission notice shall be included in all
+  copies or substantial portions of the Software.
+
+  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+  SOFTWARE.
+
+  ==============================================================================
+*/
+
+#ifndef DROWAUDIO_XMLINDEX_H
+#define DROWAUDIO_XMLINDEX_H
+
+//==============================================================================
+/**
+    An index of an XmlElement tree for fast repeated searches.
+
+    The XmlHelpers find functions walk the whole tree for every call which is
+    slow for large documents such as iTunes or rekordbox library exports. This
+    walks the tree once and builds hash tables of elements by tag name, by
+    attribute name, by attribute name and value and by subtext. Each query is
+    then just a lookup.
+
+    Elements are listed in document order so the first element of a result is
+    the one a depth-first search would find first. Text elements themselves
+    aren't indexed, their parent elements are.
+
+    The index holds raw pointers to the elements so the document must outlive it
+    and if the document is modified you should call build() again.
+
+    @code
+        std::unique_ptr<XmlElement> library (XmlDocument::parse (libraryFile));
+        XmlIndex index (library.get());
+
+        for (int i = 0; i < trackIds.size(); ++i)
+            if (XmlElement* track = index.findElementWithAttributeWithValue ("TrackID", trackIds[i]))
+                addTrack (*track);
+    @endcode
+*/
+class XmlIndex
+{
+public:
+    //==============================================================================
+    /** Creates an empty index. */
+    XmlIndex();
+
+    /** Creates an index of a given element and all its children. */
+    explicit XmlIndex (XmlElement* rootElement);
+
+    /** Destructor. */
+    ~XmlIndex();
+
+    //==============================================================================
+    /** Clears the index and rebuilds it from a new element. */
+    void build (XmlElement* rootElement);
+
+    /** Clears the index. */
+    void clear();
+
+    /** Returns the number of elements that have been indexed. */
+    int getNumElements() const noexcept                 { return elements.size(); }
+
+    //==============================================================================
+    /** Returns all the elements with a given tag name. */
+    const Array<XmlElement*>& getElementsWithTagName (const String& tagName) const;
+
+    /** Returns all the elements that have a given attribute. */
+    const Array<XmlElement*>& getElementsWithAttribute (const String& attributeName) const;
+
+    /** Returns all the elements with a given attribute set to a given value.
+        Like XmlHelpers::findXmlElementWithAttributeWithValue the value is compared
+        ignoring case.
+    */
+    const Array<XmlElement*>& getElementsWithAttributeValue (const String& attributeName,
+                                                             const String& attributeValue) const;
+
+    /** Returns all the elements whose getAllSubText() is exactly the given text.
+
+        Subtext is indexed by a hash of its contents so the candidates for a hash
+        are compared against the text before being returned.
+    */
+    Array<XmlElement*> getElementsWithSubText (const String& subtext) const;
+
+    //==============================================================================
+    /** Returns the first element with a given attribute set to a given value, or nullptr. */
+    XmlElement* findElementWithAttributeWithValue (const String& attributeName, const String& attributeValue) const;
+
+    /** Returns the first element with a given attribute, or nullptr. */
+    XmlElement* findElementWithAttribute (const String& attributeName) const;
+
+    /** Returns the first element whose subtext is exactly the given text, or nullptr. */
+    XmlElement* findElementWithSubText (const String& subtext) const;
+
+private:
+    //==============================================================================
+    struct TextHash
+    {
+        uint64 hash, power;
+        int64 length;
+    };
+
+    Array<XmlElement*> elements;
+    OwnedArray<Array<XmlElement*> > lists;
+    HashMap<String, int> tagNameLists, attributeLists, attributeValueLists;
+    HashMap<int64, int> subTextLists;
+
+    TextHash indexElement (XmlElement* element, Array<int64>& subTextKeys);
+    void addToList (HashMap<String, int>& map, const String& key, XmlElement* element);
+    const Array<XmlElement*>& getList (const HashMap<String, int>& map, const String& key) const;
+
+    static TextHash hashText (const String& text) noexcept;
+    static int64 getSubTextKey (const TextHash& textHash) noexcept;
+    static String getAttributeValueKey (const String& attributeName, const String& attributeValue);
+
+    //==============================================================================
+    JUCE_DECLARE_NON_COPYABLE_WITH_LEAK_DETECTOR (XmlIndex)
+};
+
+#endif //DROWAUDIO_XMLINDEX_H